@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "gameobject.hpp"
+
+// Boxes stored as separate left/right/top/bottom arrays (SoA) so one query box can be
+// tested against several at a time. The arrays are padded to a multiple of BLOCK with
+// boxes that overlap nothing, so the wide kernels never need a scalar tail.
+class AABBBatch {
+
+	public:
+		static const size_t BLOCK = 8; // Widest kernel (AVX) tests 8 boxes per instruction
+
+		void clear();
+		void reserve(size_t count);
+		int push(const AABB& box);
+		void set(int index, const AABB& box);
+		void pop(); // Drops the last box
+		AABB get(int index) const { return {left_[index], right_[index], top_[index], bottom_[index]}; }
+
+		size_t size() const { return count_; }
+		size_t paddedSize() const { return (count_ + BLOCK - 1) / BLOCK * BLOCK; } // Storage can run past this after clear()
+		const float* left() const { return left_.data(); }
+		const float* right() const { return right_.data(); }
+		const float* top() const { return top_.data(); }
+		const float* bottom() const { return bottom_.data(); }
+
+	private:
+		std::vector<float> left_, right_, top_, bottom_;
+		size_t count_ = 0;
+};
+
+// Instruction sets the batch kernels can use, picked at runtime from what the CPU reports
+enum class SimdLevel { SCALAR, SSE2, AVX };
+
+SimdLevel detectSimdLevel();
+SimdLevel getSimdLevel();
+// Overrides the detected level (for benchmarks), clamped to what the CPU supports
+void setSimdLevel(SimdLevel level);
+const char* simdLevelName(SimdLevel level);
+
+// Same test as checkCollision(box, batch[i]) for every entry. overlapMask sets bit i % 64
+// of mask[i / 64]; overlapIndices appends the overlapping indices in ascending order and
+// returns how many it appended.
+void overlapMask(const AABB& box, const AABBBatch& batch, std::vector<uint64_t>& mask);
+size_t overlapIndices(const AABB& box, const AABBBatch& batch, std::vector<int>& out);
@@ -0,0 +1,64 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+#include "aabbbatch.hpp"
+#include "gameobject.hpp"
+#include "globals.hpp"
+#include "spatialhash.hpp"
+
+const float SLEEP_DELAY = 1.0f;		 // Seconds an object must stay still before it sleeps
+const float SLEEP_VELOCITY = 0.01f;	 // Speed below which an object counts as still
+const float SLEEP_DISTANCE = 0.001f; // Per-frame movement below which an object counts as still
+const float WAKE_RADIUS = 4.0f;		 // Tiles around the player that keep objects awake
+
+// Tracks which entries of an object array are awake. Active indices are kept packed in
+// one array so per-frame loops only ever walk awake objects; sleeping objects are parked
+// in a hashed grid by their AABB so proximity and contact wakes don't scan them either.
+// The boxes of the active objects are kept in an AABBBatch next to the active array, so
+// the wake region and the player can be tested against all of them at once.
+class ActivitySet {
+
+	public:
+		// Sleep bookkeeping for active objects, then wakes sleepers overlapping wakeRegion
+		// or touched by an object that moved this frame. New objects start awake.
+		void update(const std::vector<GameObject>& objects, float deltaTime, const AABB& wakeRegion);
+
+		void wake(int index);
+		void wakeAll();
+		void wakeInRegion(const AABB& region);
+
+		const std::vector<int>& getActive() const { return active_; }
+		// Entry i is the box of getActive()[i] as of the last update
+		const AABBBatch& getActiveBoxes() const { return boxes_; }
+		bool isAwake(int index) const { return index < static_cast<int>(state_.size()) && !state_[index].asleep; }
+		int getActiveCount() const { return static_cast<int>(active_.size()); }
+		int getSleepingCount() const { return static_cast<int>(state_.size() - active_.size()); }
+
+	private:
+		struct ObjectActivity {
+				glm::vec2 lastPos = glm::vec2(0.0f);
+				uint32_t lastVersion = 0; // Transform version seen last update
+				float idleTime = 0.0f;
+				bool asleep = false;
+				int activeSlot = -1; // Index into active_ while awake
+				glm::ivec4 cells;	 // Grid cell range (x0, y0, x1, y1) it sleeps in
+				AABB box;			 // Box it fell asleep with, restored to boxes_ on waking
+		};
+
+		void resize(const std::vector<GameObject>& objects);
+		void sleep(int index, const AABB& box);
+
+		std::vector<ObjectActivity> state_;
+		std::vector<int> active_;
+		AABBBatch boxes_;			  // Parallel to active_
+		std::vector<uint64_t> near_; // Scratch, active slots overlapping the wake region
+		// Bucket entries carry the sleeper's box so wake queries scan them contiguously
+		struct Sleeper {
+				int index;
+				AABB box;
+		};
+		SpatialHash<Sleeper, 4096> sleepers_{2.0f * TILE_SIZE};
+		int sleeperCount_ = 0;
+		std::vector<int> woken_; // Scratch for wakeInRegion
+};
@@ -5,6 +5,7 @@
 class GameObject;
 class PlayerObject;
 class Tilemap;
+class GameEvents;
 
 class Behavior {
 		// Abstract base class for behaviours
@@ -14,7 +15,8 @@ class Behavior {
 		// Update the behaviour for a given game object -  must be implemented
 		virtual void update(GameObject& obj, float deltaTime) = 0;
 
-		virtual void onPlayerCollision(GameObject& obj, PlayerObject& player) {}
+		// Outcomes of the contact (the player dying, ...) are published to events
+		virtual void onPlayerCollision(GameObject& obj, PlayerObject& player, GameEvents& events) {}
 		virtual void onTileCollision(GameObject& obj, Tilemap& tilemap) {}
 		virtual void onObjectCollision(GameObject& obj, GameObject& other) {}
 };
@@ -30,9 +32,16 @@ class KillBehavior : public Behavior {
 	public:
 		void update(GameObject& obj, float deltaTime) override;
 
-		void onPlayerCollision(GameObject& obj, PlayerObject& player) override;
+		void onPlayerCollision(GameObject& obj, PlayerObject& player, GameEvents& events) override;
 };
 
+// Death wall motion, the one implementation behind DeathWallBehavior and the pooled walls in
+// BehaviorPools: speeds up by acceleration (capped at maxSpeed when that's positive) and
+// returns how far the wall moves along direction this step
+glm::vec2 stepDeathWall(float& velocity, float acceleration, float maxSpeed, const glm::vec2& direction, float deltaTime);
+// Puts a wall back at startPos, at rest
+void resetDeathWall(GameObject& obj, float& velocity, const glm::vec2& startPos);
+
 class DeathWallBehavior : public Behavior {
 		// Behaviour for advancing death wall that starts from beginning of level geometry
 		// to goal area - immediately kills player if they touch it
@@ -43,10 +52,15 @@ class DeathWallBehavior : public Behavior {
 
 		void update(GameObject& obj, float deltaTime) override;
 
-		void onPlayerCollision(GameObject& obj, PlayerObject& player) override;
+		void onPlayerCollision(GameObject& obj, PlayerObject& player, GameEvents& events) override;
 
 		void reset(GameObject& obj);
 
+		float getAcceleration() const { return acceleration_; }
+		float getMaxSpeed() const { return maxSpeed_; }
+		const glm::vec2& getStartPos() const { return startPos_; }
+		const glm::vec2& getDirection() const { return direction_; }
+
 	private:
 		float acceleration_;	 // Acceleration of the death wall
 		float velocity_ = 0.0f;	 // Current velocity of the death wall, increases based on acceleration
@@ -59,16 +73,22 @@ class DeathWallBehavior : public Behavior {
 };
 
 class MovingPlatformBehavior : public Behavior {
-		// When the player is on the top surface of the platform, the platform's velocity
-		// is added to the player's velocity
+		// Kinematic platform that travels from its starting position to start + direction
+		// and back at a constant speed. Bodies standing on the top surface are carried by
+		// PlatformSystem, which reads the platform's movement from the GameObject
 	public:
 		MovingPlatformBehavior(GameObject& obj, float speed, glm::vec2 direction);
 
 		void update(GameObject& obj, float deltaTime) override;
 
-		void onPlayerCollision(GameObject& obj, PlayerObject& player) override;
+		void onPlayerCollision(GameObject& obj, PlayerObject& player, GameEvents& events) override;
+
+		void reset(GameObject& obj);
 
 	private:
 		float speed_;
 		glm::vec2 direction_;
+		glm::vec2 startPos_;
+		float length_;			 // Length of direction_, cached
+		float progress_ = 0.0f; // 0 -> 1 on the way out, 1 -> 2 on the way back
 };
\ No newline at end of file
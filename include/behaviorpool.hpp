@@ -0,0 +1,66 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+#include "gameobject.hpp"
+#include "playerobject.hpp"
+#include "activity.hpp"
+#include "objectregistry.hpp"
+#include "events.hpp"
+
+// Behaviours the pools store by type. ADAPTER objects keep their Behavior and go through
+// its virtuals, which is how one-off behaviour types still work.
+enum class BehaviorKind : uint8_t { NONE, IDLE, KILL, DEATHWALL, ADAPTER };
+
+// Object behaviours grouped by concrete type. Each type's state sits in its own arrays and
+// is updated by one plain loop, so there's no per-object heap object or virtual call for
+// the common types; stateless ones (idle, kill) aren't looped over at all.
+class BehaviorPools {
+
+	public:
+		// Moves every recognised Behavior out of its object into the pools. The pools hold
+		// handles, so removing other objects through the registry doesn't break them. Objects
+		// added afterwards are treated as adapters until the next build (if objects are also
+		// removed, update() has to run in between). The registry must be synced first and
+		// outlive the pools.
+		void build(std::vector<GameObject>& objects, const ObjectRegistry& registry);
+
+		// Updates awake objects' behaviours
+		void update(std::vector<GameObject>& objects, const ActivitySet& activity, float deltaTime);
+		// Publishes what the contact caused; adapter behaviours publish for themselves
+		void onPlayerCollision(std::vector<GameObject>& objects, int index, PlayerObject& player, GameEvents& events);
+		// Puts every death wall back at its start, stopped
+		void resetDeathWalls(std::vector<GameObject>& objects);
+
+		BehaviorKind getKind(int index) const {
+			ObjectHandle handle = registry_ ? registry_->handleAt(index) : ObjectHandle();
+			if (handle.index < refs_.size() && refs_[handle.index].generation == handle.generation)
+				return refs_[handle.index].kind;
+			return BehaviorKind::ADAPTER;
+		}
+		int getPooledCount() const { return pooledCount_; }
+		int getAdapterCount() const { return static_cast<int>(adapters_.size()); }
+
+	private:
+		struct BehaviorRef {
+				BehaviorKind kind = BehaviorKind::NONE;
+				uint32_t generation = UINT32_MAX; // Of the registry slot when built
+		};
+
+		// DeathWallBehavior as structure of arrays
+		struct DeathWallPool {
+				std::vector<ObjectHandle> object;
+				std::vector<float> acceleration;
+				std::vector<float> velocity;
+				std::vector<float> maxSpeed;
+				std::vector<glm::vec2> startPos;
+				std::vector<glm::vec2> direction;
+		};
+
+		const ObjectRegistry* registry_ = nullptr;
+		std::vector<BehaviorRef> refs_; // By registry slot
+		DeathWallPool deathWalls_;		// Idle and kill have no state, so no pools
+		std::vector<ObjectHandle> adapters_;
+		size_t builtCount_ = 0; // Objects at or past this index may be newer than the build
+		int pooledCount_ = 0;
+};
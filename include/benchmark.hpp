@@ -0,0 +1,31 @@
+#pragma once
+#include <string>
+#include "tilemap.hpp"
+#include "collisionspace.hpp"
+
+// Headless microbenchmarks, run with `./game --bench [path/to/level.tmap]`.
+// No window or GL context is created, so these only cover CPU-side systems.
+int runBenchmarks(const std::string& levelPath);
+
+void benchTilemapQueries(const Tilemap& tilemap);
+void benchCollisionSpace(const Tilemap& tilemap);
+void benchTileColliders(const Tilemap& tilemap);
+void benchSubstepping(const Tilemap& tilemap);
+void benchActivity(const Tilemap& tilemap);
+void benchPlatforms(const Tilemap& tilemap);
+void benchAABBBatch(const Tilemap& tilemap);
+void benchTriggers(const Tilemap& tilemap);
+void benchBehaviors(const Tilemap& tilemap);
+void benchHandles(const Tilemap& tilemap);
+void benchTransforms(const Tilemap& tilemap);
+void benchTransform2D(const Tilemap& tilemap);
+void benchSceneGraph(const Tilemap& tilemap);
+void benchEvents(const Tilemap& tilemap);
+void benchJobs(const Tilemap& tilemap);
+void benchFrameHandoff(const Tilemap& tilemap);
+void benchLevelLoading(const std::string& levelPath);
+void benchLevelPreloading(const std::string& levelPath);
+void benchLevelIndex();
+void benchLevelFormats();
+void benchTileWorld();
+bool benchFixedPoint(const Tilemap& tilemap); // False if float and fixed-point trajectories diverge
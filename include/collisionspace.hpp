@@ -0,0 +1,62 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "tilemap.hpp"
+#include "tilecollider.hpp"
+#include "jobs.hpp"
+
+// Configuration space of a sensor layout against the tilemap: solid tiles dilated by
+// the layout's sensor offsets and sampled on a sub-tile grid. A cell is marked free only
+// when no centre position inside it could put any sensor into a solid tile, so "free" is
+// conservative. Cells that are not free lie within one sensor reach of a solid tile and
+// need the precise per-sensor test.
+class CollisionSpace {
+
+	public:
+		static const int SUBDIV = 4; // Cells per tile along each axis
+
+		// Brings the grid in line with the tilemap and sensor layout: a full rebuild on
+		// a new level or changed layout, otherwise only the cells around changed tiles.
+		// A full rebuild gives up between row bands once *cancel is set, leaving the space
+		// to rebuild again on the next sync.
+		void sync(const Tilemap& tilemap, const SensorLayout& layout, const std::atomic<bool>* cancel = nullptr);
+
+		// Single bit lookup: true when the centre is definitely clear of solid tiles
+		bool isFree(const glm::vec2& centre) const;
+
+		// Walks the cells crossed by centre -> centre + delta and returns the fraction of
+		// delta covered before entering a cell that is not free (1 when the whole path is free)
+		float sweep(const glm::vec2& centre, const glm::vec2& delta) const;
+
+		// Full rebuilds split the cell rows over its workers
+		void setJobSystem(JobSystem* jobs) { jobs_ = jobs; }
+
+		const SensorLayout& getLayout() const { return layout_; }
+		int getRebuildCount() const { return rebuildCount_; }
+		size_t getMemoryBytes() const { return free_.size() * sizeof(uint64_t); }
+
+	private:
+		void rebuild(const Tilemap& tilemap, const std::atomic<bool>* cancel);
+		void updateCells(const Tilemap& tilemap, int cx0, int cy0, int cx1, int cy1);
+		bool computeFree(const Tilemap& tilemap, int cx, int cy) const;
+		bool cellFree(int cx, int cy) const {
+			if (cx < 0 || cx >= cellsX_ || cy < 0 || cy >= cellsY_)
+				return false; // Off-map cells always take the exact path
+			return (free_[static_cast<size_t>(cy) * words_ + (cx >> 6)] >> (cx & 63)) & 1u;
+		}
+
+		uint32_t tilemapId_ = 0;
+		uint64_t revision_ = 0;
+		SensorLayout layout_;
+		float tileSize_ = 1.0f;
+		float cellSize_ = 1.0f;
+		int cellsX_ = 0;
+		int cellsY_ = 0;
+		int words_ = 0;				 // uint64_t words per cell row
+		std::vector<uint64_t> free_; // One bit per cell, rows packed back to back
+		std::vector<glm::ivec2> changes_;
+		int rebuildCount_ = 0;
+		JobSystem* jobs_ = nullptr;
+};
@@ -0,0 +1,89 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "tilemap.hpp"
+
+// .tlvl: a level compiled from its .tmap so that loading it is a mmap instead of a parse.
+//
+//   header | palette | markers | chunk table | collision rects | tilemap grids
+//
+// The grids section is byte for byte the block a Tilemap keeps its masks, edge masks and
+// palette indices in (see Tilemap::storageBytes), so the loaded tilemap points straight into
+// the mapping. Native byte order; a file with the wrong magic or version is just recompiled.
+const uint32_t COMPILED_LEVEL_VERSION = 3; // 3: collision rects are back
+
+struct CompiledLevelHeader {
+		char magic[4]; // "TLVL"
+		uint32_t version;
+		int32_t width, height;
+		uint64_t sourceSize;	 // Of the .tmap it was compiled from, to tell when a cached copy is stale
+		int64_t sourceModified;	 // Same clock as LevelMetaData::modifiedTime
+		uint32_t paletteCount;
+		uint32_t markerCount;
+		uint32_t chunkTiles;	 // Chunk edge length in tiles
+		uint32_t chunkCount;	 // Row-major, ceil(width / chunkTiles) per row
+		uint64_t rectCount;
+		uint64_t paletteOffset, markerOffset, chunkOffset, rectOffset;
+		uint64_t gridOffset, gridBytes; // Offset is 64-byte aligned
+};
+
+struct CompiledPaletteEntry {
+		uint8_t type, visible, solid, skin; // TileEnum, bools, TileSkin
+		float color[4];
+};
+
+enum class LevelMarkerKind : uint32_t { PLAYER, GOAL, DEATH_WALL_START, DEATH_WALL_END, PLATFORM };
+
+// Spawn points and the like, in tile indices
+struct LevelMarker {
+		LevelMarkerKind kind;
+		int32_t x, y;
+		int32_t width, travelX, travelY; // Platforms only
+};
+
+CompiledPaletteEntry compilePaletteEntry(const TilePaletteEntry& entry);
+TilePaletteEntry readPaletteEntry(const CompiledPaletteEntry& entry);
+// Player, goal and death wall positions, then one per platform
+std::vector<LevelMarker> collectLevelMarkers(const Tilemap& tilemap);
+
+// Per-chunk tile counts, so geometry building can skip empty chunks without reading them
+struct LevelChunkInfo {
+		uint32_t visibleTiles;
+		uint32_t solidTiles;
+};
+
+// Size and mtime of the .tmap a level is compiled from
+struct LevelSource {
+		uint64_t size = 0;
+		int64_t modified = 0;
+};
+bool statLevelSource(const std::string& tmapPath, LevelSource& source);
+
+// Where the compiled copy of a .tmap is cached: a .compiled directory beside it
+std::string compiledLevelPath(const std::string& tmapPath);
+
+// Written through a temp file and rename. chunks, if given, receives the chunk table.
+// Once *cancel is set it stops between rows and write blocks, removes the temp file and
+// returns false without an error message.
+bool writeCompiledLevel(const Tilemap& tilemap, const std::string& path, const LevelSource& source,
+						std::vector<LevelChunkInfo>* chunks = nullptr, const std::atomic<bool>* cancel = nullptr);
+
+// Maps a .tlvl into tilemap. False, with tilemap untouched, when the file is missing or
+// malformed, or when source is given and the file wasn't compiled from that version of it.
+// chunks is left empty if the file's chunk size isn't TileMesh's.
+bool loadCompiledLevel(const std::string& path, float tileSize, Texture* floorTex, Texture* wallTex, Tilemap& tilemap,
+					   const LevelSource* source = nullptr, std::vector<LevelChunkInfo>* chunks = nullptr);
+
+// How the game loads a level: a .tlvl is mapped directly; a .tmap comes from its compiled
+// copy when that's current, otherwise it's parsed and the copy written for next time.
+// A .tworld is read whole through TileWorld; LevelLoader streams it instead.
+// Throws like loadTilemapFromFile.
+Tilemap loadLevelFile(const std::string& path, float tileSize, Texture* floorTex, Texture* wallTex,
+					  LoadProgress* progress = nullptr, std::vector<LevelChunkInfo>* chunks = nullptr);
+
+// ./game --compile-level: compiles tmapPath to outPath (its cache path when empty), or to a
+// streaming TileWorld when outPath ends in .tworld.
+// Returns a process exit code.
+int compileLevelFile(const std::string& tmapPath, const std::string& outPath);
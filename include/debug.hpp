@@ -1,7 +1,8 @@
 #pragma once
+#include <atomic>
 #include <iostream>
 
-extern bool g_debugEnabled;
+extern std::atomic<bool> g_debugEnabled; // Read by the simulation thread too
 
 #define DEBUG_ONLY(code) do { if (g_debugEnabled) { code; } } while(0)
 
@@ -0,0 +1,220 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include "triggers.hpp"
+
+// GAMEPLAY EVENTS - plain data, copied into fixed rings
+
+enum class DeathCause : uint8_t { HAZARD_TILE, KILL_ZONE, KILL_OBJECT, DEATH_WALL, OTHER };
+
+struct PlayerDiedEvent {
+		DeathCause cause;
+		glm::vec2 position;
+};
+
+struct ReachedGoalEvent {
+		int trigger;
+		glm::vec2 position;
+};
+
+struct CheckpointReachedEvent {
+		int trigger;
+};
+
+// Trigger enters and exits (stays aren't published; TriggerSystem still lists them)
+struct TriggerCrossedEvent {
+		int trigger;
+		TriggerType type;
+		TriggerPhase phase;
+};
+
+// QUEUES - fixed capacity, nothing allocated after construction
+
+// Single-threaded ring. A full ring drops new events and counts them rather than growing.
+template <typename E, size_t N>
+class EventRing {
+
+	public:
+		bool push(const E& event) {
+			if (count_ == N) {
+				dropped_++;
+				return false;
+			}
+			events_[(head_ + count_) % N] = event;
+			count_++;
+			return true;
+		}
+		bool pop(E& event) {
+			if (count_ == 0)
+				return false;
+			event = events_[head_];
+			head_ = (head_ + 1) % N;
+			count_--;
+			return true;
+		}
+		size_t size() const { return count_; }
+		size_t getDropped() const { return dropped_; }
+
+	private:
+		std::array<E, N> events_;
+		size_t head_ = 0;
+		size_t count_ = 0;
+		size_t dropped_ = 0;
+};
+
+// Lock-free bounded queue for any number of producer threads and one consumer. Each cell
+// carries a sequence number saying whose turn it is, so producers only contend on one
+// atomic increment and never wait on each other (bounded MPMC scheme after Vyukov,
+// restricted here to a single consumer). N must be a power of two.
+template <typename E, size_t N>
+class MpscEventQueue {
+		static_assert((N & (N - 1)) == 0, "MpscEventQueue capacity must be a power of two");
+
+	public:
+		MpscEventQueue() {
+			for (size_t i = 0; i < N; ++i)
+				cells_[i].sequence.store(i, std::memory_order_relaxed);
+		}
+
+		bool push(const E& event) {
+			size_t pos = tail_.load(std::memory_order_relaxed);
+			for (;;) {
+				Cell& cell = cells_[pos & (N - 1)];
+				size_t seq = cell.sequence.load(std::memory_order_acquire);
+				intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+				if (diff == 0) {
+					if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+						cell.event = event;
+						cell.sequence.store(pos + 1, std::memory_order_release);
+						return true;
+					}
+				} else if (diff < 0) {
+					dropped_.fetch_add(1, std::memory_order_relaxed); // Full
+					return false;
+				} else {
+					pos = tail_.load(std::memory_order_relaxed);
+				}
+			}
+		}
+		// Consumer thread only
+		bool pop(E& event) {
+			Cell& cell = cells_[head_ & (N - 1)];
+			size_t seq = cell.sequence.load(std::memory_order_acquire);
+			if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(head_ + 1) < 0)
+				return false; // Empty, or the producer that claimed it hasn't finished writing
+			event = cell.event;
+			cell.sequence.store(head_ + N, std::memory_order_release);
+			head_++;
+			return true;
+		}
+		size_t size() const { return tail_.load(std::memory_order_acquire) - head_; } // Approximate
+		size_t getDropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+	private:
+		struct Cell {
+				std::atomic<size_t> sequence;
+				E event;
+		};
+		// Producers hammer tail_; keep it off the consumer's cache line
+		alignas(64) std::atomic<size_t> tail_{0};
+		alignas(64) size_t head_ = 0;
+		alignas(64) std::atomic<size_t> dropped_{0};
+		Cell cells_[N];
+};
+
+// BUS
+
+const size_t EVENT_CAPACITY = 256;	// Per event type
+const int MAX_EVENT_SUBSCRIBERS = 8; // Per event type
+
+// One queue per event type, each with a fixed list of plain function-pointer subscribers.
+// Publishing copies the event into its queue and nothing else; dispatch() runs once per
+// frame on the owning thread and hands every queued event to its type's subscribers in
+// publish order. Event types are dispatched in the order they're listed.
+template <template <typename, size_t> class Queue, typename... Events>
+class BasicEventBus {
+
+	public:
+		template <typename E>
+		bool publish(const E& event) {
+			return channel<E>().queue.push(event);
+		}
+
+		// fn(context, event). Returns false when the type's subscriber slots are full.
+		template <typename E>
+		bool subscribe(void (*fn)(void*, const E&), void* context) {
+			Channel<E>& ch = channel<E>();
+			if (ch.subscriberCount == MAX_EVENT_SUBSCRIBERS)
+				return false;
+			ch.subscribers[ch.subscriberCount++] = {fn, context};
+			return true;
+		}
+		// Member function subscriber, without a std::function in between
+		template <typename E, typename T, void (T::*Method)(const E&)>
+		bool subscribe(T* object) {
+			return subscribe<E>([](void* context, const E& event) { (static_cast<T*>(context)->*Method)(event); }, object);
+		}
+
+		void dispatch() { (dispatchChannel<Events>(), ...); }
+		// Throws away everything queued (level reloads)
+		void discard() { (discardChannel<Events>(), ...); }
+
+		template <typename E>
+		size_t getPending() const {
+			return std::get<Channel<E>>(channels_).queue.size();
+		}
+		template <typename E>
+		size_t getDropped() const {
+			return std::get<Channel<E>>(channels_).queue.getDropped();
+		}
+
+	private:
+		template <typename E>
+		struct Subscriber {
+				void (*fn)(void*, const E&);
+				void* context;
+		};
+		template <typename E>
+		struct Channel {
+				Queue<E, EVENT_CAPACITY> queue;
+				Subscriber<E> subscribers[MAX_EVENT_SUBSCRIBERS];
+				int subscriberCount = 0;
+		};
+
+		template <typename E>
+		Channel<E>& channel() {
+			return std::get<Channel<E>>(channels_);
+		}
+		template <typename E>
+		void dispatchChannel() {
+			Channel<E>& ch = channel<E>();
+			E event;
+			while (ch.queue.pop(event)) {
+				for (int i = 0; i < ch.subscriberCount; ++i)
+					ch.subscribers[i].fn(ch.subscribers[i].context, event);
+			}
+		}
+		template <typename E>
+		void discardChannel() {
+			E event;
+			while (channel<E>().queue.pop(event)) {
+			}
+		}
+
+		std::tuple<Channel<Events>...> channels_;
+};
+
+template <typename... Events>
+using EventBus = BasicEventBus<EventRing, Events...>;
+// Same interface; publish() may be called from any thread, dispatch() from one
+template <typename... Events>
+using ConcurrentEventBus = BasicEventBus<MpscEventQueue, Events...>;
+
+// The game's bus. Goal comes before death, so reaching the goal and dying in the same
+// step still counts as a win, as it did when these were flags. A class rather than an
+// alias so headers below this one (behaviours) can forward declare it.
+class GameEvents : public EventBus<ReachedGoalEvent, PlayerDiedEvent, CheckpointReachedEvent, TriggerCrossedEvent> {};
@@ -0,0 +1,133 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <cmath>
+#include <cstdint>
+
+// 32-bit Q16.16 fixed point. Every operation is plain integer arithmetic, so results are
+// bit-identical across compilers, optimisation flags and machines. Range is +/-32768
+// world units with a resolution of 1/65536.
+struct Fixed {
+		static const int FRAC_BITS = 16;
+		static const int32_t ONE = 1 << FRAC_BITS;
+
+		int32_t raw = 0;
+
+		static constexpr Fixed fromRaw(int32_t raw) {
+			Fixed f;
+			f.raw = raw;
+			return f;
+		}
+		static constexpr Fixed fromInt(int v) { return fromRaw(v * ONE); }
+		// Rounds to nearest; only used at the float boundary (constants, input, rendering)
+		static Fixed fromFloat(float v) { return fromRaw(static_cast<int32_t>(std::lround(static_cast<double>(v) * ONE))); }
+		float toFloat() const { return static_cast<float>(raw) / ONE; }
+
+		Fixed operator-() const { return fromRaw(-raw); }
+		Fixed operator+(Fixed o) const { return fromRaw(raw + o.raw); }
+		Fixed operator-(Fixed o) const { return fromRaw(raw - o.raw); }
+		// Products and quotients go through 64 bits; the shift floors toward -infinity
+		Fixed operator*(Fixed o) const { return fromRaw(static_cast<int32_t>((static_cast<int64_t>(raw) * o.raw) >> FRAC_BITS)); }
+		Fixed operator/(Fixed o) const { return fromRaw(static_cast<int32_t>((static_cast<int64_t>(raw) << FRAC_BITS) / o.raw)); }
+		Fixed operator*(int v) const { return fromRaw(raw * v); }
+		Fixed& operator+=(Fixed o) { raw += o.raw; return *this; }
+		Fixed& operator-=(Fixed o) { raw -= o.raw; return *this; }
+		Fixed& operator*=(Fixed o) { return *this = *this * o; }
+
+		bool operator==(Fixed o) const { return raw == o.raw; }
+		bool operator!=(Fixed o) const { return raw != o.raw; }
+		bool operator<(Fixed o) const { return raw < o.raw; }
+		bool operator>(Fixed o) const { return raw > o.raw; }
+		bool operator<=(Fixed o) const { return raw <= o.raw; }
+		bool operator>=(Fixed o) const { return raw >= o.raw; }
+};
+
+struct FixedVec2 {
+		using value_type = Fixed;
+
+		Fixed x, y;
+
+		FixedVec2() = default;
+		FixedVec2(Fixed x, Fixed y) : x(x), y(y) {}
+
+		static FixedVec2 fromFloat(const glm::vec2& v) { return FixedVec2(Fixed::fromFloat(v.x), Fixed::fromFloat(v.y)); }
+		glm::vec2 toFloat() const { return glm::vec2(x.toFloat(), y.toFloat()); }
+
+		Fixed& operator[](int i) { return i == 0 ? x : y; }
+		const Fixed& operator[](int i) const { return i == 0 ? x : y; }
+
+		FixedVec2 operator+(const FixedVec2& o) const { return FixedVec2(x + o.x, y + o.y); }
+		FixedVec2 operator-(const FixedVec2& o) const { return FixedVec2(x - o.x, y - o.y); }
+		FixedVec2 operator*(Fixed s) const { return FixedVec2(x * s, y * s); }
+		FixedVec2& operator+=(const FixedVec2& o) { x += o.x; y += o.y; return *this; }
+
+		bool operator==(const FixedVec2& o) const { return x == o.x && y == o.y; }
+		bool operator!=(const FixedVec2& o) const { return !(*this == o); }
+};
+
+// Scalar helpers so physics code can be written once for float and Fixed
+inline float toFloat(float v) { return v; }
+inline float toFloat(Fixed v) { return v.toFloat(); }
+inline glm::vec2 toFloat(const glm::vec2& v) { return v; }
+inline glm::vec2 toFloat(const FixedVec2& v) { return v.toFloat(); }
+
+template <typename S>
+S fromFloat(float v);
+template <>
+inline float fromFloat<float>(float v) { return v; }
+template <>
+inline Fixed fromFloat<Fixed>(float v) { return Fixed::fromFloat(v); }
+
+template <typename Vec>
+Vec fromFloatVec(const glm::vec2& v);
+template <>
+inline glm::vec2 fromFloatVec<glm::vec2>(const glm::vec2& v) { return v; }
+template <>
+inline FixedVec2 fromFloatVec<FixedVec2>(const glm::vec2& v) { return FixedVec2::fromFloat(v); }
+
+inline float absValue(float v) { return std::abs(v); }
+inline Fixed absValue(Fixed v) { return v.raw < 0 ? -v : v; }
+
+// Tile index along one axis (floor division), matching Tilemap::worldToTileIndex for floats
+inline int tileCoord(float v, float tileSize) { return static_cast<int>(std::floor(v / tileSize)); }
+inline float tileStart(int idx, float tileSize) { return idx * tileSize; }
+
+// The tile size for fixed-point grid maths. TILE_SIZE (1.2) isn't a Q16.16 number, and
+// rounding it to 16 fractional bits would shift tile k by k times that rounding: 1.4e-3
+// world units by tile 460, enough to put a sensor in a different tile than the float
+// path does. With 40 fractional bits every grid line is within one raw unit of the
+// float tile size's. Still integer maths, so still bit-identical everywhere.
+struct FixedTileSize {
+		static const int FRAC_BITS = 40;
+		int64_t raw;
+
+		explicit FixedTileSize(float tileSize)
+			: raw(std::llround(static_cast<double>(tileSize) * static_cast<double>(int64_t(1) << FRAC_BITS))) {}
+};
+inline int tileCoord(Fixed v, FixedTileSize tileSize) {
+	int64_t scaled = static_cast<int64_t>(v.raw) * (int64_t(1) << (FixedTileSize::FRAC_BITS - Fixed::FRAC_BITS));
+	int64_t q = scaled / tileSize.raw;
+	return static_cast<int>((scaled % tileSize.raw != 0 && scaled < 0) ? q - 1 : q);
+}
+inline Fixed tileStart(int idx, FixedTileSize tileSize) {
+	const int shift = FixedTileSize::FRAC_BITS - Fixed::FRAC_BITS;
+	return Fixed::fromRaw(static_cast<int32_t>((idx * tileSize.raw + (int64_t(1) << (shift - 1))) >> shift));
+}
+
+// What tileCoord/tileStart take for a scalar type: float for float, FixedTileSize for Fixed
+template <typename S>
+struct TileGrid {
+		using Size = float;
+};
+template <>
+struct TileGrid<Fixed> {
+		using Size = FixedTileSize;
+};
+
+// Physics storage type, chosen at build time (make FIXED_POINT=1)
+#ifdef PHYSICS_FIXED_POINT
+using PhysReal = Fixed;
+using PhysVec2 = FixedVec2;
+#else
+using PhysReal = float;
+using PhysVec2 = glm::vec2;
+#endif
@@ -0,0 +1,66 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+#include "playerobject.hpp"
+#include "transform2d.hpp"
+#include "texture.hpp"
+
+// What the render thread needs to draw one simulation step, copied out by the simulation
+// thread. Nothing in it points back into simulation state (textures are shared and never
+// change during play), so the renderer can draw it while the next step runs.
+
+struct SpriteInstance {
+		Transform2D transform;
+		glm::vec4 color;
+		Texture* texture;
+};
+
+struct DebugLine {
+		glm::vec2 start, end;
+		glm::vec4 color;
+};
+
+// Inclusive tile rect; empty when x1 < x0
+struct TileRange {
+		int x0 = 0, y0 = 0, x1 = -1, y1 = -1;
+};
+
+// The values the debug window shows
+struct FrameStats {
+		glm::vec2 playerPosition = glm::vec2(0.0f);
+		glm::vec2 playerVelocity = glm::vec2(0.0f);
+		MoveState moveState = MoveState::IDLE;
+		FacingDirection facing = FacingDirection::RIGHT;
+		bool grounded = false;
+		bool playerSpaceFree = false;
+		int spaceRebuilds = 0;
+		int activeObjects = 0, sleepingObjects = 0;
+		bool hasDeathWall = false;
+		glm::vec2 deathWallPosition = glm::vec2(0.0f);
+		int platforms = 0, riddenPlatforms = 0;
+		int triggers = 0, testedTriggers = 0, insideTriggers = 0;
+		int playerSubsteps = 0;
+		long playerCappedSteps = 0;
+		int residentChunks = 0; // Streamed levels only
+		long chunkLoads = 0, chunkEvictions = 0;
+};
+
+struct FrameSnapshot {
+		uint64_t step = 0;	// Simulation step that produced it, 0 before the first
+		glm::vec2 camera = glm::vec2(0.0f); // World point the view follows (the player)
+		TileRange visibleTiles;			   // Tiles inside the view around camera
+		// A streamed level can't be read from the render thread, so its visible tiles are
+		// copied out as sprites; otherwise the renderer reads visibleTiles of the tilemap
+		bool streamed = false;
+		std::vector<SpriteInstance> tiles;
+
+		SpriteInstance player = {Transform2D(), glm::vec4(1.0f), nullptr};
+		glm::vec2 playerUVMin = glm::vec2(0.0f), playerUVMax = glm::vec2(1.0f);
+		float playerUVOffset = 0.0f;
+
+		std::vector<SpriteInstance> sprites; // Objects, then platforms, in draw order
+		std::vector<DebugLine> debugLines;	 // Player sensors; only filled in debug mode
+		float countdown = 0.0f;				 // Seconds left on the level-start countdown
+		FrameStats stats;
+};
@@ -3,6 +3,7 @@
 #include <chrono>
 #include <iostream>
 #include "tilemap.hpp"
+#include "tileworld.hpp"
 #include "level.hpp"
 #include "physics.hpp"
 #include "renderer2d.hpp"
@@ -14,11 +15,18 @@
 #include "debug.hpp"
 #include "globals.hpp"
 #include "color.hpp"
+#include "scenegraph.hpp"
+#include "framesnapshot.hpp"
+#include "triplebuffer.hpp"
+#include "simthread.hpp"
+
+const float SIM_STEP = 1.0f / 120.0f; // Seconds per simulation step, independent of the display rate
+const int TILE_UPLOADS_PER_FRAME = 16; // Tile chunk buffers created per frame after a load
 
 enum class GameState {
 	MENU,
 	LEVEL_SELECT,
-	// LOAD, // may not used
+	LOADING, // Level loading in the background, then its buffers uploading
 	PLAY,
 	PAUSE,
 	DEAD,
@@ -48,6 +56,7 @@ class GameManager {
 		// State-specific routines, includes input handling, physics, rendering
 		// for each state
 		void handleMenuState();
+		void handleLoadingState();
 		void handlePlayState();
 		void handlePauseState();
 		void handleDeadState();
@@ -56,6 +65,29 @@ class GameManager {
 		void handleDemo3D();
 		void handleExitState();
 
+		// Level loading. The loader thread parses and prepares the level, possibly ahead of
+		// time; the result is moved in on this thread, then the tile geometry uploads over
+		// the next frames.
+		void beginLevelLoad(int levelIndex);
+		std::string levelPath(int levelIndex) const; // Empty when out of range
+		void applyLoadedLevel(LoadedLevel&& level);
+		void startLevel(); // Player, objects and systems back to the start of tilemap_, then PLAY
+		// Player, death walls, sleepers, platforms and triggers back to the start of the level.
+		// With keepCheckpoint the player respawns at the last checkpoint reached instead.
+		void resetLevelState(bool keepCheckpoint);
+
+		// Simulation thread. Runs while in PLAY; only it touches gameplay state meanwhile,
+		// and state changes it wants are requested for the main thread to make.
+		void startSimulation();
+		bool simulateStep(float deltaTime);
+		void publishFrame(); // Snapshot of the current step for the renderer
+		void requestState(GameState state);
+
+		// Event handlers (simulation thread)
+		void onReachedGoal(const ReachedGoalEvent& event);
+		void onPlayerDied(const PlayerDiedEvent& event);
+		void onCheckpointReached(const CheckpointReachedEvent& event);
+
 		// Subsystem returns
 		PlayerObject& getPlayer() { return player_; }
 		Tilemap& getTilemap() { return tilemap_; }
@@ -88,15 +120,43 @@ class GameManager {
 		LevelManager& levelManager_;
 		// Tilemap& currTilemap_;
 		Tilemap& tilemap_;
+		// The level when a streamed one is loaded, tilemap_ then only a stand-in. Only the
+		// simulation thread touches it during PLAY, since queries load chunks.
+		std::unique_ptr<TileWorld> world_;
 		bool hasLevels_ = false;
 
 		// Gameplay
 		PlayerObject& player_;
 		std::vector<GameObject>& objects_;
 		Physics& physics_;
+		ActivitySet activity_; // Awake/asleep tracking for objects_
+		ObjectRegistry registry_; // Handles and name tags for objects_
+		BehaviorPools behaviors_; // Behaviours of objects_, pooled by type
+		ObjectHandle deathWall_;  // Cached once instead of searched for by name
+		SceneGraph scene_;		  // Parent/child attachments between objects_
+		GameEvents events_;		  // Gameplay outcomes, dispatched once per frame in PLAY
+		JobSystem jobs_;		  // Worker threads for physics and scene updates
+		PlatformSystem platforms_; // Moving platforms from the current tilemap
+		TriggerSystem triggers_;   // Goals, checkpoints and kill zones from the current tilemap
 		bool levelCountdown_ = true;
 
+		// Level loading
+		LevelCache levelCache_;			   // Levels loading or loaded ahead of being played
+		std::string loadingPath_;		   // Level LOADING waits for
+		int currentLevelIndex_ = -1;	   // In the level list; -1 for the startup level
+		TileMesh tileMesh_;				   // Chunk geometry of tilemap_
+		bool levelPending_ = false;		   // Loaded level moved in, tile uploads still running
+		int pendingChunks_ = 0;			   // Chunks to upload when the pending level came in
+
 		// Timing management for game loop
 		float lastFrameTime_ = 0.0f;
 		float countdownTimer_ = 0.0f; // Timer for WIN state countdown
+
+		// Simulation/render handoff
+		TripleBuffer<FrameSnapshot> frames_;
+		uint64_t simSteps_ = 0;
+		std::atomic<float> viewAspect_{16.0f / 9.0f}; // Written by the renderer, read when capturing
+		std::atomic<bool> stateRequested_{false};
+		GameState requestedState_ = GameState::PLAY; // Valid once stateRequested_ is set
+		SimulationThread sim_; // Last, so it's stopped before anything it uses is destroyed
 };
\ No newline at end of file
@@ -6,6 +6,8 @@
 #include <memory>
 #include "behavior.hpp"
 #include "texture.hpp"
+#include "tags.hpp"
+#include "transform2d.hpp"
 
 struct AABB {
 		float left, right, top, bottom;
@@ -30,50 +32,54 @@ class GameObject {
 		GameObject(const glm::vec2& position, const glm::vec2& scale, float rotation, const glm::vec4& color);
 
 		// Setters
-		// After any transformation, AABB must be recomputed
+		// Transform setters only mark the AABB and model matrix stale; they're rebuilt once,
+		// the next time they're asked for
 		void setPosition(const glm::vec2& position) {
 			position_ = position;
-			computeAABB();
+			markTransformDirty();
 		}
 		void offsetPosition(const glm::vec2& offset) {
 			position_ += offset;
-			computeAABB();
+			markTransformDirty();
 		}
 		void multPosition(const glm::vec2& multiplier) {
 			position_ *= multiplier;
-			computeAABB();
+			markTransformDirty();
 		}
 
 		void setInitPosition(const glm::vec2& initPos) { initPos_ = initPos; }
 
 		void setScale(const glm::vec2& scale) {
 			scale_ = scale;
-			computeAABB();
+			markTransformDirty();
 		}
 		void offsetScale(const glm::vec2& offset) {
 			scale_ += offset;
-			computeAABB();
+			markTransformDirty();
 		}
 		void multScale(const glm::vec2& multiplier) {
 			scale_ *= multiplier;
-			computeAABB();
+			markTransformDirty();
 		}
 
 		void setRotation(float rotation) {
 			rotation_ = rotation;
-			computeAABB();
+			markTransformDirty();
 		}
 		void offsetRotation(float offset) {
 			rotation_ += offset;
-			computeAABB();
+			markTransformDirty();
 		}
 		void multRotation(float multiplier) {
 			rotation_ *= multiplier;
-			computeAABB();
+			markTransformDirty();
 		}
 
 		void setColor(const glm::vec4& color) { color_ = color; }
-		void setName(const std::string& name) { name_ = name; }
+		void setName(const std::string& name) {
+			name_ = name;
+			tag_ = internTag(name);
+		}
 
 		void setVelocity(const glm::vec2& velocity) { velocity_ = velocity; } // Set the velocity vector
 		void addVelocity(const glm::vec2& delta) { velocity_ += delta; }	  // Add to the velocity vector
@@ -91,6 +97,7 @@ class GameObject {
 
 		const glm::vec4& getColor() const { return color_; }
 		const std::string& getName() const { return name_; }
+		TagId getTag() const { return tag_; } // Interned name; compare these instead of names
 
 		const glm::vec2& getVelocity() const { return velocity_; } // Returns the velocity vector
 		const glm::vec2 getSpeed() const { return glm::vec2(abs(velocity_.x), abs(velocity_.y)); } // Returns the speed (magnitude of velocity) vector
@@ -104,17 +111,30 @@ class GameObject {
 		bool isGrounded() const { return isGrounded_; } // Returns whether the object is grounded
 
 		// AABB-related methods
-		const void computeAABB();
 		const AABB computeOffsetAABB(const glm::vec2& offset); // Computes AABB based on next position
 		// NOTE: This EXPLICITLY DOES NOT UPDATE THE INTERNAL AABB.
-		const AABB& getAABB() const { return aabb_; } // Returns the computed AABB
+		const AABB& getAABB() const { // Returns the AABB, recomputing it if the transform changed
+			if (dirty_ & DIRTY_AABB)
+				computeAABB();
+			return aabb_;
+		}
+
+		// Cached object-to-world transform, rebuilt if position, scale or rotation changed
+		const Transform2D& getTransform2D() const {
+			if (dirty_ & DIRTY_TRANSFORM)
+				computeTransform();
+			return transform_;
+		}
+		glm::mat4 getModelMatrix() const { return getTransform2D().toMat4(); } // For 3D/GL code that wants a mat4
 
-		glm::mat4 getModelMatrix() const; // Computes and returns model matrix
+		// Bumped by every transform change. Systems that cache something derived from an
+		// object's transform can store this and skip the object while it's unchanged.
+		uint32_t getTransformVersion() const { return transformVersion_; }
 
 		// Behavior management
 		void setBehavior(std::unique_ptr<Behavior> behavior);
 		void updateBehavior(float deltaTime);
-		void handlePlayerCollision(class PlayerObject& player);
+		void handlePlayerCollision(class PlayerObject& player, GameEvents& events);
 		Behavior* getBehavior() const { return behavior_.get(); }
 
 		// Texture rendering and management
@@ -127,6 +147,16 @@ class GameObject {
 		void clearTexture() { texture_ = nullptr; }
 
 	private:
+		// Not thread-safe: the const getters fill these caches in on first use
+		static const uint8_t DIRTY_AABB = 1 << 0;
+		static const uint8_t DIRTY_TRANSFORM = 1 << 1;
+		void markTransformDirty() {
+			dirty_ = DIRTY_AABB | DIRTY_TRANSFORM;
+			transformVersion_++;
+		}
+		void computeAABB() const;
+		void computeTransform() const;
+
 		glm::vec2 position_; // X, Y position
 		glm::vec2 scale_;	 // Scaling coefficient (in each direction)
 		float rotation_;	 // Angle in radians
@@ -135,10 +165,14 @@ class GameObject {
 
 		glm::vec4 color_;
 		std::string name_;
+		TagId tag_;
 
 		glm::vec2 velocity_ = glm::vec2(0.0f);	   // Velocity vector
 		glm::vec2 acceleration_ = glm::vec2(0.0f); // Acceleration vector (not used yet)
-		AABB aabb_;								   // Axis-aligned bounding box for collision detection
+		mutable AABB aabb_;						   // Axis-aligned bounding box for collision detection
+		mutable Transform2D transform_;
+		mutable uint8_t dirty_ = DIRTY_AABB | DIRTY_TRANSFORM;
+		uint32_t transformVersion_ = 0;
 
 		bool isGrounded_ = false;
 
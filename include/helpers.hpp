@@ -26,10 +26,16 @@
 #include "globals.hpp"
 #include "userinterface.hpp"
 #include "fonts.hpp"
+#include "framesnapshot.hpp"
 
 constexpr double targetFPS = 120.0;
 constexpr double targetFrameTime = 1.0 / targetFPS; // ~0.016666... seconds
 
+// Play camera: fixed world height, width from the framebuffer aspect, and the view sits
+// slightly ahead of and above the player
+const float CAMERA_WORLD_HEIGHT = 5.5f / 0.8f;
+const glm::vec2 CAMERA_LEAD = glm::vec2(2.0f, 0.7f);
+
 enum class InputResult {
 	CONTINUE = 0,
 	PAUSE = 1,
@@ -43,20 +49,41 @@ PlayerObject setupPlayerObject(Tilemap& tilemap, float horizSensorScale, float v
 // std::vector<GameObject> setupObjects(float& worldHeight, float& worldWidth);
 
 // INPUT HANDLING -  Will likely add more state-specific functions later, but may move.
-InputResult playerInput(GameObject& player);
+InputResult playerInput(GameObject& player, const InputFrame& input);
 
 // RENDERING FUNCTIONS - some not used
 void drawStep(Window& window, Renderer2D& renderer, Shader& shader, const std::vector<GameObject>& objects);
 void drawStepPlayer(Window& window, Renderer2D& renderer, Shader& shader, const PlayerObject& player);
-void drawBackground(Window& window, Renderer2D& renderer, Shader& shader, const LevelManager& levelManager, const PlayerObject& player);
+void drawBackground(Window& window, Renderer2D& renderer, Shader& shader, const LevelManager& levelManager, const glm::vec2& cameraCenter);
+// Debug outlines of the tilemap's merged collision rects
+void drawCollisionRects(Renderer2D& renderer, Shader& shader, const Tilemap& tilemap);
 void drawTilemapAndPlayer(Window& window, Renderer2D& renderer, Shader& shader, const Tilemap& tilemap, const PlayerObject& player);
 void drawObjects(Window& window, Renderer2D& renderer, Shader& shader, const std::vector<GameObject>& objects);
 void finishDraw(Window& window, Renderer2D& renderer, Shader& shader);
 void finishDraw3D(Window& window, Renderer3D& renderer, Shader& shader);
 void renderCountdown(float countdownTime);
+// World rect the play camera shows around cameraCenter
+AABB cameraView(const glm::vec2& cameraCenter, float aspect);
+// Simulation side: copies what drawFrame needs out of the live objects. The step number,
+// countdown and stats are left to the caller.
+void captureFrame(FrameSnapshot& frame, const PlayerObject& player, const std::vector<GameObject>& objects,
+				  const std::vector<GameObject>& platforms, const Tilemap& tilemap, float aspect);
+// Same for a streamed level: streams in the chunks around the view and copies its tiles
+void captureFrame(FrameSnapshot& frame, const PlayerObject& player, const std::vector<GameObject>& objects,
+				  const std::vector<GameObject>& platforms, TileWorld& world, float aspect);
+// Render side: background, visible tiles, player and objects from a snapshot only. Tiles
+// come from the snapshot for a streamed level, from tileMesh when it was built from
+// tilemap, else straight from the tilemap.
+void drawFrame(Window& window, Renderer2D& renderer, Shader& shader, const LevelManager& levelManager, const Tilemap& tilemap,
+			   const TileMesh& tileMesh, const FrameSnapshot& frame);
 
 // UPDATE FUNCTIONS
-void updatePStatePlayer(PlayerObject& player, Physics& physics, Tilemap& tilemap, std::vector<GameObject>& objects, float deltaTime);
+void updateActiveBehaviors(std::vector<GameObject>& objects, BehaviorPools& behaviors, const ActivitySet& activity,
+						   float deltaTime);
+template <typename Grid>
+void updatePStatePlayer(PlayerObject& player, Physics& physics, const Grid& tilemap, std::vector<GameObject>& objects,
+						ActivitySet& activity, BehaviorPools& behaviors, PlatformSystem& platforms, TriggerSystem& triggers,
+						float deltaTime);
 void updateDeathWall(GameObject& deathWall, float deltaTime);
 
 // UTILITY FUNCTIONS
@@ -1,8 +1,23 @@
 #pragma once
 #include <GLFW/glfw3.h>
+#include <bitset>
+#include <mutex>
 #include <vector>
 #include <unordered_map>
 
+const int MAX_TRACKED_KEYS = 64;
+
+// Key state handed to another thread (the simulation). Held keys are as of the last
+// Input::update(); presses and releases are every edge since the previous takeFrame(), so
+// a tap shorter than a simulation step still registers.
+struct InputFrame {
+		std::bitset<MAX_TRACKED_KEYS> held, pressed, released; // By tracked-key slot
+
+		bool isKeyPressed(int key) const;
+		bool isKeyJustPressed(int key) const;
+		bool isKeyJustReleased(int key) const;
+};
+
 // Input class handles polling-style keyboard and mouse input
 // For now, assumes a single window and static usage pattern
 class Input {
@@ -13,8 +28,14 @@ class Input {
 		// Update key/mouse state (called once per frame)
 		static void update();
 
+		// Also drops the edges waiting for takeFrame()
 		static void clear();
 
+		// Any thread: the keys since the last call. GLFW key polling itself stays on the
+		// main thread in update().
+		static InputFrame takeFrame();
+		static int keySlot(int key); // -1 if the key isn't tracked
+
 		// --- Key State Queries ---
 		static bool isKeyPressed(int key);		// Currently held down
 		static bool isKeyJustPressed(int key);	// Transitioned from up to down this frame
@@ -27,4 +48,7 @@ class Input {
 
 		static std::unordered_map<int, int> s_currentKeys_;
 		static std::unordered_map<int, int> s_previousKeys_;
+
+		static std::mutex s_frameMutex_;
+		static InputFrame s_pendingFrame_; // Accumulated by update(), emptied by takeFrame()
 };
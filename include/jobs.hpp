@@ -0,0 +1,167 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+class JobCounter;
+
+// One unit of work: fn(data, begin, end). Plain function pointer plus context, so queuing
+// a job never allocates; parallelFor points data at the caller's lambda.
+struct Job {
+		void (*fn)(void* data, int begin, int end) = nullptr;
+		void* data = nullptr;
+		int begin = 0, end = 0;
+		const char* name = "job";	   // For the profiling hook
+		JobCounter* counter = nullptr; // Decremented when the job finishes
+};
+
+// Counts unfinished jobs. wait() on it, or hang jobs off it with runAfter() so they start
+// once it reaches zero. Wait for a counter before reusing it for a new batch.
+class JobCounter {
+
+	public:
+		bool isDone() const { return pending_.load(std::memory_order_acquire) == 0; }
+		int getPending() const { return pending_.load(std::memory_order_acquire); }
+
+	private:
+		friend class JobSystem;
+		std::atomic<int> pending_{0};
+		std::mutex mutex_;
+		std::vector<Job> continuations_; // Submitted when pending_ reaches zero
+};
+
+struct JobProfile {
+		const char* name;
+		int worker; // 0 is the thread that created the system, -1 a thread outside it
+		int begin, end;
+		uint64_t startNs, endNs; // steady_clock
+};
+// Called on the worker that ran the job, right after it finishes
+using JobProfileHook = void (*)(void* context, const JobProfile& profile);
+
+// Work-stealing scheduler. Each worker owns a deque: it pushes and pops its own jobs at the
+// back (newest first, still warm in cache) and, when out of work, steals the oldest job
+// from the front of another worker's deque. The creating thread counts as worker 0 and
+// runs jobs while it waits, so a one-core machine runs everything inline with no threads.
+// Jobs submitted from outside threads go to a shared queue any worker takes from.
+//
+// Determinism: parallelFor splits by the caller's grain only, never by worker count, so
+// chunk boundaries are the same on every machine; parallelReduce combines chunk results in
+// chunk order. Simulation code that writes disjoint outputs per chunk therefore gives the
+// same result on any core count. setSerial(true) additionally runs everything inline, in
+// submission order, for replays and debugging races.
+class JobSystem {
+
+	public:
+		// threads: total including the calling thread, 0 for one per hardware thread
+		explicit JobSystem(int threads = 0);
+		~JobSystem();
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+
+		void run(const Job& job, JobCounter* counter = nullptr);
+		// Starts job once dependency reaches zero. counter is incremented now, so waiting on
+		// it also covers jobs that haven't started yet.
+		void runAfter(JobCounter& dependency, const Job& job, JobCounter* counter = nullptr);
+		// Runs queued jobs on this thread until counter reaches zero
+		void wait(JobCounter& counter);
+
+		// fn(begin, end) over [0, count) in chunks of grain; returns when all chunks are done
+		template <typename Fn>
+		void parallelFor(const char* name, int count, int grain, Fn&& fn);
+		// fn(begin, end) -> T per chunk, folded left to right with combine(T, T)
+		template <typename T, typename Fn, typename Combine>
+		T parallelReduce(const char* name, int count, int grain, T init, Fn&& fn, Combine&& combine);
+		static int chunkCount(int count, int grain) { return count > 0 ? (count + grain - 1) / grain : 0; }
+
+		void setSerial(bool serial) { serial_ = serial; }
+		bool isSerial() const { return serial_ || workers_.empty(); }
+		void setProfileHook(JobProfileHook hook, void* context) {
+			profileHook_ = hook;
+			profileContext_ = context;
+		}
+
+		int getThreadCount() const { return static_cast<int>(workers_.size()) + 1; }
+		uint64_t getJobsRun() const { return jobsRun_.load(std::memory_order_relaxed); }
+		uint64_t getSteals() const { return steals_.load(std::memory_order_relaxed); }
+
+	private:
+		struct alignas(64) WorkQueue {
+				std::mutex mutex;
+				std::deque<Job> jobs;
+		};
+
+		void submit(const Job* jobs, int count);
+		bool tryRunOne(int worker);
+		bool popLocal(int worker, Job& job);
+		bool steal(int worker, Job& job);
+		void execute(const Job& job, int worker);
+		void finish(JobCounter* counter);
+		void workerLoop(int worker);
+		int currentWorker() const;
+
+		std::vector<std::thread> workers_;
+		std::vector<WorkQueue> queues_; // One per worker, then the shared queue for outsiders
+		std::atomic<int> queued_{0};
+		std::atomic<bool> running_{true};
+		std::mutex sleepMutex_;
+		std::condition_variable wake_;
+		std::thread::id owner_; // Worker 0
+
+		bool serial_ = false;
+		JobProfileHook profileHook_ = nullptr;
+		void* profileContext_ = nullptr;
+		std::atomic<uint64_t> jobsRun_{0};
+		std::atomic<uint64_t> steals_{0};
+};
+
+template <typename Fn>
+void JobSystem::parallelFor(const char* name, int count, int grain, Fn&& fn) {
+	using F = std::remove_reference_t<Fn>;
+	if (count <= 0)
+		return;
+	if (grain < 1)
+		grain = 1;
+	Job job;
+	job.fn = [](void* data, int begin, int end) { (*static_cast<F*>(data))(begin, end); };
+	job.data = const_cast<void*>(static_cast<const void*>(&fn));
+	job.name = name;
+	if (isSerial() || count <= grain) {
+		for (int begin = 0; begin < count; begin += grain) {
+			job.begin = begin;
+			job.end = begin + grain < count ? begin + grain : count;
+			execute(job, currentWorker());
+		}
+		return;
+	}
+	// Chunks go out in one batch; fn lives on this stack frame, which wait() keeps alive
+	JobCounter counter;
+	job.counter = &counter;
+	std::vector<Job> chunks;
+	chunks.reserve(chunkCount(count, grain));
+	for (int begin = 0; begin < count; begin += grain) {
+		job.begin = begin;
+		job.end = begin + grain < count ? begin + grain : count;
+		chunks.push_back(job);
+	}
+	counter.pending_.fetch_add(static_cast<int>(chunks.size()), std::memory_order_relaxed);
+	submit(chunks.data(), static_cast<int>(chunks.size()));
+	wait(counter);
+}
+
+template <typename T, typename Fn, typename Combine>
+T JobSystem::parallelReduce(const char* name, int count, int grain, T init, Fn&& fn, Combine&& combine) {
+	if (grain < 1)
+		grain = 1;
+	std::vector<T> partial(chunkCount(count, grain), init);
+	parallelFor(name, count, grain, [&](int begin, int end) { partial[begin / grain] = fn(begin, end); });
+	T result = init;
+	for (const T& value : partial)
+		result = combine(result, value);
+	return result;
+}
@@ -1,10 +1,16 @@
 #pragma once
+#include <atomic>
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <filesystem>
 #include <fstream>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 #include "debug.hpp"
 #include "tilemap.hpp"
+#include "levelloader.hpp"
 #include "texture.hpp"
 
 namespace fs = std::filesystem;
@@ -16,12 +22,24 @@ struct LevelMetaData {
 	std::string displayName;
 	glm::ivec2 dimensions; // First lines of tilemap file gives dims
 	// Levels sorted by filename
+
+	// Cached in the level index; a file whose size or mtime changed is read again
+	uintmax_t fileSize = 0;
+	int64_t modifiedTime = 0; // file_time_type ticks
+	uint64_t contentHash = 0; // FNV-1a of the whole file
+	int solidTiles = 0;
+	int checkpoints = 0;
+	int hazards = 0;
+	bool available = true; // False once a rescan finds the file gone; kept so indices stay put
 };
 
+const char* const LEVEL_INDEX_FILE = ".levelindex.json"; // In the levels directory
+
 class LevelManager {
 
 	public:
 		LevelManager(const std::string &levelsDir);
+		~LevelManager();
 
 		bool setLevelDir(const std::string &levelsDir);
 		// Level system follows 4 phase approach:
@@ -31,25 +49,43 @@ class LevelManager {
 		// 4. Load the selected level after confirmation (Load)
 
 		// Phase 1: Discovery
+		// Reads the whole file once: dimensions, hash and tile counts
 		bool extractMetadata(const fs::directory_entry& entry, LevelMetaData& metadata);
 		std::string generateDisplayName(const std::string& filename); // May be unused
-		bool loadLevelList(); // Iterates over directory structure, extracts metadata, and populates level options
+		// Starts a background scan: the level index file is read, the directory is checked
+		// against it, and only new or changed files are opened. The list fills in through
+		// pollLevelList(). Returns false when there's no levels directory.
+		bool loadLevelList();
+		// Applies scan results that came in since the last call; once a frame. Levels only
+		// ever get added or updated in place, so indices into the list stay valid.
+		void pollLevelList();
+		bool isScanning() const { return scanning_.load(std::memory_order_acquire); }
 
 		// Phase 2: Display (for UI)
 		std::vector<LevelMetaData>& getAvailableLevels(); // Returned vector is then given to UI engine to display levels
 
-		// Phase 3: Player makes selection (handled by ImGui)
-
-		// Phase 4: Load after confirmation, to be run after confirmation button is pressed
-		Tilemap loadLevel(int index); // Load level at specific index
+		// Phase 3: Player makes selection (handled by ImGui); LevelCache loads it
 
 		void clearLevelList();
-		void refreshLevelList();
+		void refreshLevelList(); // Background rescan, unless one is running
 
 		Texture* wallTex_;
 		Texture* floorTex_;
 		Texture* bgTex_;
 	private:
+		bool readIndex(std::vector<LevelMetaData>& levels) const;
+		bool writeIndex(const std::vector<LevelMetaData>& levels) const;
+		void startScan();
+		void scanLevels(std::vector<LevelMetaData> known); // Scanner thread
+
 		std::vector<LevelMetaData> availableLevels_;
+		std::unordered_map<std::string, size_t> levelSlots_; // filename -> availableLevels_ index
 		std::string levelsDir_;
+
+		// Background scan; results queue up in scanned_ until pollLevelList
+		std::thread scanner_;
+		std::atomic<bool> scanning_{false};
+		std::atomic<bool> stopScan_{false};
+		std::mutex scanMutex_;
+		std::vector<LevelMetaData> scanned_;
 };
\ No newline at end of file
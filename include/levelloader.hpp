@@ -0,0 +1,143 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "tilemap.hpp"
+#include "collisionspace.hpp"
+#include "tilemesh.hpp"
+#include "tileworld.hpp"
+#include "triggers.hpp"
+
+// Everything a level needs before play that can be prepared without GL or game state
+struct LoadedLevel {
+		Tilemap tilemap;
+		CollisionSpace playerSpace; // Synced against tilemap for the player's sensor layout
+		TileMesh mesh;				// CPU side only; upload() on the GL thread
+		// Set for a streamed (.tworld) level, which is played from this instead; tilemap is
+		// then an empty stand-in and the space and mesh are left empty
+		std::unique_ptr<TileWorld> world;
+		TriggerSystem triggers; // Streamed levels only: a pass over every chunk, kept for restarts
+
+		explicit LoadedLevel(Tilemap&& map) : tilemap(std::move(map)) {}
+		size_t getMemoryBytes() const {
+			return tilemap.getMemoryBytes() + playerSpace.getMemoryBytes() + mesh.getMemoryBytes() +
+				   (world ? world->getBudget() : 0);
+		}
+};
+
+enum class LoadStage { IDLE, PARSING, COLLISION, GEOMETRY, READY, FAILED };
+
+// Loads one level at a time on its own thread: parse the file, sync the player's collision
+// space, build the chunk geometry (a streamed level just opens and reads out its triggers).
+// The main thread polls getStage() each frame and, once it reads READY, take()s the result
+// and moves it into place.
+//
+// Each load is a job owning everything its thread writes. Cancelling flags the job and sets
+// it aside without waiting; every stage checks the flag between rows or chunks, and jobs
+// that have wound down are joined on the next start, cancel or take.
+class LevelLoader {
+
+	public:
+		~LevelLoader();
+
+		// Cancels any load in progress first
+		void start(const std::string& path, Texture* floorTex, Texture* wallTex, const SensorLayout& layout);
+		// Stops the load without waiting for its thread; the result, if any, is dropped
+		void cancel();
+		// Joins the cancelled jobs that have wound down; start, cancel and take do this too
+		void reap();
+		std::unique_ptr<LoadedLevel> take(); // nullptr unless READY; back to IDLE after
+
+		LoadStage getStage() const { return job_ ? job_->stage.load(std::memory_order_acquire) : LoadStage::IDLE; }
+		bool isBusy() const {
+			LoadStage stage = getStage();
+			return stage != LoadStage::IDLE && stage != LoadStage::READY && stage != LoadStage::FAILED;
+		}
+		float getProgress() const; // 0..1 over all stages
+		const std::string& getPath() const { return path_; }
+		const std::string& getError() const; // Valid once FAILED
+		int getWindingDown() const { return static_cast<int>(retired_.size()); } // Cancelled jobs not joined yet
+
+		static const char* stageName(LoadStage stage);
+
+	private:
+		struct Job {
+				std::thread thread;
+				std::atomic<LoadStage> stage{LoadStage::PARSING};
+				std::atomic<bool> done{false}; // Set after the thread's last access to the job
+				LoadProgress progress;
+				std::string path;
+				std::string error;					 // Written by the thread before FAILED
+				std::unique_ptr<LoadedLevel> result; // Written by the thread before READY
+		};
+		static void run(Job& job, Texture* floorTex, Texture* wallTex, SensorLayout layout);
+
+		std::unique_ptr<Job> job_;					// The current load; null when idle
+		std::vector<std::unique_ptr<Job>> retired_; // Cancelled, still winding down
+		std::string path_;							// Of the last started load
+};
+
+const size_t LEVEL_CACHE_BUDGET = 64u << 20; // Bytes of prepared levels kept around
+const int PREFETCH_SETTLE_FRAMES = 8;		 // Polls a highlighted level waits before it starts loading
+
+// Levels prepared ahead of time, keyed by file path. prefetch() starts loading a level the
+// player is likely to pick next (the highlighted one, the next one after a win) and take()
+// hands it over once they do. One LevelLoader does the work, so a new prefetch cancels
+// the one in flight; a level the player actually asked for is just a late prefetch. Finished levels
+// stay until taken, evicted, or pushed out least recently used first once over budget;
+// the newest one is kept even if it alone is over, since it was asked for last.
+class LevelCache {
+
+	public:
+		explicit LevelCache(size_t budgetBytes = LEVEL_CACHE_BUDGET) : budget_(budgetBytes) {}
+
+		// What every load uses: tile textures and the player's sensors for the collision space
+		void configure(Texture* floorTex, Texture* wallTex, const SensorLayout& playerLayout);
+
+		// No-op when path is cached, loading, or just failed to load
+		void prefetch(const std::string& path);
+		// prefetch(path) once frames more polls pass without another deferred prefetch
+		// replacing it, so scrolling through a list doesn't start a load per row
+		void prefetchSettled(const std::string& path, int frames = PREFETCH_SETTLE_FRAMES);
+		// Drops path from the cache, cancelling its load if it's the one in flight
+		void evict(const std::string& path);
+		void cancel(); // The load in flight, whatever it is, and any deferred prefetch
+		// Starts a deferred prefetch that has settled and moves a finished load into the
+		// cache; call once a frame
+		void poll();
+		std::unique_ptr<LoadedLevel> take(const std::string& path); // nullptr unless cached
+
+		bool isCached(const std::string& path) const { return find(path) != nullptr; }
+		bool isPending(const std::string& path) const { return !pending_.empty() && pending_ == path; } // Deferred, not started
+		bool isLoading(const std::string& path) const { return loader_.isBusy() && loader_.getPath() == path; }
+		bool hasFailed(const std::string& path) const {
+			return loader_.getStage() == LoadStage::FAILED && loader_.getPath() == path;
+		}
+		const LevelLoader& getLoader() const { return loader_; }
+
+		int getCount() const { return static_cast<int>(entries_.size()); }
+		size_t getUsedBytes() const;
+		size_t getBudget() const { return budget_; }
+
+	private:
+		struct Entry {
+				std::string path;
+				std::unique_ptr<LoadedLevel> level;
+				size_t bytes;
+				unsigned long lastUse;
+		};
+		const Entry* find(const std::string& path) const;
+		void trim(const std::string& keep);
+
+		LevelLoader loader_;
+		std::vector<Entry> entries_; // A handful at most, so searched linearly
+		size_t budget_;
+		unsigned long useClock_ = 0;
+		std::string pending_; // Deferred prefetch, empty if none
+		int pendingFrames_ = 0;
+		Texture* floorTex_ = nullptr;
+		Texture* wallTex_ = nullptr;
+		SensorLayout layout_;
+};
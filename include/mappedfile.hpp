@@ -0,0 +1,29 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// A whole file mapped into memory copy-on-write: reads come straight from the page cache and
+// only pages that are actually touched get read in. Writes land in private copies of the
+// pages and never reach the file.
+class MappedFile {
+
+	public:
+		MappedFile() = default;
+		~MappedFile() { close(); }
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		bool open(const std::string& path); // Closes any previous mapping first
+		void close();
+		// Hands the pages covering [offset, offset + bytes) back to the kernel; they're read
+		// from the file again if touched. Private writes to them are lost.
+		void discard(size_t offset, size_t bytes);
+
+		uint8_t* getData() const { return data_; }
+		size_t getSize() const { return size_; }
+
+	private:
+		uint8_t* data_ = nullptr;
+		size_t size_ = 0;
+};
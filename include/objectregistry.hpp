@@ -0,0 +1,67 @@
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "gameobject.hpp"
+#include "tags.hpp"
+
+// Handle to a GameObject: a slot in the registry plus the generation the slot had when the
+// object was registered. Unlike an index into the object vector it survives other objects
+// being removed, and it stops resolving once its own object is gone.
+struct ObjectHandle {
+		uint32_t index = UINT32_MAX;
+		uint32_t generation = 0;
+
+		bool operator==(const ObjectHandle& other) const { return index == other.index && generation == other.generation; }
+		bool operator!=(const ObjectHandle& other) const { return !(*this == other); }
+};
+
+// Hands out handles for the game's object vector and keeps a handle list per name tag, so
+// "find the death wall" is one hash of an integer instead of a string compare per object.
+// Tags are taken when an object is registered; renaming an object afterwards isn't tracked.
+class ObjectRegistry {
+
+	public:
+		// Registers every object appended since the last sync
+		void sync(const std::vector<GameObject>& objects);
+		void clear();
+		// Swap-removes the object from the vector. Its handle (and copies of it) stop
+		// resolving; the object moved into its place keeps its handle. Anything that stores
+		// object indices rather than handles (ActivitySet) needs rebuilding afterwards.
+		void remove(std::vector<GameObject>& objects, ObjectHandle handle);
+
+		bool isValid(ObjectHandle handle) const {
+			return handle.index < slots_.size() && slots_[handle.index].generation == handle.generation &&
+				   slots_[handle.index].object >= 0;
+		}
+		// Current index in the object vector, -1 if the handle is stale
+		int indexOf(ObjectHandle handle) const { return isValid(handle) ? slots_[handle.index].object : -1; }
+		GameObject* resolve(std::vector<GameObject>& objects, ObjectHandle handle) const {
+			int index = indexOf(handle);
+			return index >= 0 ? &objects[index] : nullptr;
+		}
+		ObjectHandle handleAt(int index) const {
+			return index >= 0 && index < static_cast<int>(handles_.size()) ? handles_[index] : ObjectHandle();
+		}
+
+		const std::vector<ObjectHandle>& withTag(TagId tag) const;
+		ObjectHandle findFirst(TagId tag) const {
+			const std::vector<ObjectHandle>& tagged = withTag(tag);
+			return tagged.empty() ? ObjectHandle() : tagged.front();
+		}
+
+		size_t getCount() const { return handles_.size(); }
+		size_t getSlotCount() const { return slots_.size(); }
+
+	private:
+		struct Slot {
+				uint32_t generation = 0;
+				int object = -1; // Index in the object vector, -1 while free
+		};
+
+		std::vector<Slot> slots_;
+		std::vector<uint32_t> freeSlots_;
+		std::vector<ObjectHandle> handles_; // By object index
+		std::vector<TagId> tags_;			// By object index, as registered
+		std::unordered_map<TagId, std::vector<ObjectHandle>> tagged_;
+};
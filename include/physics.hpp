@@ -8,6 +8,14 @@
 #include "playerobject.hpp"
 #include "behavior.hpp"
 #include "tilemap.hpp"
+#include "collisionspace.hpp"
+#include "tilecollider.hpp"
+#include "activity.hpp"
+#include "behaviorpool.hpp"
+#include "platforms.hpp"
+#include "events.hpp"
+#include "jobs.hpp"
+#include "triggers.hpp"
 #include "debug.hpp"
 
 const float gravity = -8.0f;
@@ -18,13 +26,90 @@ const float slowdownAccel = 25.0f; // Acceleration applied when slowing down
 const float turnaroundAccel = 50.0f;
 const float midairDrag = 5.0f;
 
+// Adaptive sub-stepping: a step is split so no sub-step moves a body further than this
+// fraction of a tile, which keeps sensors from skipping past or deep into solid tiles
+const float SUBSTEP_FRACTION = 0.5f;
+const int MAX_SUBSTEPS = 8;
+const int TILE_BODY_GRAIN = 64; // Tile bodies per job
+
+struct PhysicsStats {
+		int playerSubsteps = 1;		// Sub-steps the player took last step
+		long playerCappedSteps = 0; // Player steps that wanted more than MAX_SUBSTEPS (running total)
+		int bodySubsteps = 0;		// Sub-steps across all tile bodies last step
+		int maxBodySubsteps = 0;
+		int cappedBodies = 0; // Tile bodies clamped to MAX_SUBSTEPS last step
+};
+
 class Physics {
 
 	public:
+		// Full player step: movement + world collisions, sub-stepped when the projected
+		// displacement is large and the path isn't known to be free. With platforms, the
+		// player is first carried by the one it rides and lands on platform tops afterwards.
+		// Grid is the level: a Tilemap, or a TileWorld for a streamed one.
+		template <typename Grid>
+		void stepPlayer(PlayerObject& player, const Grid& tilemap, float deltaTime, PlatformSystem* platforms = nullptr);
 		void playerMovementStep(PlayerObject& player, float deltaTime);
-		void checkPlayerWorldCollisions(PlayerObject& player, Tilemap& tilemap);
-		void checkPlayerDeathWallCollision(PlayerObject& player, GameObject& deathWall);
-		void checkPlayerEntityCollisions(GameObject& obj, const std::vector<GameObject>& entities);
+		template <typename Grid>
+		void checkPlayerWorldCollisions(PlayerObject& player, const Grid& tilemap);
+		// Updates the triggers around the player and publishes goal, checkpoint, kill and
+		// enter/exit events
+		void checkPlayerTriggers(PlayerObject& player, TriggerSystem& triggers);
+		// Tests the player against the awake objects only, with the boxes from activity's
+		// last update; sleeping ones are never touched
+		void checkPlayerEntityCollisions(PlayerObject& player, std::vector<GameObject>& entities, const ActivitySet& activity,
+										 BehaviorPools& behaviors);
+
+		// Gravity + integration + tile resolution for non-player walkers. Built for both
+		// float and fixed-point bodies; the game uses TileCollider (the build's PhysVec2).
+		// space culls sub-steps and sensor tests; it's only used if it was synced with the
+		// layout of the bodies, which must all share one.
+		template <typename Vec>
+		void stepTileBodies(std::vector<BasicTileCollider<Vec>>& bodies, const Tilemap& tilemap, float deltaTime,
+							const CollisionSpace* space = nullptr);
+
+		// Where collision outcomes (deaths, goals, checkpoints) are published. Without a
+		// bus they're dropped.
+		void setEventBus(GameEvents* events) { events_ = events; }
+		// Spreads tile bodies and collision space rebuilds over the workers. Without one
+		// everything runs on the calling thread.
+		void setJobSystem(JobSystem* jobs) {
+			jobs_ = jobs;
+			playerSpace_.setJobSystem(jobs);
+		}
+
+		const CollisionSpace& getPlayerSpace() const { return playerSpace_; }
+		// Takes a player space already synced off-thread (e.g. by the level loader), so the
+		// first step on a new level doesn't pay for the full rebuild
+		void setPlayerSpace(CollisionSpace&& space) {
+			playerSpace_ = std::move(space);
+			playerSpace_.setJobSystem(jobs_);
+		}
+		const PhysicsStats& getStats() const { return stats_; }
 
 		float deltaTime = 0.0f;
+
+	private:
+		PhysVec2 playerPosition(const PlayerObject& player);
+		void settlePlayerOnPlatforms(PlayerObject& player, PlatformSystem& platforms, float prevBottom);
+		void setPlayerPosition(PlayerObject& player, const PhysVec2& position);
+		// The player space synced with the level, or null for a streamed one: that is never
+		// all in memory to build the space from, so the player goes without
+		const CollisionSpace* playerSpaceFor(const Tilemap& tilemap, const SensorLayout& layout);
+		const CollisionSpace* playerSpaceFor(const TileWorld&, const SensorLayout&) { return nullptr; }
+		template <typename E>
+		void publish(const E& event) {
+			if (events_)
+				events_->publish(event);
+		}
+
+		CollisionSpace playerSpace_; // Tilemap dilated by the player's sensor layout
+		// Authoritative player position in physics precision; the GameObject holds a float copy
+		PhysVec2 playerPos_;
+		glm::vec2 playerPosShown_ = glm::vec2(0.0f);
+		bool playerPosValid_ = false;
+		PhysicsStats stats_;
+		std::vector<int> touched_; // Scratch, active slots overlapping the player
+		GameEvents* events_ = nullptr;
+		JobSystem* jobs_ = nullptr;
 };
\ No newline at end of file
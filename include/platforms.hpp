@@ -0,0 +1,66 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+#include "gameobject.hpp"
+#include "spatialhash.hpp"
+#include "tilemap.hpp"
+#include "globals.hpp"
+
+const float PLATFORM_SPEED = 2.0f;	   // World units per second along the path
+const float PLATFORM_THICKNESS = 0.25f; // Fraction of a tile
+// World units above a platform top that still count as standing on it, and below it that a
+// rider can end a step at and still be lifted back on
+const float PLATFORM_SNAP = 0.05f;
+const float PLATFORM_SINK = 0.25f;
+
+// Kinematic moving platforms with one-way (jump-through) tops. Platforms are listed in a
+// hashed grid whose entries are only touched when a platform crosses a cell boundary, and
+// each rider remembers the platform it stands on, so carrying costs one lookup per rider
+// and landing only tests the platforms in the cells under a body's feet.
+class PlatformSystem {
+
+	public:
+		static const int PLAYER_RIDER = 0; // Rider id of the player; other bodies use their own ids
+
+		// Replaces all platforms with the tilemap's spawns, back at their start positions
+		void load(const Tilemap& tilemap) { load(tilemap.getPlatformSpawns(), tilemap.getTileSize()); }
+		void load(const std::vector<PlatformSpawn>& spawns, float tileSize);
+		int add(const glm::vec2& position, const glm::vec2& size, const glm::vec2& travel, float speed);
+		void clear();
+
+		// Moves every platform along its path
+		void step(float deltaTime);
+
+		// How far the rider's platform moved in the last step, zero if it isn't riding one
+		glm::vec2 carry(int rider) const {
+			int platform = rider < static_cast<int>(riderPlatform_.size()) ? riderPlatform_[rider] : -1;
+			return platform >= 0 ? state_[platform].delta : glm::vec2(0.0f);
+		}
+		// Call after the rider's own physics step. box is its AABB now and prevBottom the bottom
+		// of its AABB before the step. Returns true if it stands on a platform top, with lift
+		// set to how far it has to move up to rest on it.
+		bool settle(int rider, const AABB& box, float prevBottom, float velocityY, float& lift);
+		void detach(int rider);
+
+		const std::vector<GameObject>& getObjects() const { return objects_; }
+		int getCount() const { return static_cast<int>(objects_.size()); }
+		int getRiddenCount() const { return riddenCount_; } // Platforms carrying at least one rider
+
+	private:
+		struct PlatformState {
+				glm::vec2 delta = glm::vec2(0.0f); // Movement in the last step
+				glm::ivec4 cells;				   // Grid cell range (x0, y0, x1, y1) it is listed in
+				int riders = 0;
+		};
+
+		void attach(int rider, int platform);
+		void list(int platform);
+		void unlist(int platform);
+
+		std::vector<GameObject> objects_; // Rendered like any other object
+		std::vector<PlatformState> state_;
+		std::vector<int> riderPlatform_; // Contact cache: platform each rider stands on, -1 if none
+		SpatialHash<int, 1024> grid_{4.0f * TILE_SIZE};
+		int riddenCount_ = 0;
+};
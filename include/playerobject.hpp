@@ -3,6 +3,7 @@
 #include <string>
 #include "gameobject.hpp"
 #include "tilemap.hpp"
+#include "tilecollider.hpp"
 #include "globals.hpp"
 #include "texture.hpp"
 struct Sensor {
@@ -51,24 +52,19 @@ class PlayerObject : public GameObject {
 		void setSensorScale(float horizScale, float vertScale);
 		void sensorUpdate();
 
-		void setGoalCount(int count) { goalCount_ = count; }
-		void setInGoal(bool status) { inGoal_ = status; }
-		void setShouldDie(bool status) { shouldDie_ = status; }
-		void incrementGoalCount() { goalCount_++; }
-
 		bool tileCollision(Tilemap& tilemap, const Sensor& sensor);
-		bool tileGoalCollision(Tilemap& tilemap, const Sensor& sensor);
 
 		const glm::ivec2 getPlayerTileIdx(Tilemap& tilemap) const;
-		int getGoalCount() const { return goalCount_; }
 
 		const Sensor& getLeftSensor() const { return leftSensor_; }
 		const Sensor& getRightSensor() const { return rightSensor_; }
 		const Sensor& getTopSensor() const { return topSensor_; }
 		const Sensor& getBottomSensor() const { return bottomSensor_; }
-
-		bool checkIfInGoal() { return inGoal_; }
-		bool getShouldDie() const { return shouldDie_; }
+		// Offset of the left/right (x) and top/bottom (y) sensors from the player's centre
+		glm::vec2 getSensorExtents() const {
+			return glm::vec2(getScale().x * horizSensorScale_ / 2.0f + EPSILON, getScale().y * vertSensorScale_ / 2.0f + EPSILON);
+		}
+		SensorLayout getSensorLayout() const { return SensorLayout::centred(getSensorExtents()); }
 
 		int loadSpriteAtlas(const std::string& atlasDataPath);
 
@@ -114,9 +110,5 @@ class PlayerObject : public GameObject {
 		Sensor topSensor_;	  // Top sensor for detecting ceilings
 		Sensor bottomSensor_; // Bottom sensor for detecting floors
 
-		int goalCount_ = 0; // Counter for the number of sensors that detect a goal tile
-		bool inGoal_ = false;
-		bool shouldDie_ = false; // Processed during player update
-
 		SpriteAtlas spriteAtlas_;
 };
\ No newline at end of file
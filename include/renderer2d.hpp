@@ -8,16 +8,33 @@
 #include <string>
 #include "shader.hpp"
 #include "globals.hpp"
+#include "transform2d.hpp"
 
 // Forward declaration to avoid circular include with texture.hpp
 class Texture;
 
 struct BatchVertex {
-		glm::vec2 position;
+		glm::vec2 position; // Already in world space
 		glm::vec4 color;
 		// Once textures are implemented, will include UV coords
 };
 
+// Vertex of prebuilt static geometry (tile chunks): textured ranges sample uv, plain ones
+// use color
+struct StaticVertex {
+		glm::vec2 position; // World space
+		glm::vec2 uv;
+		glm::vec4 color;
+};
+
+// GPU copy of a block of quads that doesn't change from frame to frame. Quads share the
+// batch index buffer, so one buffer holds at most Renderer2D::MAX_STATIC_QUADS.
+struct StaticQuads {
+		GLuint vao = 0;
+		GLuint vbo = 0;
+		uint32_t quads = 0;
+};
+
 class Renderer2D {
 
 	public:
@@ -28,27 +45,46 @@ class Renderer2D {
 		void shutdown();
 		void beginScene(Shader& shader, const glm::mat4& view, const glm::mat4& proj); // Runs at start of frame before drawing
 		void drawQuad(Shader& shader, const glm::mat4& transform, const glm::vec4& color);
+		void drawQuad(Shader& shader, const Transform2D& transform, const glm::vec4& color);
 		// Draw a textured quad (binds texture unit 0 and sets useTexture=1)
 		void drawTexturedQuad(Shader& shader, const glm::mat4& transform, const glm::vec4& color, Texture *texture);
+		void drawTexturedQuad(Shader& shader, const Transform2D& transform, const glm::vec4& color, Texture* texture);
 		// Player-specific: dynamic VBO for per-frame UV updates
 		void setPlayerUVRect(const glm::vec2& uvMin, const glm::vec2& uvMax, float yOffset = 0.0f);
-		void drawPlayer(Shader& shader, const glm::mat4& transform, const glm::vec4& color, Texture* texture);
+		void drawPlayer(Shader& shader, const Transform2D& transform, const glm::vec4& color, Texture* texture);
 		void drawLine(Shader& shader, const glm::vec2& start, const glm::vec2& end, const glm::vec4& color);
 		void endScene(); // Runs at end of frame after drawing
 		// Doesn't really do anything now, as I'm using immediate rendering
 
-		void flushBatch();
-		void addQuadtoBatch(const glm::mat4 transform, const glm::vec4& color);
+		// Untextured quads collected into one vertex buffer and drawn with a single call.
+		// Batched quads land when the batch is flushed, so flush before drawing anything
+		// that has to go on top of them.
+		void addQuadtoBatch(Shader& shader, const Transform2D& transform, const glm::vec4& color);
+		void flushBatch(Shader& shader);
+
+		// Static quads: upload once (4 vertices per quad), then draw any run of them with one
+		// call. texture nullptr draws with the vertex colors. Release before shutdown().
+		bool uploadStaticQuads(StaticQuads& quads, const StaticVertex* vertices, uint32_t quadCount);
+		void drawStaticQuads(Shader& shader, const StaticQuads& quads, uint32_t first, uint32_t count, Texture* texture);
+		void releaseStaticQuads(StaticQuads& quads);
+
+		static const uint32_t MAX_STATIC_QUADS = 10000;
 
 	private:
 		static const uint32_t MAX_QUADS = 10000;
 		static const uint32_t MAX_VERTICES = MAX_QUADS * 4;
 		static const uint32_t MAX_INDICES = MAX_QUADS * 6;
 
+		void drawWithMVP(Shader& shader, const glm::mat4& mvp, const glm::vec4& color, Texture* texture);
+		bool initBatch();
+
 		std::vector<BatchVertex> batchVertices_;
 		std::vector<uint32_t> batchIndices_;
 		uint32_t vertexCount_ = 0; // Number of vertices currently in use
 		uint32_t indexCount_ = 0;  // Number of indices currently in use
+		GLuint batchVAO_ = 0;
+		GLuint batchVBO_ = 0;
+		GLuint batchEBO_ = 0;
 
 		GLuint shader_ = 0;
 		GLuint vao_;
@@ -65,6 +101,7 @@ class Renderer2D {
 		glm::mat4 model_;
 		glm::mat4 view_;
 		glm::mat4 proj_;
+		glm::mat4 viewProj_; // proj_ * view_, once per scene instead of once per quad
 
 		bool shaderLoaded_ = false;
 };
@@ -0,0 +1,118 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "gameobject.hpp"
+#include "objectregistry.hpp"
+#include "transform2d.hpp"
+#include "jobs.hpp"
+
+using SceneNode = uint32_t; // Stable id; stays valid until the node is destroyed
+const SceneNode NO_NODE = UINT32_MAX;
+const int SCENE_PARALLEL_MIN = 4096; // Nodes to recompute before update() hands out jobs
+
+// Parent/child transform hierarchy. Nodes are kept in depth-first order in flat arrays, so
+// every parent comes before its children and a subtree is one contiguous range. update()
+// only recomputes the ranges under nodes whose local transform changed, each in one
+// forward pass. Structural changes (create, destroy, reparent) shift the arrays; they're
+// meant for level setup, not every frame.
+//
+// The graph only knows Transform2Ds. GameObjects hook in through bindings (below); other
+// stores can read world transforms through eachChanged.
+class SceneGraph {
+
+	public:
+		SceneNode create(const Transform2D& local = Transform2D(), SceneNode parent = NO_NODE);
+		void destroy(SceneNode node); // Destroys its whole subtree
+		// Keeps the local transform, so the node moves with its new parent. Refuses to put a
+		// node under its own descendant.
+		bool setParent(SceneNode node, SceneNode parent);
+		void clear();
+
+		void setLocal(SceneNode node, const Transform2D& local);
+		const Transform2D& getLocal(SceneNode node) const { return local_[indexOf_[node]]; }
+		// As of the last update()
+		const Transform2D& getWorld(SceneNode node) const { return world_[indexOf_[node]]; }
+		SceneNode getParent(SceneNode node) const {
+			int parent = parent_[indexOf_[node]];
+			return parent >= 0 ? ids_[parent] : NO_NODE;
+		}
+		bool contains(SceneNode node) const { return node < indexOf_.size() && indexOf_[node] >= 0; }
+
+		// Recomputes world transforms under every node changed since the last update
+		void update();
+		// Changed subtrees are disjoint, so with a job system large updates are split
+		// between workers by subtree
+		void setJobSystem(JobSystem* jobs) { jobs_ = jobs; }
+		// fn(SceneNode, const Transform2D& world) for each node whose world transform the last
+		// update() recomputed, parents before children
+		template <typename Fn>
+		void eachChanged(Fn&& fn) const;
+
+		// GameObject bindings. A driver's local transform is read from its object before the
+		// update (only when the object's transform version moved); it takes position and
+		// rotation but not scale, so children aren't stretched by their parent's size. A
+		// follower's object gets its position/rotation/scale from the node's world transform
+		// after the update.
+		void bindDriver(SceneNode node, ObjectHandle object);
+		void bindFollower(SceneNode node, ObjectHandle object);
+		void pullDrivers(const std::vector<GameObject>& objects, const ObjectRegistry& registry);
+		void pushFollowers(std::vector<GameObject>& objects, const ObjectRegistry& registry) const;
+
+		size_t size() const { return ids_.size(); }
+		int getUpdatedCount() const { return updatedCount_; } // Nodes recomputed by the last update
+
+	private:
+		struct Range {
+				int begin, end;
+		};
+		struct Binding {
+				SceneNode node;
+				ObjectHandle object;
+				uint32_t version; // Driver: object transform version last read
+		};
+
+		// A run of nodes lifted out of the arrays, parents relative to the first node
+		struct Block {
+				std::vector<SceneNode> ids;
+				std::vector<int> parent;
+				std::vector<int> subtree;
+				std::vector<Transform2D> local;
+				std::vector<Transform2D> world;
+				std::vector<uint8_t> dirty;
+		};
+
+		Block takeBlock(int begin);				 // Removes the subtree at begin
+		void insertBlock(Block& block, int parent); // As the last child of parent (-1: root)
+		void markDirty(int index);
+		void reindex(int from);
+
+		// By depth-first position
+		std::vector<SceneNode> ids_;
+		std::vector<int> parent_;  // Position of the parent, -1 for roots
+		std::vector<int> subtree_; // Size of the subtree rooted here, including itself
+		std::vector<Transform2D> local_;
+		std::vector<Transform2D> world_;
+		std::vector<uint8_t> dirty_;
+		std::vector<uint32_t> updatedAt_; // Value of updates_ when last recomputed
+
+		std::vector<int> indexOf_; // By node id, -1 once destroyed
+		std::vector<SceneNode> freeIds_;
+		std::vector<SceneNode> dirtyNodes_; // Changed since the last update
+		std::vector<Range> changed_;		 // Ranges the last update recomputed
+		std::vector<int> scratch_;
+		int updatedCount_ = 0;
+		uint32_t updates_ = 1; // Starts past updatedAt_'s initial 0
+
+		std::vector<Binding> drivers_;
+		std::vector<Binding> followers_;
+		JobSystem* jobs_ = nullptr;
+};
+
+template <typename Fn>
+void SceneGraph::eachChanged(Fn&& fn) const {
+	for (const Range& range : changed_) {
+		for (int i = range.begin; i < range.end; ++i) {
+			fn(ids_[i], world_[i]);
+		}
+	}
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <atomic>
+#include <functional>
+#include <thread>
+
+// Runs a step function on its own thread at a fixed rate, independent of the render loop
+// and its vsync. step(seconds) returns false to end the thread by itself; stop() ends it
+// from outside and waits for the current step to finish.
+class SimulationThread {
+
+	public:
+		~SimulationThread() { stop(); }
+
+		void start(float stepSeconds, std::function<bool(float)> step);
+		void stop();
+		// False once the step function returned false, even before stop() joins
+		bool isRunning() const { return running_.load(std::memory_order_acquire); }
+		bool isStarted() const { return thread_.joinable(); }
+		unsigned long getSteps() const { return steps_.load(std::memory_order_relaxed); }
+
+	private:
+		void run();
+
+		std::thread thread_;
+		std::function<bool(float)> step_;
+		float stepSeconds_ = 0.0f;
+		std::atomic<bool> running_{false};
+		std::atomic<unsigned long> steps_{0};
+};
@@ -0,0 +1,81 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "gameobject.hpp"
+
+// Uniform grid of cellSize world units hashed into a fixed table of Buckets buckets
+// (a power of two). An entry is listed in every cell its AABB covers, so the caller
+// keeps the cell range it was inserted with to remove it again. Unrelated cells that
+// share a bucket come back from queries too; callers filter with an exact AABB test.
+template <typename Entry, int Buckets>
+class SpatialHash {
+
+	public:
+		explicit SpatialHash(float cellSize) : cellSize_(cellSize) {}
+
+		// Inclusive cell range (x0, y0, x1, y1) covered by box
+		glm::ivec4 cellRange(const AABB& box) const {
+			return glm::ivec4(static_cast<int>(std::floor(box.left / cellSize_)), static_cast<int>(std::floor(box.bottom / cellSize_)),
+							  static_cast<int>(std::floor(box.right / cellSize_)), static_cast<int>(std::floor(box.top / cellSize_)));
+		}
+
+		void insert(const glm::ivec4& cells, const Entry& entry) {
+			for (int y = cells.y; y <= cells.w; ++y) {
+				for (int x = cells.x; x <= cells.z; ++x) {
+					buckets_[bucketIndex(x, y)].push_back(entry);
+				}
+			}
+		}
+
+		// Removes the entries matching pred from the buckets of cells, keeping the order of the rest
+		template <typename Pred>
+		void remove(const glm::ivec4& cells, Pred pred) {
+			for (int y = cells.y; y <= cells.w; ++y) {
+				for (int x = cells.x; x <= cells.z; ++x) {
+					auto& bucket = buckets_[bucketIndex(x, y)];
+					bucket.erase(std::remove_if(bucket.begin(), bucket.end(), pred), bucket.end());
+				}
+			}
+		}
+
+		// Calls fn on every entry in the buckets of cells; an entry spanning several cells
+		// is visited once per cell
+		template <typename Fn>
+		void forEach(const glm::ivec4& cells, Fn&& fn) const {
+			forEachBucket(cells, [&](size_t, const std::vector<Entry>& entries) {
+				for (const Entry& entry : entries) {
+					fn(entry);
+				}
+			});
+		}
+
+		// Calls fn(bucket, entries) for the bucket of each cell, in the order insert fills
+		// them. Buckets are numbered 0..Buckets-1, so a caller can keep per-bucket data of
+		// its own that lines up with the entries.
+		template <typename Fn>
+		void forEachBucket(const glm::ivec4& cells, Fn&& fn) const {
+			for (int y = cells.y; y <= cells.w; ++y) {
+				for (int x = cells.x; x <= cells.z; ++x) {
+					size_t bucket = bucketIndex(x, y);
+					fn(bucket, buckets_[bucket]);
+				}
+			}
+		}
+
+		void clear() {
+			for (auto& bucket : buckets_)
+				bucket.clear();
+		}
+
+	private:
+		static_assert((Buckets & (Buckets - 1)) == 0, "Buckets must be a power of two");
+		static size_t bucketIndex(int x, int y) {
+			return (static_cast<uint32_t>(x) * 73856093u ^ static_cast<uint32_t>(y) * 19349663u) & (Buckets - 1);
+		}
+
+		std::vector<std::vector<Entry>> buckets_ = std::vector<std::vector<Entry>>(Buckets);
+		float cellSize_; // World units per grid cell
+};
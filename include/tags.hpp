@@ -0,0 +1,13 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+// Interned names: each distinct string gets a small integer id once, so name checks on
+// hot paths are integer compares and tag lookups hash an int, not a string
+using TagId = uint32_t;
+const TagId NO_TAG = 0; // The empty string
+
+TagId internTag(const std::string& name);
+// Id of an already interned name, or NO_TAG if it was never interned (doesn't add it)
+TagId findTag(const std::string& name);
+const std::string& tagName(TagId tag);
@@ -0,0 +1,69 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+#include "tilemap.hpp"
+#include "fixed.hpp"
+
+class CollisionSpace;
+class TileWorld;
+
+// Where a collider's point sensors sit relative to its centre. Left/right sensors are
+// at +/- extents.x, one per entry in sideOffsets (vertical offsets); top/bottom sensors
+// are at +/- extents.y, one per entry in footOffsets (horizontal offsets).
+struct SensorLayout {
+		static const int MAX_SENSORS_PER_SIDE = 4;
+
+		glm::vec2 extents = glm::vec2(0.5f);
+		int sideCount = 1;
+		float sideOffsets[MAX_SENSORS_PER_SIDE] = {0.0f};
+		int footCount = 1;
+		float footOffsets[MAX_SENSORS_PER_SIDE] = {0.0f};
+		float groundSnapDist = 0.02f; // How far below the feet still counts as standing
+
+		// One sensor in the middle of each side, the player's layout
+		static SensorLayout centred(const glm::vec2& extents) {
+			SensorLayout layout;
+			layout.extents = extents;
+			return layout;
+		}
+
+		bool operator==(const SensorLayout& other) const;
+		bool operator!=(const SensorLayout& other) const { return !(*this == other); }
+};
+
+// Which sensors were resolved against the tilemap during the last step
+enum TileContact : uint8_t {
+	CONTACT_LEFT = 1 << 0,
+	CONTACT_RIGHT = 1 << 1,
+	CONTACT_TOP = 1 << 2,
+	CONTACT_BOTTOM = 1 << 3,
+};
+
+// Tile physics component: anything with a position, velocity and sensor layout can be
+// resolved against the tilemap the same way the player is. Vec is glm::vec2 or FixedVec2;
+// TileCollider uses whichever the build selected for physics.
+template <typename Vec>
+struct BasicTileCollider {
+		SensorLayout layout;
+		Vec position = fromFloatVec<Vec>(glm::vec2(0.0f));
+		Vec velocity = fromFloatVec<Vec>(glm::vec2(0.0f));
+
+		uint8_t contacts = 0; // TileContact bits set by the last resolve
+		bool grounded = false;
+};
+using TileCollider = BasicTileCollider<PhysVec2>;
+
+// Pushes the collider out of solid tiles (sides gated by the direction of travel, then
+// top, then bottom) and updates grounded with a short probe below the feet. Sensors that
+// hit zero the velocity along their axis. If space is non-null it must have been synced
+// with the collider's layout; a free cell then skips every sensor test except the ground probe.
+// Grid is a Tilemap or, for the player in a streamed level, a TileWorld (no c-space there).
+template <typename Grid, typename Vec>
+void resolveTileCollider(const Grid& tilemap, BasicTileCollider<Vec>& collider, const CollisionSpace* space = nullptr);
+
+// Resolves every collider in one pass over the array. The colliders must share one layout;
+// space is only used if it was synced with it
+template <typename Vec>
+void resolveTileColliders(const Tilemap& tilemap, std::vector<BasicTileCollider<Vec>>& colliders,
+						  const CollisionSpace* space = nullptr);
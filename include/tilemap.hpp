@@ -1,5 +1,9 @@
 #pragma once
 #include <glm/glm.hpp>
+#include <cstdint>
+#include <atomic>
+#include <array>
+#include <memory>
 #include <vector>
 #include <iostream>
 #include <fstream>
@@ -8,9 +12,11 @@
 #include "renderer2d.hpp"
 #include "color.hpp"
 #include "texture.hpp"
+#include "gameobject.hpp"
+#include "mappedfile.hpp"
 
 // Define Tile type enum
-enum class TileEnum { EMPTY, SOLID, PLAYER, DWALLSTART, DWALLEND, GOAL };
+enum class TileEnum { EMPTY, SOLID, PLAYER, DWALLSTART, DWALLEND, GOAL, HAZARD, CHECKPOINT, KILLZONE };
 
 struct TileType {
 		TileEnum type; // Type of the tile (e.g., EMPTY, SOLID)
@@ -25,25 +31,141 @@ struct Tile {
 		Texture* texture = nullptr; // Pointer to the texture used for rendering the tile
 };
 
+// Which of the map's textures a tile is drawn with, see Tilemap::setTextures
+enum class TileSkin : uint8_t { NONE, FLOOR, WALL };
+
+// Whether a tile of this type goes into the solid collision mask
+inline bool isSolidType(const TileType& tileType) { return tileType.type == TileEnum::SOLID || tileType.solid; }
+
+// One distinct kind of tile. The map stores a byte per tile indexing its palette of these.
+struct TilePaletteEntry {
+		TileType tileType;
+		TileSkin skin;
+};
+
+// Result of a raycast/boxcast against solid tiles
+struct TileHit {
+		bool hit = false;
+		glm::ivec2 tile = glm::ivec2(-1);	// Index of the solid tile that was hit
+		glm::vec2 normal = glm::vec2(0.0f); // Face normal at the contact, zero if the cast started inside a solid tile
+		float distance = 0.0f;				// World distance travelled before contact
+};
+
+struct TileRay {
+		glm::vec2 origin;
+		glm::vec2 dir; // Need not be normalized
+		float maxDist;
+};
+
+// Solid tiles merged into a maximal rectangle, inclusive tile bounds
+struct CollisionRect {
+		int x0, y0, x1, y1;
+};
+
+// A moving platform read from the level file: a run of '=' tiles that travels back and
+// forth over the '~' tiles next to it
+struct PlatformSpawn {
+		glm::ivec2 tile;	// Leftmost tile of the run
+		int width;			// Run length in tiles
+		glm::ivec2 travel;	// Tiles travelled from the spawn before turning back
+};
+
+// Per-tile exposed-edge bits: set when the neighbour across that face is not solid.
+// Faces shared by two solid tiles are internal and never need collision response.
+enum TileEdge : uint8_t { EDGE_LEFT = 1, EDGE_RIGHT = 2, EDGE_BOTTOM = 4, EDGE_TOP = 8 };
+
 class Tilemap {
 
 	public:
+		static constexpr int MAX_PALETTE = 256;
+
 		Tilemap(int width, int height, float tileSize);
+		// Views the grids laid out at offset in a mapped compiled level (see compiledlevel.hpp)
+		// instead of allocating them. Writes go to private copies of the touched pages.
+		Tilemap(int width, int height, float tileSize, std::unique_ptr<MappedFile> file, size_t offset,
+				const std::vector<TilePaletteEntry>& palette, std::vector<CollisionRect> collisionRects);
+		Tilemap(Tilemap&&) = default;
+		Tilemap& operator=(Tilemap&&) = default;
 
-		Tile& getTile(int x, int y);
+		// Built from the tile's palette entry; position and texture filled in
+		Tile getTile(int x, int y) const;
+		TileEnum getTileType(int x, int y) const { return palette_[tileAt(x, y)].tileType.type; }
 		glm::ivec2 getInitPlayerPos() { return playerPos_; }
-		glm::ivec2 getGoalPos() { return goalPos_; }
-		bool isSolidTile(int x, int y);
-		bool isGoalTile(int x, int y);
+		glm::ivec2 getGoalPos() const { return goalPos_; }
+		// Point queries read the packed masks below, never the Tile structs
+		bool isSolidTile(int x, int y) const { return testMask(solidMask_, x, y); }
+		bool isGoalTile(int x, int y) const { return testMask(goalMask_, x, y); }
+		bool isHazardTile(int x, int y) const { return testMask(hazardMask_, x, y); }
+
+		// Area queries over an inclusive tile rect, clipped to the map. Tested a
+		// 64-bit word (64 tiles) at a time.
+		bool anySolidInRect(int x0, int y0, int x1, int y1) const { return anyInRect(solidMask_, x0, y0, x1, y1); }
+		bool anyGoalInRect(int x0, int y0, int x1, int y1) const { return anyInRect(goalMask_, x0, y0, x1, y1); }
+		bool anyHazardInRect(int x0, int y0, int x1, int y1) const { return anyInRect(hazardMask_, x0, y0, x1, y1); }
+
+		// Grid traversal queries (Amanatides-Woo): visit only the tiles the ray or
+		// swept box actually crosses, stopping at the first solid one
+		TileHit raycast(const glm::vec2& origin, const glm::vec2& dir, float maxDist) const;
+		TileHit boxcast(const AABB& box, const glm::vec2& delta) const;
+		void raycastBatch(const std::vector<TileRay>& rays, std::vector<TileHit>& hits) const;
+
+		// Precomputed collision shapes, both kept up to date by setTile. The tile collider
+		// hops rect to rect from a sensor that's past the surface to the exposed face.
+		uint8_t getEdgeMask(int x, int y) const {
+			if (x < 0 || x >= width_ || y < 0 || y >= height_)
+				return 0;
+			return edgeMask_[static_cast<size_t>(y) * width_ + x];
+		}
+		const std::vector<CollisionRect>& getCollisionRects() const { return collisionRects_; }
+		// The rect covering a solid tile; nullptr for empty and off-map tiles
+		const CollisionRect* getCollisionRectAt(int x, int y) const {
+			int index = rectIndexAt(x, y);
+			return index >= 0 ? &collisionRects_[index] : nullptr;
+		}
+		// Merges every solid tile into rects from scratch. setTile only splits rects and
+		// extends them along rows, so loaders call this once all the tiles are in.
+		void mergeCollisionRects();
+		int getSolidTileCount() const;
+		size_t getMemoryBytes() const; // Tiles, masks and collision shapes, roughly
+
+		// Change tracking for derived collision data owned elsewhere. The id differs per
+		// loaded level; the revision increments on every setTile. changesSince returns
+		// false when the bounded change log no longer reaches back to rev, in which case
+		// the caller should rebuild from scratch.
+		uint32_t getId() const { return id_; }
+		uint64_t getRevision() const { return revision_; }
+		bool changesSince(uint64_t rev, std::vector<glm::ivec2>& changes) const;
+
+		// Raw row access for sweeps; bit (x & 63) of word (x >> 6) is tile x
+		const uint64_t* getSolidRow(int y) const { return &solidMask_[static_cast<size_t>(y) * maskWords_]; }
+		int getMaskWords() const { return maskWords_; }
+		// Palette indices of row y, width_ of them
+		const uint8_t* getTileRow(int y) const { return &tiles_[static_cast<size_t>(y) * width_]; }
+		const TilePaletteEntry& getPaletteEntry(uint8_t index) const { return palette_[index]; }
 
 		// Setters
-		void setTile(int x, int y, const TileType& tileType);			   // Set tile at position (x, y) with a specific type
+		void setTile(int x, int y, const TileType& tileType, TileSkin skin = TileSkin::NONE); // Set tile at position (x, y) with a specific type
+		void setTextures(Texture* floorTex, Texture* wallTex) { floorTex_ = floorTex; wallTex_ = wallTex; }
 		void setPlayerPos(int x, int y) { playerPos_ = glm::ivec2(x, y); } // Set initial player position in tile indices
 		void setGoalPos(int x, int y) { goalPos_ = glm::ivec2(x, y); }	   // Set goal position in tile indices
 		void setDeathWallStartPos(int x, int y) { deathWallStartPos_ = glm::ivec2(x, y); } // Set death wall start position in tile indices
 		void setDeathWallEndPos(int x, int y) { deathWallEndPos_ = glm::ivec2(x, y); } // Set death wall end position in tile indices
+		void addPlatformSpawn(const PlatformSpawn& spawn) { platformSpawns_.push_back(spawn); }
+		const std::vector<PlatformSpawn>& getPlatformSpawns() const { return platformSpawns_; }
 
 		void renderTileMap(Shader& shader, Renderer2D& renderer) const; // Render the tilemap using the provided shader and renderer
+		// Only the tiles in an inclusive rect (clipped to the map), e.g. the ones on screen
+		void renderTileMap(Shader& shader, Renderer2D& renderer, int x0, int y0, int x1, int y1) const;
+
+		// Raw grids for writing compiled levels: one block of getStorageBytes() laid out
+		// the way storageBytes() describes
+		const uint8_t* getStorage() const { return reinterpret_cast<const uint8_t*>(solidMask_); }
+		size_t getStorageBytes() const { return storageBytes(width_, height_); }
+		static size_t storageBytes(int width, int height);
+		std::vector<TilePaletteEntry> getPalette() const {
+			return std::vector<TilePaletteEntry>(palette_.begin(), palette_.begin() + paletteCount_);
+		}
+		bool isMapped() const { return file_ != nullptr; }
 
 		// World <-> Grid conversions
 		glm::ivec2 worldToTileIndex(const glm::vec2& pos) const;
@@ -58,7 +180,64 @@ class Tilemap {
 		float getTileSize() const { return tileSize_; }
 
 	private:
-		std::vector<std::vector<Tile>> tiles_; // 2D vector to hold tiles
+		// A rect's columns as listed in one of its rows
+		struct RowSpan {
+				int x0, x1;
+				int rect; // Index into collisionRects_
+		};
+		static bool spanBefore(const RowSpan& span, int x) { return span.x0 < x; }
+
+		uint8_t tileAt(int x, int y) const { return tiles_[static_cast<size_t>(y) * width_ + x]; }
+		bool testMask(const uint64_t* mask, int x, int y) const {
+			if (x < 0 || x >= width_ || y < 0 || y >= height_)
+				return false;
+			return (mask[static_cast<size_t>(y) * maskWords_ + (x >> 6)] >> (x & 63)) & 1u;
+		}
+		bool anyInRect(const uint64_t* mask, int x0, int y0, int x1, int y1) const;
+		static void writeMask(uint64_t* mask, size_t word, int bit, bool value);
+		void bindStorage(uint8_t* base);
+		int paletteIndex(const TileType& tileType, TileSkin skin);
+		void updateEdgeMask(int x, int y);
+		int rectIndexAt(int x, int y) const;
+		void addRect(const CollisionRect& rect);
+		void indexRect(int index); // Lists an appended rect in its rows
+		void removeRect(int index);
+		void extendRect(int index, int x1);
+		// Greedy merge of the solid tiles in an inclusive tile box that no rect covers yet
+		void mergeSolidTiles(int x0, int y0, int x1, int y1);
+		void indexRects();
+
+		// Every per-tile grid lives in one block, in this order: the three collision masks,
+		// edgeMask_, tiles_. The block is either storage_ or a mapped compiled level, so
+		// loading one is a mmap rather than a parse. Moves keep the pointers valid since
+		// neither the vector's buffer nor the mapping moves.
+		std::vector<uint64_t> storage_;
+		std::unique_ptr<MappedFile> file_;
+
+		// Collision masks: one bit per tile, rows packed back to back (row y starts at
+		// word y * maskWords_). Derived from tile types in setTile, so they always match tiles_.
+		int maskWords_ = 0;
+		uint64_t* solidMask_ = nullptr;
+		uint64_t* goalMask_ = nullptr;
+		uint64_t* hazardMask_ = nullptr;
+
+		uint8_t* edgeMask_ = nullptr; // width_ * height_, row-major, see TileEdge
+		uint8_t* tiles_ = nullptr;	  // width_ * height_ palette indices, row-major
+
+		// Past paletteCount_ the entries are empty tiles, so a bad index in a file still reads something sane
+		std::array<TilePaletteEntry, MAX_PALETTE> palette_;
+		int paletteCount_ = 0;
+
+		// Merged solid tiles, in no particular order. rowRects_[y] lists the ones covering
+		// row y sorted by x0, so finding the rect under a tile is a binary search.
+		std::vector<CollisionRect> collisionRects_;
+		std::vector<std::vector<RowSpan>> rowRects_;
+
+		static const size_t MAX_CHANGE_LOG = 256;
+		uint32_t id_;
+		uint64_t revision_ = 0;
+		uint64_t changeLogStart_ = 0;		   // Revision before changeLog_[0] was applied
+		std::vector<glm::ivec2> changeLog_; // Tiles modified since changeLogStart_
 
 		int width_;			   // Width of the tilemap in tiles
 		int height_;		   // Height of the tilemap in tiles
@@ -66,11 +245,21 @@ class Tilemap {
 		glm::ivec2 deathWallStartPos_; // Position of the death wall start tile in tile indices
 		glm::ivec2 deathWallEndPos_; // Position of the death wall end tile in tile indices - must be aligned on one axis with start
 		glm::ivec2 goalPos_;   // Goal position in tile indices
+		std::vector<PlatformSpawn> platformSpawns_;
 
 		float tileSize_; // Size of one tile in world units
 
-		// Texture* wallTex_;
-		// Texture* floorTex_;
+		Texture* wallTex_ = nullptr;
+		Texture* floorTex_ = nullptr;
+};
+
+// Shared with a thread loading a level: the loader writes how far it got, the other side
+// may ask it to give up
+struct LoadProgress {
+		std::atomic<float> fraction{0.0f}; // 0..1 through the tile rows
+		std::atomic<bool> cancelled{false};
 };
 
-Tilemap loadTilemapFromFile(const std::string& filename, float tileSize, Texture* floorTex, Texture* wallTex);
+// Throws on a missing or malformed file, and when progress->cancelled is set mid-load
+Tilemap loadTilemapFromFile(const std::string& filename, float tileSize, Texture* floorTex, Texture* wallTex,
+							LoadProgress* progress = nullptr);
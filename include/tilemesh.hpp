@@ -0,0 +1,61 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "tilemap.hpp"
+#include "renderer2d.hpp"
+#include "compiledlevel.hpp"
+
+// Static geometry for a tilemap, one vertex buffer per CHUNK_TILES x CHUNK_TILES block, so
+// drawing the screen is a few calls per chunk instead of one per tile. build() only fills
+// CPU-side vertices and can run on a loading thread; upload() then creates the buffers a
+// few chunks at a time on the GL thread. Chunks not uploaded yet draw tile by tile.
+class TileMesh {
+
+	public:
+		static const int CHUNK_TILES = 32;
+
+		// With a compiled level's chunk table, chunks it lists as empty aren't looked at.
+		// Gives up between chunks once *cancel is set, leaving a mesh that matches nothing.
+		void build(const Tilemap& tilemap, const std::vector<LevelChunkInfo>* chunkTable = nullptr,
+				   const std::atomic<bool>* cancel = nullptr);
+		// Uploads up to maxChunks more chunks; returns how many are still waiting
+		int upload(Renderer2D& renderer, int maxChunks);
+		// Frees the GPU buffers (GL thread only); the CPU side stays for another upload
+		void release(Renderer2D& renderer);
+
+		// Built from this tilemap and none of its tiles changed since
+		bool matches(const Tilemap& tilemap) const {
+			return tilemapId_ == tilemap.getId() && revision_ == tilemap.getRevision();
+		}
+		bool isUploaded() const { return uploaded_ == static_cast<int>(chunks_.size()); }
+		int getChunkCount() const { return static_cast<int>(chunks_.size()); }
+		int getUploadedCount() const { return uploaded_; }
+		size_t getQuadCount() const;
+		size_t getMemoryBytes() const; // CPU side
+
+		// Draws the chunks overlapping the inclusive tile rect
+		void draw(Shader& shader, Renderer2D& renderer, const Tilemap& tilemap, int x0, int y0, int x1, int y1) const;
+
+	private:
+		// Quads sharing a texture are contiguous; nullptr is the vertex-colored run
+		struct Run {
+				Texture* texture;
+				uint32_t first, count;
+		};
+		struct Chunk {
+				int x0, y0; // First tile
+				std::vector<StaticVertex> vertices;
+				std::vector<Run> runs;
+				StaticQuads gpu;
+		};
+
+		void buildChunk(const Tilemap& tilemap, Chunk& chunk) const;
+
+		std::vector<Chunk> chunks_; // Row-major, chunksX_ per row
+		int chunksX_ = 0;
+		int chunksY_ = 0;
+		int uploaded_ = 0; // chunks_[0, uploaded_) have buffers
+		uint32_t tilemapId_ = 0;
+		uint64_t revision_ = 0;
+};
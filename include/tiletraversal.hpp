@@ -0,0 +1,166 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "tilemap.hpp"
+
+// Grid traversal (Amanatides-Woo) shared by everything that stores tiles: Tilemap and the
+// streamed TileWorld. Grid needs getWidth/getHeight/getTileSize, worldToTileIndex,
+// isSolidTile and anySolidInRect; tiles outside the grid are never solid.
+
+template <typename Grid>
+TileHit raycastTiles(const Grid& grid, const glm::vec2& origin, const glm::vec2& dir, float maxDist) {
+	const int width = grid.getWidth(), height = grid.getHeight();
+	const float tileSize = grid.getTileSize();
+	TileHit result;
+	glm::ivec2 cell = grid.worldToTileIndex(origin);
+	if (grid.isSolidTile(cell.x, cell.y)) {
+		// Started inside a solid tile
+		result.hit = true;
+		result.tile = cell;
+		return result;
+	}
+
+	float len = glm::length(dir);
+	if (len == 0.0f || maxDist <= 0.0f)
+		return result;
+	glm::vec2 d = dir / len;
+
+	int stepX = (d.x > 0.0f) ? 1 : (d.x < 0.0f ? -1 : 0);
+	int stepY = (d.y > 0.0f) ? 1 : (d.y < 0.0f ? -1 : 0);
+
+	// Outside the map and not heading into it: nothing can be hit
+	if ((cell.x < 0 && stepX <= 0) || (cell.x >= width && stepX >= 0) || (cell.y < 0 && stepY <= 0) ||
+		(cell.y >= height && stepY >= 0))
+		return result;
+
+	const float inf = std::numeric_limits<float>::infinity();
+	// Distance along the ray to the first vertical/horizontal grid line, and between successive lines
+	float tMaxX = stepX != 0 ? ((cell.x + (stepX > 0 ? 1 : 0)) * tileSize - origin.x) / d.x : inf;
+	float tMaxY = stepY != 0 ? ((cell.y + (stepY > 0 ? 1 : 0)) * tileSize - origin.y) / d.y : inf;
+	float tDeltaX = stepX != 0 ? tileSize / std::abs(d.x) : inf;
+	float tDeltaY = stepY != 0 ? tileSize / std::abs(d.y) : inf;
+
+	while (true) {
+		float t;
+		glm::vec2 normal;
+		if (tMaxX < tMaxY) {
+			t = tMaxX;
+			if (t > maxDist)
+				break;
+			cell.x += stepX;
+			tMaxX += tDeltaX;
+			normal = glm::vec2(static_cast<float>(-stepX), 0.0f);
+			if ((stepX > 0 && cell.x >= width) || (stepX < 0 && cell.x < 0))
+				break; // Left the map
+		} else {
+			t = tMaxY;
+			if (t > maxDist)
+				break;
+			cell.y += stepY;
+			tMaxY += tDeltaY;
+			normal = glm::vec2(0.0f, static_cast<float>(-stepY));
+			if ((stepY > 0 && cell.y >= height) || (stepY < 0 && cell.y < 0))
+				break;
+		}
+
+		if (grid.isSolidTile(cell.x, cell.y)) {
+			result.hit = true;
+			result.tile = cell;
+			result.normal = normal;
+			result.distance = t;
+			return result;
+		}
+	}
+	return result;
+}
+
+template <typename Grid>
+TileHit boxcastTiles(const Grid& grid, const AABB& box, const glm::vec2& delta) {
+	// Same traversal as raycast, driven by the box's leading edges. Whenever a leading
+	// edge crosses into a new column (row), that column (row) is tested over the rows
+	// (columns) the box spans at that moment. Edges lying exactly on a grid line do
+	// not count as overlapping the tile beyond it.
+	TileHit result;
+	const float T = grid.getTileSize();
+	const int width = grid.getWidth(), height = grid.getHeight();
+	auto lowIdx = [T](float v) { return static_cast<int>(std::floor(v / T)); };
+	auto highIdx = [T](float v) { return static_cast<int>(std::ceil(v / T)) - 1; };
+	auto firstSolid = [&grid](int x0, int y0, int x1, int y1) {
+		for (int y = y0; y <= y1; ++y)
+			for (int x = x0; x <= x1; ++x)
+				if (grid.isSolidTile(x, y))
+					return glm::ivec2(x, y);
+		return glm::ivec2(-1);
+	};
+
+	int c0 = lowIdx(box.left), c1 = highIdx(box.right);
+	int r0 = lowIdx(box.bottom), r1 = highIdx(box.top);
+	if (grid.anySolidInRect(c0, r0, c1, r1)) {
+		result.hit = true;
+		result.tile = firstSolid(c0, r0, c1, r1);
+		return result;
+	}
+
+	float len = glm::length(delta);
+	if (len == 0.0f)
+		return result;
+
+	int stepX = (delta.x > 0.0f) ? 1 : (delta.x < 0.0f ? -1 : 0);
+	int stepY = (delta.y > 0.0f) ? 1 : (delta.y < 0.0f ? -1 : 0);
+
+	const float inf = std::numeric_limits<float>::infinity();
+	// Next column/row the leading edges enter, and the sweep fraction (0..1) at which they do
+	int nextX = stepX > 0 ? c1 + 1 : c0 - 1;
+	int nextY = stepY > 0 ? r1 + 1 : r0 - 1;
+	float tX = stepX > 0 ? (nextX * T - box.right) / delta.x : (stepX < 0 ? ((nextX + 1) * T - box.left) / delta.x : inf);
+	float tY = stepY > 0 ? (nextY * T - box.top) / delta.y : (stepY < 0 ? ((nextY + 1) * T - box.bottom) / delta.y : inf);
+	float dtX = stepX != 0 ? T / std::abs(delta.x) : inf;
+	float dtY = stepY != 0 ? T / std::abs(delta.y) : inf;
+
+	while (true) {
+		bool alongX = tX <= tY;
+		float t = alongX ? tX : tY;
+		if (t > 1.0f)
+			break;
+
+		// Drop columns/rows the trailing edges have left by now
+		if (stepX > 0)
+			c0 = std::max(c0, lowIdx(box.left + delta.x * t));
+		else if (stepX < 0)
+			c1 = std::min(c1, highIdx(box.right + delta.x * t));
+		if (stepY > 0)
+			r0 = std::max(r0, lowIdx(box.bottom + delta.y * t));
+		else if (stepY < 0)
+			r1 = std::min(r1, highIdx(box.top + delta.y * t));
+
+		if (alongX) {
+			(stepX > 0 ? c1 : c0) = nextX;
+			if (grid.anySolidInRect(nextX, r0, nextX, r1)) {
+				result.hit = true;
+				result.tile = firstSolid(nextX, r0, nextX, r1);
+				result.normal = glm::vec2(static_cast<float>(-stepX), 0.0f);
+				result.distance = t * len;
+				return result;
+			}
+			nextX += stepX;
+			tX += dtX;
+			if ((stepX > 0 && nextX >= width) || (stepX < 0 && nextX < 0))
+				tX = inf; // Nothing left to enter on this axis
+		} else {
+			(stepY > 0 ? r1 : r0) = nextY;
+			if (grid.anySolidInRect(c0, nextY, c1, nextY)) {
+				result.hit = true;
+				result.tile = firstSolid(c0, nextY, c1, nextY);
+				result.normal = glm::vec2(0.0f, static_cast<float>(-stepY));
+				result.distance = t * len;
+				return result;
+			}
+			nextY += stepY;
+			tY += dtY;
+			if ((stepY > 0 && nextY >= height) || (stepY < 0 && nextY < 0))
+				tY = inf;
+		}
+	}
+	return result;
+}
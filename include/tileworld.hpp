@@ -0,0 +1,177 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "compiledlevel.hpp"
+#include "mappedfile.hpp"
+#include "tilemap.hpp"
+
+// .tworld: a level cut into WORLD_CHUNK_TILES square chunks so it can be streamed.
+//
+//   header | palette | markers | chunk index | chunk payloads
+//
+// The index has one entry per chunk, row-major. A chunk whose tiles are all the same
+// palette entry (open sky, solid rock) has no payload, only its index entry. The rest
+// store their palette indices run-length encoded. Native byte order, like .tlvl.
+const uint32_t TILE_WORLD_VERSION = 1;
+const int WORLD_CHUNK_TILES = 64;			 // So a chunk row is one mask word
+const size_t TILE_WORLD_BUDGET = 8u << 20; // Bytes of decoded chunks kept resident
+const int STREAM_MARGIN_CHUNKS = 1;		 // Loaded around the screen so walking never waits
+
+struct TileWorldHeader {
+		char magic[4]; // "TWLD"
+		uint32_t version;
+		int32_t width, height;
+		int32_t chunksX, chunksY;
+		uint32_t chunkTiles;
+		uint32_t paletteCount;
+		uint32_t markerCount;
+		uint32_t pad;
+		uint64_t paletteOffset, markerOffset, indexOffset;
+};
+
+struct TileWorldChunkEntry {
+		uint64_t offset; // Of the payload
+		uint32_t bytes;	 // 0 when every tile is fill
+		uint8_t fill;
+		uint8_t pad[3];
+};
+
+struct SpriteInstance;
+
+// Reads the header from the start of in; false unless it's a tile world this build reads
+bool readTileWorldHeader(std::istream& in, TileWorldHeader& header);
+
+// Writes the palette indices of one chunk: tiles[y * WORLD_CHUNK_TILES + x] is tile
+// (x0 + x, y0 + y). The buffer starts zeroed; tiles past the map edge are ignored.
+using ChunkFiller = std::function<void(int x0, int y0, uint8_t* tiles)>;
+// Reads one chunk, laid out the same way
+using ChunkVisitor = std::function<void(int x0, int y0, const uint8_t* tiles)>;
+
+// Generates the world chunk by chunk, so it never has to exist in memory all at once.
+// Written through a temp file and rename.
+bool writeTileWorld(const std::string& path, int width, int height, const std::vector<TilePaletteEntry>& palette,
+					const std::vector<LevelMarker>& markers, const ChunkFiller& fill);
+bool writeTileWorld(const Tilemap& tilemap, const std::string& path);
+
+// A .tworld level with only the chunks around the camera in memory. update() loads what
+// the screen needs and evicts least recently used chunks elsewhere once over budget.
+// Chunks that are entirely one tile cost nothing at all.
+//
+// The queries match Tilemap's and work anywhere in the world: a query that reaches a chunk
+// that isn't loaded loads it on the spot. That also means queries modify the cache, so a
+// TileWorld is used from one thread at a time. The world is read-only.
+class TileWorld {
+
+	public:
+		explicit TileWorld(size_t budgetBytes = TILE_WORLD_BUDGET) : budget_(budgetBytes) {}
+
+		bool open(const std::string& path, float tileSize);
+		void close();
+		void setTextures(Texture* floorTex, Texture* wallTex) {
+			floorTex_ = floorTex;
+			wallTex_ = wallTex;
+		}
+
+		// Once a frame with the inclusive tile rect on screen
+		void update(int x0, int y0, int x1, int y1);
+
+		bool isSolidTile(int x, int y) const { return testMask(&Chunk::solid, x, y); }
+		bool isGoalTile(int x, int y) const { return testMask(&Chunk::goal, x, y); }
+		bool isHazardTile(int x, int y) const { return testMask(&Chunk::hazard, x, y); }
+		TileEnum getTileType(int x, int y) const;
+		Tile getTile(int x, int y) const;
+		uint8_t getEdgeMask(int x, int y) const; // See TileEdge; worked out from the neighbours
+
+		bool anySolidInRect(int x0, int y0, int x1, int y1) const { return anyInRect(&Chunk::solid, x0, y0, x1, y1); }
+		bool anyGoalInRect(int x0, int y0, int x1, int y1) const { return anyInRect(&Chunk::goal, x0, y0, x1, y1); }
+		bool anyHazardInRect(int x0, int y0, int x1, int y1) const { return anyInRect(&Chunk::hazard, x0, y0, x1, y1); }
+
+		TileHit raycast(const glm::vec2& origin, const glm::vec2& dir, float maxDist) const;
+		TileHit boxcast(const AABB& box, const glm::vec2& delta) const;
+
+		// Appends a sprite for each visible tile in the inclusive rect, so they can be drawn
+		// from a thread that mustn't touch the world
+		void collectTiles(int x0, int y0, int x1, int y1, std::vector<SpriteInstance>& out) const;
+
+		// Every chunk once, in index order, without going through the cache: for one-off
+		// passes over the whole world at load. A chunk entirely of one palette entry is
+		// skipped without being read if skipFill(entry) says so.
+		void scanChunks(const ChunkVisitor& visit, const std::function<bool(uint8_t fill)>& skipFill = nullptr) const;
+
+		glm::ivec2 worldToTileIndex(const glm::vec2& pos) const;
+		glm::vec2 tileIndexToWorldPos(int x, int y) const { return glm::vec2(x * tileSize_, y * tileSize_); }
+
+		int getWidth() const { return width_; }
+		int getHeight() const { return height_; }
+		float getTileSize() const { return tileSize_; }
+		glm::ivec2 getPlayerPosition() const { return markerPos(LevelMarkerKind::PLAYER); }
+		glm::ivec2 getGoalPos() const { return markerPos(LevelMarkerKind::GOAL); }
+		glm::ivec2 getDeathWallStartPosition() const { return markerPos(LevelMarkerKind::DEATH_WALL_START); }
+		glm::ivec2 getDeathWallEndPosition() const { return markerPos(LevelMarkerKind::DEATH_WALL_END); }
+		const std::vector<PlatformSpawn>& getPlatformSpawns() const { return platformSpawns_; }
+		const std::vector<LevelMarker>& getMarkers() const { return markers_; }
+		const TilePaletteEntry& getPaletteEntry(uint8_t index) const { return palette_[index]; }
+
+		size_t getBudget() const { return budget_; }
+		size_t getResidentBytes() const { return resident_.size() * RESIDENT_CHUNK_BYTES; }
+		int getResidentCount() const { return static_cast<int>(resident_.size()); }
+		long getLoadCount() const { return loads_; }
+		long getEvictCount() const { return evictions_; }
+
+	private:
+		static const int N = WORLD_CHUNK_TILES;
+		struct Chunk {
+				uint8_t tiles[N * N]; // Palette indices, row-major
+				uint64_t solid[N];	  // One word per row, bit x is tile x
+				uint64_t goal[N];
+				uint64_t hazard[N];
+		};
+		using Mask = uint64_t (Chunk::*)[N];
+		struct Slot {
+				std::unique_ptr<Chunk> chunk;
+				unsigned long lastUse;
+		};
+		static const size_t RESIDENT_CHUNK_BYTES = sizeof(Chunk) + sizeof(Slot);
+
+		// Loads the chunk if needed; cx, cy must be inside the map
+		const Chunk& chunkAt(int cx, int cy) const;
+		const Chunk& uniformChunk(uint8_t fill) const;
+		bool decodeChunk(const TileWorldChunkEntry& entry, Chunk& chunk) const;
+		void fillMasks(Chunk& chunk) const;
+		void evict();
+
+		bool testMask(Mask mask, int x, int y) const {
+			if (x < 0 || x >= width_ || y < 0 || y >= height_)
+				return false;
+			return ((chunkAt(x / N, y / N).*mask)[y % N] >> (x % N)) & 1u;
+		}
+		bool anyInRect(Mask mask, int x0, int y0, int x1, int y1) const;
+		glm::ivec2 markerPos(LevelMarkerKind kind) const;
+
+		mutable MappedFile file_; // Mutable for discard() after a chunk is decoded
+		TileWorldHeader header_ = {};
+		int width_ = 0, height_ = 0;
+		float tileSize_ = 1.0f;
+		std::array<TilePaletteEntry, Tilemap::MAX_PALETTE> palette_;
+		std::vector<LevelMarker> markers_;
+		std::vector<PlatformSpawn> platformSpawns_;
+		Texture* floorTex_ = nullptr;
+		Texture* wallTex_ = nullptr;
+
+		// Keyed by cy * chunksX + cx. Uniform chunks never go in here; they all share one
+		// read-only chunk per palette entry in uniform_.
+		mutable std::unordered_map<uint64_t, Slot> resident_;
+		mutable std::array<std::unique_ptr<Chunk>, Tilemap::MAX_PALETTE> uniform_;
+		mutable uint64_t lastKey_ = UINT64_MAX; // Most queries stay within one chunk
+		mutable const Chunk* lastChunk_ = nullptr;
+		mutable unsigned long useClock_ = 0;
+		mutable long loads_ = 0;
+		long evictions_ = 0;
+		size_t budget_;
+};
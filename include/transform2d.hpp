@@ -0,0 +1,130 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <cmath>
+#include <cstddef>
+
+// 2D affine transform stored as the two basis columns and the translation of a 2x3 matrix:
+//   | a  c  tx |
+//   | b  d  ty |
+// Six floats instead of a mat4's sixteen, and applying it to a point is four multiplies.
+// Everything the 2D path needs (object TRS, tile placement, quad corners) fits in this;
+// toMat4 is only for handing it to GL.
+struct Transform2D {
+		float a = 1.0f, b = 0.0f; // Image of the x axis
+		float c = 0.0f, d = 1.0f; // Image of the y axis
+		float tx = 0.0f, ty = 0.0f;
+
+		static Transform2D identity() { return Transform2D(); }
+		static Transform2D translation(const glm::vec2& t) {
+			Transform2D xf;
+			xf.tx = t.x;
+			xf.ty = t.y;
+			return xf;
+		}
+		// Same order as GameObject's old translate * rotate * scale: scale, then rotate, then move
+		static Transform2D fromTRS(const glm::vec2& position, float rotation, const glm::vec2& scale) {
+			Transform2D xf;
+			float cs = std::cos(rotation), sn = std::sin(rotation);
+			xf.a = cs * scale.x;
+			xf.b = sn * scale.x;
+			xf.c = -sn * scale.y;
+			xf.d = cs * scale.y;
+			xf.tx = position.x;
+			xf.ty = position.y;
+			return xf;
+		}
+		// No rotation: what tiles and most objects are
+		static Transform2D fromTS(const glm::vec2& position, const glm::vec2& scale) {
+			Transform2D xf;
+			xf.a = scale.x;
+			xf.d = scale.y;
+			xf.tx = position.x;
+			xf.ty = position.y;
+			return xf;
+		}
+
+		glm::vec2 apply(const glm::vec2& p) const { return glm::vec2(a * p.x + c * p.y + tx, b * p.x + d * p.y + ty); }
+		glm::vec2 applyVector(const glm::vec2& v) const { return glm::vec2(a * v.x + c * v.y, b * v.x + d * v.y); }
+
+		// (*this * other) applies other first, like matrix products
+		Transform2D operator*(const Transform2D& o) const {
+			Transform2D xf;
+			xf.a = a * o.a + c * o.b;
+			xf.b = b * o.a + d * o.b;
+			xf.c = a * o.c + c * o.d;
+			xf.d = b * o.c + d * o.d;
+			xf.tx = a * o.tx + c * o.ty + tx;
+			xf.ty = b * o.tx + d * o.ty + ty;
+			return xf;
+		}
+
+		float determinant() const { return a * d - b * c; }
+		// Identity if the transform is degenerate (zero scale)
+		Transform2D inverse() const {
+			float det = determinant();
+			if (det == 0.0f)
+				return Transform2D();
+			float inv = 1.0f / det;
+			Transform2D xf;
+			xf.a = d * inv;
+			xf.b = -b * inv;
+			xf.c = -c * inv;
+			xf.d = a * inv;
+			xf.tx = -(xf.a * tx + xf.c * ty);
+			xf.ty = -(xf.b * tx + xf.d * ty);
+			return xf;
+		}
+
+		// Corners of the unit quad (-0.5..0.5) the renderer draws, in the order of its index
+		// buffer: bottom-left, bottom-right, top-right, top-left. Center plus/minus the two
+		// half axes, no matrix involved.
+		void quadCorners(glm::vec2 out[4]) const {
+			float hx = 0.5f * a, hy = 0.5f * b; // Half x axis
+			float vx = 0.5f * c, vy = 0.5f * d; // Half y axis
+			out[0] = glm::vec2(tx - hx - vx, ty - hy - vy);
+			out[1] = glm::vec2(tx + hx - vx, ty + hy - vy);
+			out[2] = glm::vec2(tx + hx + vx, ty + hy + vy);
+			out[3] = glm::vec2(tx - hx + vx, ty - hy + vy);
+		}
+
+		// Back to position/rotation/scale for code that stores those (GameObject). Assumes no
+		// shear, which holds for anything built from TRS pieces with uniform-ish scale.
+		void decompose(glm::vec2& position, float& rotation, glm::vec2& scale) const {
+			position = glm::vec2(tx, ty);
+			rotation = std::atan2(b, a);
+			scale.x = std::sqrt(a * a + b * b);
+			scale.y = std::sqrt(c * c + d * d);
+			if (determinant() < 0.0f)
+				scale.y = -scale.y;
+		}
+
+		glm::mat4 toMat4() const {
+			glm::mat4 m(1.0f);
+			m[0][0] = a;
+			m[0][1] = b;
+			m[1][0] = c;
+			m[1][1] = d;
+			m[3][0] = tx;
+			m[3][1] = ty;
+			return m;
+		}
+};
+
+// viewProj * xf.toMat4() without the full 4x4 product: the affine only has three
+// non-trivial columns, so this is three matrix-vector products
+inline glm::mat4 mulAffine(const glm::mat4& viewProj, const Transform2D& xf) {
+	glm::mat4 m;
+	m[0] = viewProj[0] * xf.a + viewProj[1] * xf.b;
+	m[1] = viewProj[0] * xf.c + viewProj[1] * xf.d;
+	m[2] = viewProj[2];
+	m[3] = viewProj[0] * xf.tx + viewProj[1] * xf.ty + viewProj[3];
+	return m;
+}
+
+// Corners for a run of quads into out[4 * count]. Written as one flat loop with no branches
+// so the compiler vectorises it; the batcher uses it to fill a whole vertex run at once.
+inline void transformQuadCorners(const Transform2D* xfs, size_t count, glm::vec2* out) {
+	for (size_t i = 0; i < count; ++i) {
+		xfs[i].quadCorners(out + 4 * i);
+	}
+}
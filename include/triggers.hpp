@@ -0,0 +1,84 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "aabbbatch.hpp"
+#include "gameobject.hpp"
+#include "spatialhash.hpp"
+#include "tilemap.hpp"
+#include "globals.hpp"
+
+class TileWorld;
+
+enum class TriggerType { GOAL, CHECKPOINT, KILL, SCRIPTED };
+enum class TriggerPhase { ENTER, STAY, EXIT };
+
+struct Trigger {
+		TriggerType type;
+		AABB box;
+		glm::vec2 spawn;  // Where a checkpoint respawns the player
+		std::string tag; // Lets scripts tell their regions apart
+};
+
+struct TriggerEvent {
+		int trigger; // Index into the system's triggers
+		TriggerType type;
+		TriggerPhase phase;
+};
+
+// Trigger volumes the player can be inside. Triggers are listed in a hashed grid, so a
+// frame only tests the buckets near the player; each bucket keeps its boxes in an
+// AABBBatch too, so they're tested several at a time. Comparing this frame's overlap set
+// with the last one's gives enter/stay/exit events.
+class TriggerSystem {
+
+	public:
+		// Replaces all triggers with the tilemap's goal, checkpoint and kill zone tiles, each
+		// block of same-type tiles merged into one rect. Forgets the reached checkpoint.
+		void load(const Tilemap& tilemap);
+		// Same for a streamed level, read chunk by chunk. Blocks are only merged within a
+		// chunk, so one crossing a chunk edge becomes a trigger on each side.
+		void load(const TileWorld& world);
+		int add(TriggerType type, const AABB& box, const std::string& tag = "");
+		void clear();
+		// Forgets what the player was inside, so the next update sends fresh ENTERs
+		void clearContacts();
+		// Back to how load() left it, without loading again: no checkpoint, no contacts
+		void restart() {
+			checkpoint_ = -1;
+			clearContacts();
+		}
+
+		// Tests box against the nearby triggers and rebuilds the event list
+		void update(const AABB& box);
+		const std::vector<TriggerEvent>& getEvents() const { return events_; }
+
+		// Remembers a checkpoint as the respawn point; returns false if none was reached
+		void setCheckpoint(int trigger) { checkpoint_ = trigger; }
+		bool getCheckpointSpawn(glm::vec2& spawn) const;
+
+		const Trigger& getTrigger(int index) const { return triggers_[index]; }
+		int getCount() const { return static_cast<int>(triggers_.size()); }
+		int getInsideCount() const { return static_cast<int>(inside_.size()); }
+		int getTestedCount() const { return tested_; } // Boxes tested by the last update
+
+	private:
+		// Adds the merged blocks of the width x height tiles at (x0, y0); typeAt(x, y) takes
+		// coordinates relative to x0, y0
+		template <typename TypeAt>
+		void addTileTriggers(int x0, int y0, int width, int height, float tileSize, TypeAt typeAt);
+
+		std::vector<Trigger> triggers_;
+		static const int GRID_BUCKETS = 1024;
+		SpatialHash<int, GRID_BUCKETS> grid_{4.0f * TILE_SIZE};
+		std::vector<AABBBatch> bucketBoxes_ = std::vector<AABBBatch>(GRID_BUCKETS); // Entry i is the box of grid bucket entry i
+		std::vector<uint32_t> stamp_; // Last query each trigger was hit in, dedupes multi-cell triggers
+		uint32_t query_ = 0;
+		std::vector<int> hits_; // Scratch, overlapping entries of one bucket
+		std::vector<int> inside_;	  // Sorted indices overlapped last update
+		std::vector<int> wasInside_; // Scratch, previous inside_
+		std::vector<TriggerEvent> events_;
+		int checkpoint_ = -1;
+		int tested_ = 0;
+};
@@ -0,0 +1,42 @@
+#pragma once
+#include <atomic>
+
+// Hands whole values from one writer thread to one reader thread without either waiting.
+// The writer fills its slot and publishes it; the reader takes the newest published slot.
+// A third slot sits between them, so the writer always has a free slot even while the
+// reader is still using the previous value, and the reader never sees a half-written
+// one. Values the reader never got to are simply skipped.
+template <typename T>
+class TripleBuffer {
+
+	public:
+		// Writer side: the slot to fill, then publish() it. The slot keeps whatever it held
+		// three publishes ago, so containers inside T keep their capacity.
+		T& getWriteSlot() { return slots_[write_]; }
+		void publish() {
+			int previous = middle_.exchange(write_ | FRESH, std::memory_order_acq_rel);
+			write_ = previous & INDEX;
+			published_.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		// Reader side: the newest published value, or the one read last time if nothing new
+		// arrived. Stays untouched by the writer until the next acquire().
+		const T& acquire() {
+			if (middle_.load(std::memory_order_relaxed) & FRESH) {
+				read_ = middle_.exchange(read_, std::memory_order_acq_rel) & INDEX;
+			}
+			return slots_[read_];
+		}
+		bool hasFresh() const { return (middle_.load(std::memory_order_acquire) & FRESH) != 0; }
+		unsigned long getPublished() const { return published_.load(std::memory_order_relaxed); }
+
+	private:
+		static const int INDEX = 3;
+		static const int FRESH = 4;
+
+		T slots_[3];
+		int write_ = 0; // Writer thread only
+		int read_ = 1;	// Reader thread only
+		std::atomic<int> middle_{2};
+		std::atomic<unsigned long> published_{0};
+};
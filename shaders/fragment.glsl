@@ -1,9 +1,11 @@
 #version 330 core
 
 in vec2 v_TexCoord; // UV coordinates from vertex shader
+in vec4 v_Color; // Per-vertex color from the quad batch
 
 uniform vec4 color;
 uniform int useTexture;
+uniform int useVertexColor;
 uniform sampler2D slot;
 
 out vec4 FragColor; // Output color
@@ -11,6 +13,8 @@ void main()
 {
 	if(useTexture == 1){
 		FragColor = texture(slot, v_TexCoord);
+	} else if(useVertexColor == 1){
+		FragColor = v_Color;
 	} else {
 		FragColor = color;
 	}
@@ -2,12 +2,14 @@
 
 layout(location = 0) in vec2 aPos; // Vertex position, 2D coordinates
 layout(location = 1) in vec2 aTexCoord; // Texture coordinates
+layout(location = 2) in vec4 aColor; // Per-vertex color, only set by the quad batch
 
 uniform mat4 MVP; // Model-View-Projection matrix
 uniform vec2 u_UVScale;
 uniform vec2 u_UVOffset;
 
 out vec2 v_TexCoord; // Pass UV coordinates to fragment shader
+out vec4 v_Color;
 
 void main()
 {
@@ -15,4 +17,5 @@ void main()
 	gl_Position = MVP * vec4(aPos, 0.0, 1.0);
 	// v_TexCoord = aTexCoord;
 	v_TexCoord = aTexCoord * u_UVScale + u_UVOffset;
+	v_Color = aColor;
 }
\ No newline at end of file
@@ -0,0 +1,194 @@
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include "aabbbatch.hpp"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define AABB_BATCH_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+// Inverted box used for padding: left > right and bottom > top fail every comparison in
+// the overlap test
+const float INF = std::numeric_limits<float>::infinity();
+const AABB EMPTY_BOX = {INF, -INF, -INF, INF};
+} // namespace
+
+void AABBBatch::clear() {
+	// Keeps the storage so a batch refilled every frame doesn't reallocate; the used slots
+	// go back to being padding
+	std::fill(left_.begin(), left_.begin() + count_, EMPTY_BOX.left);
+	std::fill(right_.begin(), right_.begin() + count_, EMPTY_BOX.right);
+	std::fill(top_.begin(), top_.begin() + count_, EMPTY_BOX.top);
+	std::fill(bottom_.begin(), bottom_.begin() + count_, EMPTY_BOX.bottom);
+	count_ = 0;
+}
+
+void AABBBatch::reserve(size_t count) {
+	size_t padded = (count + BLOCK - 1) / BLOCK * BLOCK;
+	left_.reserve(padded);
+	right_.reserve(padded);
+	top_.reserve(padded);
+	bottom_.reserve(padded);
+}
+
+int AABBBatch::push(const AABB& box) {
+	if (count_ == left_.size()) {
+		// Grow by a block of padding boxes
+		left_.resize(left_.size() + BLOCK, EMPTY_BOX.left);
+		right_.resize(right_.size() + BLOCK, EMPTY_BOX.right);
+		top_.resize(top_.size() + BLOCK, EMPTY_BOX.top);
+		bottom_.resize(bottom_.size() + BLOCK, EMPTY_BOX.bottom);
+	}
+	set(static_cast<int>(count_), box);
+	return static_cast<int>(count_++);
+}
+
+void AABBBatch::pop() {
+	// Keeps the storage, so the slot goes back to being padding
+	set(static_cast<int>(--count_), EMPTY_BOX);
+}
+
+void AABBBatch::set(int index, const AABB& box) {
+	left_[index] = box.left;
+	right_[index] = box.right;
+	top_[index] = box.top;
+	bottom_[index] = box.bottom;
+}
+
+namespace {
+
+// Each kernel fills one mask bit for each of n SoA entries (n a multiple of BLOCK), 64
+// entries per word
+using MaskKernel = void (*)(const AABB& box, const float* l, const float* r, const float* t, const float* b, size_t n,
+							uint64_t* mask);
+
+void maskScalar(const AABB& box, const float* l, const float* r, const float* t, const float* b, size_t n, uint64_t* mask) {
+	for (size_t base = 0; base < n; base += 64) {
+		uint64_t word = 0;
+		size_t end = std::min(n, base + 64);
+		for (size_t i = base; i < end; ++i) {
+			// Non-short-circuit & keeps this branch-free
+			bool hit = (box.left < r[i]) & (box.right > l[i]) & (box.top > b[i]) & (box.bottom < t[i]);
+			word |= static_cast<uint64_t>(hit) << (i - base);
+		}
+		mask[base / 64] = word;
+	}
+}
+
+#ifdef AABB_BATCH_X86
+// SSE2 is part of x86-64, so this needs no target attribute there
+__attribute__((target("sse2"))) void maskSSE2(const AABB& box, const float* l, const float* r, const float* t, const float* b, size_t n, uint64_t* mask) {
+	const __m128 qLeft = _mm_set1_ps(box.left), qRight = _mm_set1_ps(box.right);
+	const __m128 qTop = _mm_set1_ps(box.top), qBottom = _mm_set1_ps(box.bottom);
+	for (size_t base = 0; base < n; base += 64) {
+		uint64_t word = 0;
+		size_t end = std::min(n, base + 64);
+		for (size_t i = base; i < end; i += 4) {
+			__m128 hit = _mm_and_ps(_mm_cmplt_ps(qLeft, _mm_loadu_ps(r + i)), _mm_cmpgt_ps(qRight, _mm_loadu_ps(l + i)));
+			hit = _mm_and_ps(hit, _mm_cmpgt_ps(qTop, _mm_loadu_ps(b + i)));
+			hit = _mm_and_ps(hit, _mm_cmplt_ps(qBottom, _mm_loadu_ps(t + i)));
+			word |= static_cast<uint64_t>(_mm_movemask_ps(hit)) << (i - base);
+		}
+		mask[base / 64] = word;
+	}
+}
+
+__attribute__((target("avx"))) void maskAVX(const AABB& box, const float* l, const float* r, const float* t, const float* b, size_t n, uint64_t* mask) {
+	const __m256 qLeft = _mm256_set1_ps(box.left), qRight = _mm256_set1_ps(box.right);
+	const __m256 qTop = _mm256_set1_ps(box.top), qBottom = _mm256_set1_ps(box.bottom);
+	for (size_t base = 0; base < n; base += 64) {
+		uint64_t word = 0;
+		size_t end = std::min(n, base + 64);
+		for (size_t i = base; i < end; i += 8) {
+			__m256 hit = _mm256_and_ps(_mm256_cmp_ps(qLeft, _mm256_loadu_ps(r + i), _CMP_LT_OQ),
+									   _mm256_cmp_ps(qRight, _mm256_loadu_ps(l + i), _CMP_GT_OQ));
+			hit = _mm256_and_ps(hit, _mm256_cmp_ps(qTop, _mm256_loadu_ps(b + i), _CMP_GT_OQ));
+			hit = _mm256_and_ps(hit, _mm256_cmp_ps(qBottom, _mm256_loadu_ps(t + i), _CMP_LT_OQ));
+			word |= static_cast<uint64_t>(_mm256_movemask_ps(hit)) << (i - base);
+		}
+		mask[base / 64] = word;
+	}
+}
+#endif
+
+// The level in use, detected on first use. A function-local static is initialised once
+// even when several threads get here first, and the atomic lets setSimdLevel race with
+// running queries.
+std::atomic<SimdLevel>& activeLevel() {
+	static std::atomic<SimdLevel> level(detectSimdLevel());
+	return level;
+}
+
+MaskKernel kernelFor(SimdLevel level) {
+	switch (level) {
+#ifdef AABB_BATCH_X86
+	case SimdLevel::AVX:
+		return maskAVX;
+	case SimdLevel::SSE2:
+		return maskSSE2;
+#endif
+	default:
+		return maskScalar;
+	}
+}
+
+MaskKernel maskKernel() { return kernelFor(activeLevel().load(std::memory_order_relaxed)); }
+
+} // namespace
+
+SimdLevel detectSimdLevel() {
+#ifdef AABB_BATCH_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx"))
+		return SimdLevel::AVX;
+	if (__builtin_cpu_supports("sse2"))
+		return SimdLevel::SSE2;
+#endif
+	return SimdLevel::SCALAR;
+}
+
+SimdLevel getSimdLevel() { return activeLevel().load(std::memory_order_relaxed); }
+
+void setSimdLevel(SimdLevel level) {
+	SimdLevel supported = detectSimdLevel();
+	activeLevel().store(static_cast<int>(level) > static_cast<int>(supported) ? supported : level, std::memory_order_relaxed);
+}
+
+const char* simdLevelName(SimdLevel level) {
+	switch (level) {
+	case SimdLevel::AVX:
+		return "AVX";
+	case SimdLevel::SSE2:
+		return "SSE2";
+	default:
+		return "scalar";
+	}
+}
+
+void overlapMask(const AABB& box, const AABBBatch& batch, std::vector<uint64_t>& mask) {
+	mask.resize((batch.paddedSize() + 63) / 64);
+	if (!mask.empty()) {
+		maskKernel()(box, batch.left(), batch.right(), batch.top(), batch.bottom(), batch.paddedSize(), mask.data());
+	}
+}
+
+size_t overlapIndices(const AABB& box, const AABBBatch& batch, std::vector<int>& out) {
+	// Masks are built a chunk at a time on the stack, so compacting needs no scratch vector
+	const size_t CHUNK = 1024;
+	uint64_t mask[CHUNK / 64];
+	MaskKernel kernel = maskKernel();
+	size_t before = out.size();
+	size_t n = batch.paddedSize();
+	for (size_t base = 0; base < n; base += CHUNK) {
+		size_t count = std::min(CHUNK, n - base);
+		kernel(box, batch.left() + base, batch.right() + base, batch.top() + base, batch.bottom() + base, count, mask);
+		for (size_t w = 0; w < (count + 63) / 64; ++w) {
+			for (uint64_t bits = mask[w]; bits; bits &= bits - 1) {
+				out.push_back(static_cast<int>(base + w * 64 + __builtin_ctzll(bits)));
+			}
+		}
+	}
+	return out.size() - before;
+}
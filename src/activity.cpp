@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <cmath>
+#include "activity.hpp"
+
+void ActivitySet::resize(const std::vector<GameObject>& objects) {
+	int oldCount = static_cast<int>(state_.size());
+	int newCount = static_cast<int>(objects.size());
+	if (newCount < oldCount) {
+		// Objects were removed: start over with everything awake
+		state_.clear();
+		active_.clear();
+		boxes_.clear();
+		sleepers_.clear();
+		sleeperCount_ = 0;
+		oldCount = 0;
+	}
+	state_.resize(newCount);
+	for (int i = oldCount; i < newCount; ++i) {
+		state_[i] = ObjectActivity();
+		state_[i].lastPos = objects[i].getPosition();
+		state_[i].lastVersion = objects[i].getTransformVersion();
+		state_[i].activeSlot = static_cast<int>(active_.size());
+		active_.push_back(i);
+		boxes_.push(objects[i].getAABB());
+	}
+}
+
+void ActivitySet::update(const std::vector<GameObject>& objects, float deltaTime, const AABB& wakeRegion) {
+	if (objects.size() != state_.size()) {
+		resize(objects);
+	}
+
+	// Refresh the active boxes, then find the ones near the player in one pass
+	for (size_t slot = 0; slot < active_.size(); ++slot) {
+		boxes_.set(static_cast<int>(slot), objects[active_[slot]].getAABB());
+	}
+	overlapMask(wakeRegion, boxes_, near_);
+
+	// Iterate backwards so sleeping (swap-removing) the current entry is safe. Slots below
+	// the current one never move, so near_ still lines up with them.
+	for (int slot = static_cast<int>(active_.size()) - 1; slot >= 0; --slot) {
+		int index = active_[slot];
+		const GameObject& obj = objects[index];
+		ObjectActivity& state = state_[index];
+
+		// Untouched transforms can't have moved, so only changed ones pay for the distance check
+		bool still = glm::length(obj.getVelocity()) < SLEEP_VELOCITY;
+		if (still && obj.getTransformVersion() != state.lastVersion) {
+			still = glm::length(obj.getPosition() - state.lastPos) < SLEEP_DISTANCE;
+		}
+		state.lastPos = obj.getPosition();
+		state.lastVersion = obj.getTransformVersion();
+
+		if (!still) {
+			// Moving objects wake whatever sleeps where they now are
+			state.idleTime = 0.0f;
+			wakeInRegion(obj.getAABB());
+		} else if ((near_[slot / 64] >> (slot % 64)) & 1) {
+			state.idleTime = 0.0f;
+		} else {
+			state.idleTime += deltaTime;
+			if (state.idleTime >= SLEEP_DELAY) {
+				sleep(index, obj.getAABB());
+			}
+		}
+	}
+	wakeInRegion(wakeRegion);
+}
+
+void ActivitySet::sleep(int index, const AABB& box) {
+	ObjectActivity& state = state_[index];
+	// Swap-remove from the packed active array and its boxes
+	int last = active_.back();
+	active_[state.activeSlot] = last;
+	state_[last].activeSlot = state.activeSlot;
+	active_.pop_back();
+	boxes_.set(state.activeSlot, boxes_.get(static_cast<int>(active_.size())));
+	boxes_.pop();
+
+	state.asleep = true;
+	state.activeSlot = -1;
+	state.box = box;
+	state.cells = sleepers_.cellRange(box);
+	sleepers_.insert(state.cells, {index, box});
+	sleeperCount_++;
+}
+
+void ActivitySet::wake(int index) {
+	if (index < 0 || index >= static_cast<int>(state_.size()) || !state_[index].asleep)
+		return;
+	ObjectActivity& state = state_[index];
+	sleepers_.remove(state.cells, [index](const Sleeper& s) { return s.index == index; });
+	sleeperCount_--;
+	state.asleep = false;
+	state.idleTime = 0.0f;
+	state.activeSlot = static_cast<int>(active_.size());
+	active_.push_back(index);
+	boxes_.push(state.box);
+}
+
+void ActivitySet::wakeAll() {
+	for (int i = 0; i < static_cast<int>(state_.size()); ++i) {
+		if (state_[i].asleep) {
+			state_[i].asleep = false;
+			state_[i].activeSlot = static_cast<int>(active_.size());
+			active_.push_back(i);
+			boxes_.push(state_[i].box);
+		}
+		state_[i].idleTime = 0.0f;
+	}
+	sleepers_.clear();
+	sleeperCount_ = 0;
+}
+
+void ActivitySet::wakeInRegion(const AABB& region) {
+	if (sleeperCount_ == 0)
+		return;
+	woken_.clear();
+	sleepers_.forEach(sleepers_.cellRange(region), [&](const Sleeper& sleeper) {
+		if (checkCollision(sleeper.box, region)) {
+			woken_.push_back(sleeper.index);
+		}
+	});
+	// An object spanning several cells may be listed more than once; wake() ignores repeats
+	for (int index : woken_) {
+		wake(index);
+	}
+}
@@ -3,6 +3,7 @@
 #include "gameobject.hpp"
 #include "playerobject.hpp"
 #include "tilemap.hpp"
+#include "events.hpp"
 #include "debug.hpp"
 #include "globals.hpp"
 
@@ -14,10 +15,9 @@ void KillBehavior::update(GameObject& obj, float deltaTime) {
 	// Nothing
 }
 
-void KillBehavior::onPlayerCollision(GameObject& obj, PlayerObject& player) {
+void KillBehavior::onPlayerCollision(GameObject& obj, PlayerObject& player, GameEvents& events) {
 	DEBUG_ONLY(std::cout << "Player hit kill object!" << std::endl;);
-	// Handle player death
-	player.setShouldDie(true);
+	events.publish(PlayerDiedEvent{DeathCause::KILL_OBJECT, player.getPosition()});
 }
 
 DeathWallBehavior::DeathWallBehavior(GameObject& obj, float acceleration, glm::vec2 startPos, glm::vec2 endPos)
@@ -41,36 +41,63 @@ DeathWallBehavior::DeathWallBehavior(GameObject& obj, float acceleration, glm::v
 	}
 }
 
-void DeathWallBehavior::update(GameObject& obj, float deltaTime) {
+glm::vec2 stepDeathWall(float& velocity, float acceleration, float maxSpeed, const glm::vec2& direction, float deltaTime) {
 	// Compute velocity from acceleration
-	velocity_ += acceleration_ * deltaTime;
+	velocity += acceleration * deltaTime;
 
 	// Apply speed limit if one is set
-	if (maxSpeed_ > 0.0f && velocity_ > maxSpeed_) {
-		velocity_ = maxSpeed_;
+	if (maxSpeed > 0.0f && velocity > maxSpeed) {
+		velocity = maxSpeed;
 	}
 
-	auto currentPos = obj.getPosition();
 	// Simple death wall only moves along one axis; progresses from startPos to
 	// endPos The wall moves in the direction of endPos from startPos, so it may
 	// be either entirely horizontally-moving or entirely vertically-moving
+	return (velocity * deltaTime) * direction;
+}
 
-	currentPos += (velocity_ * deltaTime) * direction_;
-
-	obj.setPosition(currentPos);
+void resetDeathWall(GameObject& obj, float& velocity, const glm::vec2& startPos) {
+	velocity = 0.0f;
+	obj.setPosition(startPos);
+	obj.setVelocity(glm::vec2(0.0f, 0.0f)); // Reset velocity to zero
+}
 
-	// Recompute AABB
-	obj.computeAABB();
+void DeathWallBehavior::update(GameObject& obj, float deltaTime) {
+	obj.offsetPosition(stepDeathWall(velocity_, acceleration_, maxSpeed_, direction_, deltaTime));
 }
 
-void DeathWallBehavior::onPlayerCollision(GameObject& obj, PlayerObject& player) {
+void DeathWallBehavior::onPlayerCollision(GameObject& obj, PlayerObject& player, GameEvents& events) {
 	DEBUG_ONLY(std::cout << "Player hit death wall!" << std::endl;);
-	player.setShouldDie(true);
+	events.publish(PlayerDiedEvent{DeathCause::DEATH_WALL, player.getPosition()});
+}
+
+void DeathWallBehavior::reset(GameObject& obj) { resetDeathWall(obj, velocity_, startPos_); }
+MovingPlatformBehavior::MovingPlatformBehavior(GameObject& obj, float speed, glm::vec2 direction)
+	: speed_(speed), direction_(direction), startPos_(obj.getPosition()) {
+	length_ = glm::length(direction_);
 }
 
-void DeathWallBehavior::reset(GameObject& obj) {
-	velocity_ = 0.0f;
+void MovingPlatformBehavior::update(GameObject& obj, float deltaTime) {
+	if (length_ <= 0.0f || deltaTime <= 0.0f) {
+		obj.setVelocity(glm::vec2(0.0f));
+		return;
+	}
+
+	// Ping-pong along the path; the velocity is whatever this frame's move works out to,
+	// so it stays exact at the turning points
+	progress_ = std::fmod(progress_ + speed_ * deltaTime / length_, 2.0f);
+	float t = progress_ <= 1.0f ? progress_ : 2.0f - progress_;
+	glm::vec2 next = startPos_ + direction_ * t;
+	obj.setVelocity((next - obj.getPosition()) / deltaTime);
+	obj.setPosition(next);
+}
+
+void MovingPlatformBehavior::onPlayerCollision(GameObject& obj, PlayerObject& player, GameEvents& events) {
+	// Nothing - riding is resolved by PlatformSystem, touching a platform is harmless
+}
+
+void MovingPlatformBehavior::reset(GameObject& obj) {
+	progress_ = 0.0f;
 	obj.setPosition(startPos_);
-	obj.setVelocity(glm::vec2(0.0f, 0.0f)); // Reset velocity to zero
-	obj.computeAABB();						// Recompute AABB after resetting position
-}
\ No newline at end of file
+	obj.setVelocity(glm::vec2(0.0f, 0.0f));
+}
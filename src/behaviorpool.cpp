@@ -0,0 +1,104 @@
+#include <algorithm>
+#include <iostream>
+#include "behaviorpool.hpp"
+#include "behavior.hpp"
+#include "debug.hpp"
+
+void BehaviorPools::build(std::vector<GameObject>& objects, const ObjectRegistry& registry) {
+	registry_ = &registry;
+	refs_.assign(registry.getSlotCount(), BehaviorRef());
+	deathWalls_ = DeathWallPool();
+	adapters_.clear();
+	builtCount_ = objects.size();
+	pooledCount_ = 0;
+
+	// One dynamic_cast per object here instead of a virtual call per object per frame
+	for (size_t i = 0; i < objects.size(); ++i) {
+		GameObject& obj = objects[i];
+		Behavior* behavior = obj.getBehavior();
+		ObjectHandle handle = registry.handleAt(static_cast<int>(i));
+		if (handle.index >= refs_.size()) {
+			std::cerr << "BehaviorPools: object " << i << " isn't registered, leaving its behaviour alone" << std::endl;
+			continue;
+		}
+		BehaviorRef& ref = refs_[handle.index];
+		ref.generation = handle.generation;
+		if (!behavior) {
+			ref.kind = BehaviorKind::NONE;
+			continue;
+		} else if (dynamic_cast<IdleBehavior*>(behavior)) {
+			ref.kind = BehaviorKind::IDLE;
+		} else if (dynamic_cast<KillBehavior*>(behavior)) {
+			ref.kind = BehaviorKind::KILL;
+		} else if (auto* wall = dynamic_cast<DeathWallBehavior*>(behavior)) {
+			ref.kind = BehaviorKind::DEATHWALL;
+			deathWalls_.object.push_back(handle);
+			deathWalls_.acceleration.push_back(wall->getAcceleration());
+			deathWalls_.velocity.push_back(0.0f);
+			deathWalls_.maxSpeed.push_back(wall->getMaxSpeed());
+			deathWalls_.startPos.push_back(wall->getStartPos());
+			deathWalls_.direction.push_back(wall->getDirection());
+		} else {
+			ref.kind = BehaviorKind::ADAPTER;
+			adapters_.push_back(handle);
+			continue; // Keeps its Behavior
+		}
+		obj.setBehavior(nullptr);
+		pooledCount_++;
+	}
+}
+
+void BehaviorPools::update(std::vector<GameObject>& objects, const ActivitySet& activity, float deltaTime) {
+	DeathWallPool& walls = deathWalls_;
+	for (size_t i = 0; i < walls.object.size(); ++i) {
+		int index = registry_->indexOf(walls.object[i]);
+		if (index < 0 || !activity.isAwake(index))
+			continue;
+		objects[index].offsetPosition(
+			stepDeathWall(walls.velocity[i], walls.acceleration[i], walls.maxSpeed[i], walls.direction[i], deltaTime));
+	}
+
+	for (ObjectHandle handle : adapters_) {
+		int index = registry_->indexOf(handle);
+		if (index >= 0 && activity.isAwake(index)) {
+			objects[index].updateBehavior(deltaTime);
+		}
+	}
+	// Objects added since build() haven't been sorted into pools yet. Removing objects
+	// swaps built ones down into the holes, so the boundary only moves down.
+	builtCount_ = std::min(builtCount_, objects.size());
+	for (size_t index = builtCount_; index < objects.size(); ++index) {
+		if (activity.isAwake(static_cast<int>(index))) {
+			objects[index].updateBehavior(deltaTime);
+		}
+	}
+}
+
+void BehaviorPools::onPlayerCollision(std::vector<GameObject>& objects, int index, PlayerObject& player, GameEvents& events) {
+	switch (getKind(index)) {
+	case BehaviorKind::KILL:
+		DEBUG_ONLY(std::cout << "Player hit kill object!" << std::endl;);
+		events.publish(PlayerDiedEvent{DeathCause::KILL_OBJECT, player.getPosition()});
+		break;
+	case BehaviorKind::DEATHWALL:
+		DEBUG_ONLY(std::cout << "Player hit death wall!" << std::endl;);
+		events.publish(PlayerDiedEvent{DeathCause::DEATH_WALL, player.getPosition()});
+		break;
+	case BehaviorKind::ADAPTER:
+		objects[index].handlePlayerCollision(player, events);
+		break;
+	case BehaviorKind::NONE:
+	case BehaviorKind::IDLE:
+		break;
+	}
+}
+
+void BehaviorPools::resetDeathWalls(std::vector<GameObject>& objects) {
+	for (size_t i = 0; i < deathWalls_.object.size(); ++i) {
+		GameObject* wall = registry_->resolve(objects, deathWalls_.object[i]);
+		if (wall)
+			resetDeathWall(*wall, deathWalls_.velocity[i], deathWalls_.startPos[i]);
+		else
+			deathWalls_.velocity[i] = 0.0f;
+	}
+}
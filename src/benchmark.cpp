@@ -0,0 +1,2045 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <thread>
+#include "benchmark.hpp"
+#include "globals.hpp"
+#include "physics.hpp"
+#include "aabbbatch.hpp"
+#include "playerobject.hpp"
+#include "tags.hpp"
+#include "tilecollider.hpp"
+#include "scenegraph.hpp"
+#include "events.hpp"
+#include "jobs.hpp"
+#include "helpers.hpp"
+#include "triplebuffer.hpp"
+#include "simthread.hpp"
+#include "levelloader.hpp"
+#include "compiledlevel.hpp"
+#include "tileworld.hpp"
+
+namespace {
+
+// Wall-clock milliseconds taken by fn()
+template <typename Fn>
+double timeMs(Fn&& fn) {
+	auto start = std::chrono::high_resolution_clock::now();
+	fn();
+	auto end = std::chrono::high_resolution_clock::now();
+	return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+void report(const char* name, double ms, size_t count, long checksum) {
+	std::cout << "[Bench] " << name << ": " << count << " in " << ms << " ms (" << (ms * 1.0e6 / count)
+			  << " ns each, checksum " << checksum << ")" << std::endl;
+}
+
+// Random point in an empty tile, so casts start in open space like gameplay queries do
+glm::vec2 randomOpenPoint(const Tilemap& tilemap, std::mt19937& rng) {
+	std::uniform_real_distribution<float> fx(0.0f, tilemap.getWidth() * tilemap.getTileSize());
+	std::uniform_real_distribution<float> fy(0.0f, tilemap.getHeight() * tilemap.getTileSize());
+	while (true) {
+		glm::vec2 p(fx(rng), fy(rng));
+		glm::ivec2 idx = tilemap.worldToTileIndex(p);
+		if (!tilemap.isSolidTile(idx.x, idx.y))
+			return p;
+	}
+}
+
+// Writes a width x height .tmap: solid ground, random ledges and pits, the markers every
+// level needs. Same seed, same file.
+void writeGeneratedLevel(const std::string& path, int width, int height) {
+	std::mt19937 rng(width * 31 + height);
+	std::uniform_int_distribution<int> pick(0, 99);
+	std::vector<std::string> rows(height, std::string(width, '.'));
+	for (int x = 0; x < width; ++x) {
+		rows[0][x] = '#';
+		rows[1][x] = pick(rng) < 3 ? '.' : '#';
+		if (x % 8 == 0 && pick(rng) < 40) {
+			int y = 3 + pick(rng) % std::max(1, height - 6);
+			for (int i = 0; i < 5 && x + i < width; ++i)
+				rows[y][x + i] = '#';
+		}
+	}
+	rows[0][0] = '[';
+	rows[0][width - 1] = ']';
+	rows[2][1] = 'P';
+	rows[2][width - 2] = 'G';
+	std::ofstream file(path);
+	file << width << "\n" << height << "\n";
+	for (int y = height - 1; y >= 0; --y)
+		file << rows[y] << "\n";
+}
+
+// Peak resident set of the process in KB, 0 where /proc isn't there
+long peakRssKb() {
+	std::ifstream status("/proc/self/status");
+	std::string line;
+	while (std::getline(status, line)) {
+		if (line.rfind("VmHWM:", 0) == 0)
+			return std::stol(line.substr(6));
+	}
+	return 0;
+}
+
+} // namespace
+
+void benchTilemapQueries(const Tilemap& tilemap) {
+	const size_t rayCount = 200000;
+	const float T = tilemap.getTileSize();
+	std::mt19937 rng(1234);
+	std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+
+	std::vector<TileRay> rays(rayCount);
+	for (auto& ray : rays) {
+		float a = angle(rng);
+		ray = {randomOpenPoint(tilemap, rng), glm::vec2(std::cos(a), std::sin(a)), 20.0f * T};
+	}
+
+	// Baseline: march each ray in small fixed steps with point lookups, which is what
+	// hand-built probes amount to
+	long marchHits = 0;
+	double marchMs = timeMs([&] {
+		const float step = T / 8.0f;
+		for (const auto& ray : rays) {
+			for (float t = 0.0f; t <= ray.maxDist; t += step) {
+				glm::ivec2 idx = tilemap.worldToTileIndex(ray.origin + ray.dir * t);
+				if (tilemap.isSolidTile(idx.x, idx.y)) {
+					marchHits++;
+					break;
+				}
+			}
+		}
+	});
+	report("point march (T/8 steps)", marchMs, rayCount, marchHits);
+
+	long rayHits = 0;
+	double rayMs = timeMs([&] {
+		for (const auto& ray : rays) {
+			rayHits += tilemap.raycast(ray.origin, ray.dir, ray.maxDist).hit;
+		}
+	});
+	report("raycast", rayMs, rayCount, rayHits);
+
+	std::vector<TileHit> hits;
+	long batchHits = 0;
+	double batchMs = timeMs([&] {
+		tilemap.raycastBatch(rays, hits);
+		for (const auto& hit : hits)
+			batchHits += hit.hit;
+	});
+	report("raycastBatch", batchMs, rayCount, batchHits);
+
+	// Player-sized boxes swept up to 5 tiles in a random direction
+	std::vector<std::pair<AABB, glm::vec2>> sweeps(rayCount);
+	std::uniform_real_distribution<float> dist(0.0f, 5.0f * T);
+	for (auto& sweep : sweeps) {
+		glm::vec2 p = randomOpenPoint(tilemap, rng);
+		float a = angle(rng);
+		float half = T * 0.25f;
+		sweep.first = {p.x - half, p.x + half, p.y + half, p.y - half};
+		sweep.second = glm::vec2(std::cos(a), std::sin(a)) * dist(rng);
+	}
+	long boxHits = 0;
+	double boxMs = timeMs([&] {
+		for (const auto& sweep : sweeps) {
+			boxHits += tilemap.boxcast(sweep.first, sweep.second).hit;
+		}
+	});
+	report("boxcast", boxMs, rayCount, boxHits);
+}
+
+void benchCollisionSpace(const Tilemap& tilemap) {
+	const size_t queryCount = 1000000;
+	const float T = tilemap.getTileSize();
+	// Sensor extents of the default player (scale T, horizontal sensor scale 0.75)
+	const glm::vec2 extents(T * 0.75f / 2.0f + EPSILON, T / 2.0f + EPSILON);
+	std::mt19937 rng(4321);
+
+	CollisionSpace space;
+	double buildMs = timeMs([&] { space.sync(tilemap, SensorLayout::centred(extents)); });
+	report("c-space build", buildMs, 1, space.getRebuildCount());
+
+	std::vector<glm::vec2> points(queryCount);
+	for (auto& p : points)
+		p = randomOpenPoint(tilemap, rng);
+
+	// Baseline: the four per-sensor tile lookups the player resolver does every frame
+	long sensorHits = 0;
+	double sensorMs = timeMs([&] {
+		const glm::vec2 offsets[] = {{-extents.x, 0.0f}, {extents.x, 0.0f}, {0.0f, extents.y}, {0.0f, -extents.y}};
+		for (const auto& p : points) {
+			for (const auto& offset : offsets) {
+				glm::ivec2 idx = tilemap.worldToTileIndex(p + offset);
+				if (tilemap.isSolidTile(idx.x, idx.y)) {
+					sensorHits++;
+					break;
+				}
+			}
+		}
+	});
+	report("4 sensor lookups", sensorMs, queryCount, sensorHits);
+
+	long freeCount = 0;
+	double freeMs = timeMs([&] {
+		for (const auto& p : points)
+			freeCount += space.isFree(p);
+	});
+	report("c-space isFree", freeMs, queryCount, freeCount);
+
+	// Per-frame style sweeps: a quarter tile in a random direction
+	std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+	std::vector<glm::vec2> deltas(queryCount);
+	for (auto& d : deltas) {
+		float a = angle(rng);
+		d = glm::vec2(std::cos(a), std::sin(a)) * (T * 0.25f);
+	}
+	double sweepSum = 0.0;
+	double sweepMs = timeMs([&] {
+		for (size_t i = 0; i < queryCount; ++i)
+			sweepSum += space.sweep(points[i], deltas[i]);
+	});
+	report("c-space sweep", sweepMs, queryCount, static_cast<long>(sweepSum));
+}
+
+void benchTileColliders(const Tilemap& tilemap) {
+	const size_t bodyCount = 4096;
+	const int steps = 600; // 10 seconds at 60 Hz
+	const float T = tilemap.getTileSize();
+	const float dt = 1.0f / 60.0f;
+	std::mt19937 rng(99);
+
+	// Tile-sized walkers with two sensors per side, pacing back and forth
+	SensorLayout layout = SensorLayout::centred(glm::vec2(T * 0.4f, T * 0.5f));
+	layout.sideCount = 2;
+	layout.sideOffsets[0] = -T * 0.3f;
+	layout.sideOffsets[1] = T * 0.3f;
+	layout.footCount = 2;
+	layout.footOffsets[0] = -T * 0.3f;
+	layout.footOffsets[1] = T * 0.3f;
+
+	std::vector<TileCollider> spawn(bodyCount);
+	std::uniform_real_distribution<float> speed(1.0f, 4.0f);
+	for (auto& body : spawn) {
+		body.layout = layout;
+		body.position = fromFloatVec<PhysVec2>(randomOpenPoint(tilemap, rng));
+		body.velocity = fromFloatVec<PhysVec2>(glm::vec2((rng() & 1) ? speed(rng) : -speed(rng), 0.0f));
+	}
+
+	CollisionSpace space;
+	space.sync(tilemap, layout);
+	Physics physics;
+	const CollisionSpace* passes[] = {nullptr, &space};
+	for (const CollisionSpace* culling : passes) {
+		std::vector<TileCollider> bodies = spawn;
+		long grounded = 0;
+		// Bodies spawn in the air, so the first second is mostly falling and the rest walking
+		double fallingMs = 0.0, walkingMs = 0.0;
+		for (int step = 0; step < steps; ++step) {
+			double stepMs = timeMs([&] {
+				physics.stepTileBodies(bodies, tilemap, dt, culling);
+				for (auto& body : bodies) {
+					// Turn around at walls, like a patrolling enemy would
+					if (body.contacts & (CONTACT_LEFT | CONTACT_RIGHT)) {
+						body.velocity.x = fromFloat<PhysReal>((body.contacts & CONTACT_LEFT) ? 2.5f : -2.5f);
+					}
+					grounded += body.grounded;
+				}
+			});
+			(step < 60 ? fallingMs : walkingMs) += stepMs;
+		}
+		report(culling ? "tile colliders (c-space culled)" : "tile colliders", fallingMs + walkingMs, bodyCount * steps, grounded);
+		std::cout << "[Bench]   falling " << fallingMs * 1.0e6 / (bodyCount * 60) << " ns, walking "
+				  << walkingMs * 1.0e6 / (bodyCount * (steps - 60)) << " ns per body-step" << std::endl;
+		const PhysicsStats& stats = physics.getStats();
+		std::cout << "[Bench]   last step: " << stats.bodySubsteps << " sub-steps, max " << stats.maxBodySubsteps << " per body, "
+				  << stats.cappedBodies << " capped" << std::endl;
+	}
+}
+
+void benchSubstepping(const Tilemap& tilemap) {
+	const size_t bodyCount = 4096;
+	const int steps = 120;
+	const float T = tilemap.getTileSize();
+	const float dt = 1.0f / 20.0f; // A long frame, like a hitch, so dashes cover several tiles
+	std::mt19937 rng(2024);
+	std::uniform_real_distribution<float> speed(10.0f, 30.0f);
+
+	std::vector<TileCollider> bodies(bodyCount);
+	for (auto& body : bodies) {
+		body.layout = SensorLayout::centred(glm::vec2(T * 0.375f + EPSILON, T * 0.5f + EPSILON));
+		body.position = fromFloatVec<PhysVec2>(randomOpenPoint(tilemap, rng));
+		body.velocity = fromFloatVec<PhysVec2>(glm::vec2((rng() & 1) ? speed(rng) : -speed(rng), -speed(rng)));
+	}
+
+	Physics physics;
+	long substeps = 0;
+	int maxSubsteps = 0;
+	double ms = timeMs([&] {
+		for (int step = 0; step < steps; ++step) {
+			physics.stepTileBodies(bodies, tilemap, dt);
+			substeps += physics.getStats().bodySubsteps;
+			maxSubsteps = std::max(maxSubsteps, physics.getStats().maxBodySubsteps);
+		}
+	});
+
+	// A body whose centre ended up inside a solid tile tunnelled or got stuck
+	long embedded = 0;
+	for (const auto& body : bodies) {
+		glm::ivec2 idx = tilemap.worldToTileIndex(toFloat(body.position));
+		embedded += tilemap.isSolidTile(idx.x, idx.y);
+	}
+	report("fast bodies (sub-stepped)", ms, bodyCount * steps, embedded);
+	std::cout << "[Bench]   " << (double)substeps / (bodyCount * steps) << " sub-steps per body-step, max " << maxSubsteps
+			  << ", " << embedded << " embedded in solids" << std::endl;
+}
+
+bool benchFixedPoint(const Tilemap& tilemap) {
+	const size_t bodyCount = 2048;
+	const int steps = 640;
+	// 1/60 isn't a Q16.16 number: the fixed run would step 1092/65536 s a frame and fall
+	// behind the float one. 1/64 is exact in both, as are gravity times it and every
+	// velocity below times it, so the two runs only differ by rounding at tile snaps
+	// (tile edges agree to one raw unit, see FixedTileSize).
+	const float dt = 1.0f / 64.0f;
+	const float T = tilemap.getTileSize();
+	const float tolerance = 0.05f * T; // Trajectories within 5% of a tile count as agreeing
+	std::mt19937 rng(31337);
+	std::uniform_real_distribution<float> speed(1.0f, 6.0f);
+
+	// Same spawn for both precisions, on a 1/1024 grid so float holds it exactly too;
+	// velocities are multiples of 1/64 so both start exact
+	std::vector<BasicTileCollider<glm::vec2>> floats(bodyCount);
+	std::vector<BasicTileCollider<FixedVec2>> fixeds(bodyCount);
+	for (size_t i = 0; i < bodyCount; ++i) {
+		glm::vec2 p = glm::round(randomOpenPoint(tilemap, rng) * 1024.0f) / 1024.0f;
+		glm::vec2 v(std::round(speed(rng) * 64.0f) / 64.0f * ((rng() & 1) ? 1.0f : -1.0f), 0.0f);
+		floats[i].layout = SensorLayout::centred(glm::vec2(T * 0.375f + EPSILON, T * 0.5f + EPSILON));
+		floats[i].position = p;
+		floats[i].velocity = v;
+		fixeds[i].layout = floats[i].layout;
+		fixeds[i].position = FixedVec2::fromFloat(p);
+		fixeds[i].velocity = FixedVec2::fromFloat(v);
+	}
+
+	Physics physics;
+	double floatMs = 0.0, fixedMs = 0.0;
+	float maxError = 0.0f;
+	double errorSum = 0.0;
+	std::vector<char> diverged(bodyCount, 0);
+	for (int step = 0; step < steps; ++step) {
+		floatMs += timeMs([&] { physics.stepTileBodies(floats, tilemap, dt); });
+		fixedMs += timeMs([&] { physics.stepTileBodies(fixeds, tilemap, dt); });
+		for (size_t i = 0; i < bodyCount; ++i) {
+			// Walk in the same direction after a wall hit, like a patrolling enemy
+			if (floats[i].contacts & (CONTACT_LEFT | CONTACT_RIGHT)) {
+				floats[i].velocity.x = (floats[i].contacts & CONTACT_LEFT) ? 2.5f : -2.5f;
+			}
+			if (fixeds[i].contacts & (CONTACT_LEFT | CONTACT_RIGHT)) {
+				fixeds[i].velocity.x = Fixed::fromFloat((fixeds[i].contacts & CONTACT_LEFT) ? 2.5f : -2.5f);
+			}
+			float error = glm::length(floats[i].position - fixeds[i].position.toFloat());
+			maxError = std::max(maxError, error);
+			errorSum += error;
+			diverged[i] |= error > tolerance;
+		}
+	}
+	report("float tile bodies", floatMs, bodyCount * steps, 0);
+	report("fixed-point tile bodies", fixedMs, bodyCount * steps, 0);
+
+	long divergedCount = std::count(diverged.begin(), diverged.end(), 1);
+	std::cout << "[Bench]   float vs fixed: mean error " << errorSum / (bodyCount * steps) / T << " tiles, max "
+			  << maxError / T << " tiles, " << divergedCount << "/" << bodyCount << " bodies ever beyond "
+			  << tolerance / T << " tiles" << std::endl;
+	const bool agree = divergedCount == 0;
+	if (!agree) {
+		std::cerr << "[Bench] FAILED: " << divergedCount << " fixed-point bodies left the float trajectory by more than "
+				  << tolerance / T << " tiles (max " << maxError / T << ")" << std::endl;
+	}
+
+	// FNV-1a over the raw fixed-point state: identical across builds, flags and machines
+	uint64_t hash = 1469598103934665603ull;
+	auto mix = [&hash](int32_t v) {
+		for (int b = 0; b < 4; ++b) {
+			hash = (hash ^ ((static_cast<uint32_t>(v) >> (8 * b)) & 0xFF)) * 1099511628211ull;
+		}
+	};
+	for (const auto& body : fixeds) {
+		mix(body.position.x.raw);
+		mix(body.position.y.raw);
+		mix(body.velocity.x.raw);
+		mix(body.velocity.y.raw);
+	}
+	std::cout << "[Bench]   fixed-point state hash " << std::hex << hash << std::dec << std::endl;
+	return agree;
+}
+
+void benchActivity(const Tilemap& tilemap) {
+	const size_t objectCount = 20000;
+	const int warmupFrames = 120; // Long enough for still objects to fall asleep
+	const int frames = 300;
+	const float dt = 1.0f / 60.0f;
+	const float T = tilemap.getTileSize();
+	std::mt19937 rng(777);
+
+	// Mostly stationary pickups/hazards with under one percent drifting around
+	std::vector<glm::vec2> spawn(objectCount);
+	for (auto& p : spawn)
+		p = randomOpenPoint(tilemap, rng);
+	auto makeObjects = [&] {
+		std::vector<GameObject> objects(objectCount);
+		for (size_t i = 0; i < objectCount; ++i) {
+			objects[i].setPosition(spawn[i]);
+			objects[i].setScale(glm::vec2(T * 0.5f));
+			objects[i].setBehavior(std::make_unique<IdleBehavior>());
+			if (i % 128 == 0) {
+				objects[i].setVelocity(glm::vec2(1.0f, 0.0f));
+			}
+		}
+		return objects;
+	};
+	PlayerObject player;
+	player.setScale(glm::vec2(T));
+	auto movePlayer = [&](int frame) { player.setPosition(glm::vec2(frame * 0.1f * T, tilemap.getHeight() * T * 0.5f)); };
+	auto step = [&](GameObject& obj) {
+		obj.updateBehavior(dt);
+		if (obj.getVelocity() != glm::vec2(0.0f)) {
+			obj.applyVelocity(dt);
+		}
+	};
+
+	// Baseline: touch every object every frame
+	std::vector<GameObject> objects = makeObjects();
+	long hits = 0;
+	auto allFrame = [&](int frame) {
+		movePlayer(frame);
+		for (auto& obj : objects)
+			step(obj);
+		for (const auto& obj : objects)
+			hits += checkCollision(player.getAABB(), obj.getAABB());
+	};
+	for (int frame = 0; frame < warmupFrames; ++frame)
+		allFrame(frame);
+	double allMs = timeMs([&] {
+		for (int frame = warmupFrames; frame < warmupFrames + frames; ++frame)
+			allFrame(frame);
+	});
+	report("all objects per frame", allMs, objectCount * frames, hits);
+
+	objects = makeObjects();
+	ActivitySet activity;
+	long activeHits = 0;
+	std::vector<int> touched;
+	auto activeFrame = [&](int frame) {
+		movePlayer(frame);
+		for (int index : activity.getActive())
+			step(objects[index]);
+		const float reach = WAKE_RADIUS * T;
+		const AABB& box = player.getAABB();
+		activity.update(objects, dt, {box.left - reach, box.right + reach, box.top + reach, box.bottom - reach});
+		// Same kill check as Physics::checkPlayerEntityCollisions
+		touched.clear();
+		activeHits += overlapIndices(player.getAABB(), activity.getActiveBoxes(), touched);
+	};
+	activity.update(objects, 0.0f, player.getAABB()); // Registers every object as awake
+	for (int frame = 0; frame < warmupFrames; ++frame)
+		activeFrame(frame);
+	double activeMs = timeMs([&] {
+		for (int frame = warmupFrames; frame < warmupFrames + frames; ++frame)
+			activeFrame(frame);
+	});
+	report("active set per frame", activeMs, objectCount * frames, activeHits);
+	std::cout << "[Bench]   " << activity.getActiveCount() << " active, " << activity.getSleepingCount() << " sleeping"
+			  << std::endl;
+}
+
+void benchPlatforms(const Tilemap& tilemap) {
+	const int platformCount = 500;
+	const size_t bodyCount = 2048;
+	const int frames = 120;
+	const float dt = 1.0f / 60.0f;
+	const float T = tilemap.getTileSize();
+	std::mt19937 rng(4242);
+	std::uniform_int_distribution<int> travelTiles(2, 6);
+
+	std::vector<glm::vec2> platformSpawn(platformCount), platformTravel(platformCount);
+	for (int i = 0; i < platformCount; ++i) {
+		platformSpawn[i] = randomOpenPoint(tilemap, rng);
+		float distance = travelTiles(rng) * T;
+		platformTravel[i] = (i & 1) ? glm::vec2(distance, 0.0f) : glm::vec2(0.0f, distance);
+	}
+	// Half the walkers start on a platform, the rest anywhere
+	const glm::vec2 extents(T * 0.375f + EPSILON, T * 0.5f + EPSILON);
+	std::vector<glm::vec2> bodySpawn(bodyCount);
+	for (size_t i = 0; i < bodyCount; ++i) {
+		const glm::vec2& platform = platformSpawn[i % platformCount];
+		bodySpawn[i] = (i & 1) ? randomOpenPoint(tilemap, rng)
+							   : platform + glm::vec2(0.0f, PLATFORM_THICKNESS * T / 2.0f + extents.y);
+	}
+
+	auto makePlatforms = [&](PlatformSystem& platforms) {
+		platforms.clear();
+		for (int i = 0; i < platformCount; ++i)
+			platforms.add(platformSpawn[i], glm::vec2(3.0f * T, PLATFORM_THICKNESS * T), platformTravel[i], PLATFORM_SPEED);
+	};
+	auto makeBodies = [&] {
+		std::vector<TileCollider> bodies(bodyCount);
+		for (size_t i = 0; i < bodyCount; ++i) {
+			bodies[i].layout = SensorLayout::centred(extents);
+			bodies[i].position = fromFloatVec<PhysVec2>(bodySpawn[i]);
+			bodies[i].velocity = fromFloatVec<PhysVec2>(glm::vec2((i & 2) ? 1.5f : -1.5f, 0.0f));
+		}
+		return bodies;
+	};
+	auto feet = [&](const TileCollider& body) {
+		glm::vec2 p = toFloat(body.position);
+		return AABB{p.x - extents.x, p.x + extents.x, p.y + extents.y, p.y - extents.y};
+	};
+	auto land = [&](TileCollider& body, float lift) {
+		body.position.y += fromFloat<PhysReal>(lift);
+		body.velocity.y = fromFloat<PhysReal>(0.0f);
+		body.grounded = true;
+	};
+	Physics physics;
+	std::vector<float> prevBottom(bodyCount);
+
+	// Baseline: every body re-tests every platform, once to find what carries it and once
+	// to land after its step
+	PlatformSystem naive;
+	makePlatforms(naive);
+	std::vector<TileCollider> bodies = makeBodies();
+	std::vector<glm::vec2> before(platformCount), delta(platformCount);
+	long naiveRiders = 0;
+	double naiveMs = timeMs([&] {
+		for (int frame = 0; frame < frames; ++frame) {
+			for (int i = 0; i < platformCount; ++i)
+				before[i] = naive.getObjects()[i].getPosition();
+			naive.step(dt);
+			for (int i = 0; i < platformCount; ++i)
+				delta[i] = naive.getObjects()[i].getPosition() - before[i];
+			for (size_t b = 0; b < bodyCount; ++b) {
+				AABB box = feet(bodies[b]);
+				for (int i = 0; i < platformCount; ++i) {
+					const AABB& top = naive.getObjects()[i].getAABB();
+					float prevTop = top.top - delta[i].y;
+					if (box.right > top.left && box.left < top.right && std::abs(box.bottom - prevTop) <= PLATFORM_SNAP) {
+						bodies[b].position += fromFloatVec<PhysVec2>(delta[i]);
+						break;
+					}
+				}
+				prevBottom[b] = feet(bodies[b]).bottom;
+			}
+			physics.stepTileBodies(bodies, tilemap, dt);
+			for (size_t b = 0; b < bodyCount; ++b) {
+				if (toFloat(bodies[b].velocity.y) > 0.0f)
+					continue;
+				AABB box = feet(bodies[b]);
+				float bestTop = -1.0e9f;
+				for (int i = 0; i < platformCount; ++i) {
+					const AABB& top = naive.getObjects()[i].getAABB();
+					if (box.right > top.left && box.left < top.right && prevBottom[b] >= top.top - delta[i].y - PLATFORM_SNAP &&
+						box.bottom <= top.top + PLATFORM_SNAP && top.top > bestTop) {
+						bestTop = top.top;
+					}
+				}
+				if (bestTop > -1.0e9f) {
+					land(bodies[b], bestTop - box.bottom);
+					naiveRiders++;
+				}
+			}
+		}
+	});
+	report("platform riders, all pairs", naiveMs, bodyCount * frames, naiveRiders);
+
+	PlatformSystem platforms;
+	makePlatforms(platforms);
+	bodies = makeBodies();
+	long riders = 0, ridden = 0;
+	double cachedMs = timeMs([&] {
+		for (int frame = 0; frame < frames; ++frame) {
+			platforms.step(dt);
+			for (size_t b = 0; b < bodyCount; ++b) {
+				bodies[b].position += fromFloatVec<PhysVec2>(platforms.carry(static_cast<int>(b)));
+				prevBottom[b] = feet(bodies[b]).bottom;
+			}
+			physics.stepTileBodies(bodies, tilemap, dt);
+			for (size_t b = 0; b < bodyCount; ++b) {
+				float lift = 0.0f;
+				if (platforms.settle(static_cast<int>(b), feet(bodies[b]), prevBottom[b], toFloat(bodies[b].velocity.y), lift)) {
+					land(bodies[b], lift);
+					riders++;
+				}
+			}
+			ridden += platforms.getRiddenCount();
+		}
+	});
+	report("platform riders, contact cache", cachedMs, bodyCount * frames, riders);
+	std::cout << "[Bench]   " << platformCount << " platforms, " << (double)ridden / frames << " ridden per frame on average"
+			  << std::endl;
+}
+
+void benchAABBBatch(const Tilemap& tilemap) {
+	const size_t boxCount = 4096;
+	const size_t queryCount = 20000;
+	const float T = tilemap.getTileSize();
+	std::mt19937 rng(9001);
+	std::uniform_real_distribution<float> size(0.25f * T, 2.0f * T);
+
+	// Object-sized boxes scattered over the level, queried with player-sized boxes
+	auto randomBox = [&](float scale) {
+		glm::vec2 centre = randomOpenPoint(tilemap, rng);
+		glm::vec2 half = glm::vec2(size(rng), size(rng)) * scale * 0.5f;
+		return AABB{centre.x - half.x, centre.x + half.x, centre.y + half.y, centre.y - half.y};
+	};
+	std::vector<AABB> boxes(boxCount);
+	AABBBatch batch;
+	batch.reserve(boxCount);
+	for (auto& box : boxes) {
+		box = randomBox(1.0f);
+		batch.push(box);
+	}
+	std::vector<AABB> queries(queryCount);
+	for (auto& query : queries)
+		query = randomBox(4.0f);
+
+	// Baseline: the scalar checkCollision against every box, compacting hits the same way
+	std::vector<int> hits;
+	hits.reserve(boxCount);
+	long scalarHits = 0;
+	double scalarMs = timeMs([&] {
+		for (const auto& query : queries) {
+			hits.clear();
+			for (size_t i = 0; i < boxCount; ++i) {
+				if (checkCollision(query, boxes[i]))
+					hits.push_back(static_cast<int>(i));
+			}
+			scalarHits += hits.size();
+		}
+	});
+	report("AABB checkCollision loop", scalarMs, boxCount * queryCount, scalarHits);
+
+	SimdLevel detected = getSimdLevel();
+	for (SimdLevel level : {SimdLevel::SCALAR, SimdLevel::SSE2, SimdLevel::AVX}) {
+		if (static_cast<int>(level) > static_cast<int>(detectSimdLevel()))
+			continue;
+		setSimdLevel(level);
+		long batchHits = 0;
+		double ms = timeMs([&] {
+			for (const auto& query : queries) {
+				hits.clear();
+				batchHits += overlapIndices(query, batch, hits);
+			}
+		});
+		std::string name = std::string("AABB batch kernel (") + simdLevelName(level) + ")";
+		report(name.c_str(), ms, boxCount * queryCount, batchHits);
+	}
+	setSimdLevel(detected);
+	std::cout << "[Bench]   runtime dispatch picks " << simdLevelName(detected) << std::endl;
+}
+
+void benchTriggers(const Tilemap& tilemap) {
+	const int triggerCount = 20000;
+	const int frames = 5000;
+	const float T = tilemap.getTileSize();
+	std::mt19937 rng(5150);
+	std::uniform_real_distribution<float> size(0.5f * T, 3.0f * T);
+
+	TriggerSystem triggers;
+	AABBBatch batch;
+	for (int i = 0; i < triggerCount; ++i) {
+		glm::vec2 p = randomOpenPoint(tilemap, rng);
+		AABB box = {p.x, p.x + size(rng), p.y + size(rng), p.y};
+		triggers.add(TriggerType::SCRIPTED, box);
+		batch.push(box);
+	}
+	// The player sweeps diagonally across the level
+	glm::vec2 extent(tilemap.getWidth() * T, tilemap.getHeight() * T);
+	auto playerBox = [&](int frame) {
+		glm::vec2 p = glm::vec2(std::fmod(frame * 0.11f, extent.x), std::fmod(frame * 0.037f, extent.y));
+		return AABB{p.x - 0.4f * T, p.x + 0.4f * T, p.y + 0.5f * T, p.y - 0.5f * T};
+	};
+
+	// Baselines only find the overlap set; events come on top of that
+	std::vector<int> inside;
+	long pairHits = 0;
+	double pairMs = timeMs([&] {
+		for (int frame = 0; frame < frames; ++frame) {
+			AABB box = playerBox(frame);
+			inside.clear();
+			for (int i = 0; i < triggerCount; ++i) {
+				if (checkCollision(box, triggers.getTrigger(i).box))
+					inside.push_back(i);
+			}
+			pairHits += inside.size();
+		}
+	});
+	report("triggers, all pairs", pairMs, frames, pairHits);
+
+	long batchHits = 0;
+	double batchMs = timeMs([&] {
+		for (int frame = 0; frame < frames; ++frame) {
+			inside.clear();
+			batchHits += overlapIndices(playerBox(frame), batch, inside);
+		}
+	});
+	report("triggers, SIMD all pairs", batchMs, frames, batchHits);
+
+	long gridHits = 0, tested = 0, events = 0;
+	double gridMs = timeMs([&] {
+		for (int frame = 0; frame < frames; ++frame) {
+			triggers.update(playerBox(frame));
+			gridHits += triggers.getInsideCount();
+			tested += triggers.getTestedCount();
+			events += triggers.getEvents().size();
+		}
+	});
+	report("triggers, grid + events", gridMs, frames, gridHits);
+	std::cout << "[Bench]   " << triggerCount << " triggers, " << (double)tested / frames << " tested and "
+			  << (double)events / frames << " events per frame" << std::endl;
+}
+
+void benchBehaviors(const Tilemap& tilemap) {
+	const size_t objectCount = 20000;
+	const int frames = 300;
+	const float dt = 1.0f / 60.0f;
+	const float T = tilemap.getTileSize();
+	std::mt19937 rng(3030);
+
+	// Thousands of hazards, a few death walls and one-off behaviours, all awake
+	auto makeObjects = [&] {
+		std::mt19937 spawnRng(3031);
+		std::vector<GameObject> objects(objectCount);
+		for (size_t i = 0; i < objectCount; ++i) {
+			objects[i].setPosition(randomOpenPoint(tilemap, spawnRng));
+			objects[i].setScale(glm::vec2(T * 0.5f));
+			if (i % 1000 == 0) {
+				glm::vec2 start = objects[i].getPosition();
+				objects[i].setBehavior(std::make_unique<DeathWallBehavior>(objects[i], 0.5f, start, start + glm::vec2(10.0f, 0.0f), 4.0f));
+			} else if (i % 1000 == 1) {
+				objects[i].setBehavior(std::make_unique<MovingPlatformBehavior>(objects[i], 2.0f, glm::vec2(3.0f, 0.0f)));
+			} else {
+				objects[i].setBehavior(std::make_unique<KillBehavior>());
+			}
+		}
+		return objects;
+	};
+	PlayerObject player;
+	std::uniform_int_distribution<int> pick(0, static_cast<int>(objectCount) - 1);
+	std::vector<int> touched(objectCount / 10);
+	for (auto& index : touched)
+		index = pick(rng);
+
+	// Baseline: a virtual update per object, and a virtual collision call per contact
+	std::vector<GameObject> objects = makeObjects();
+	GameEvents events;
+	double virtualMs = timeMs([&] {
+		for (int frame = 0; frame < frames; ++frame) {
+			for (auto& obj : objects)
+				obj.updateBehavior(dt);
+			for (int index : touched)
+				objects[index].handlePlayerCollision(player, events);
+			events.discard();
+		}
+	});
+	long virtualSum = 0;
+	for (const auto& obj : objects)
+		virtualSum += static_cast<long>(obj.getPosition().x * 16.0f);
+	report("virtual behaviors", virtualMs, objectCount * frames, virtualSum);
+
+	objects = makeObjects();
+	ActivitySet activity;
+	activity.update(objects, 0.0f, {-1.0e9f, 1.0e9f, 1.0e9f, -1.0e9f}); // Everything awake
+	ObjectRegistry registry;
+	registry.sync(objects);
+	BehaviorPools behaviors;
+	behaviors.build(objects, registry);
+	double pooledMs = timeMs([&] {
+		for (int frame = 0; frame < frames; ++frame) {
+			behaviors.update(objects, activity, dt);
+			for (int index : touched)
+				behaviors.onPlayerCollision(objects, index, player, events);
+			events.discard();
+		}
+	});
+	long pooledSum = 0;
+	for (const auto& obj : objects)
+		pooledSum += static_cast<long>(obj.getPosition().x * 16.0f);
+	report("type-pooled behaviors", pooledMs, objectCount * frames, pooledSum);
+	std::cout << "[Bench]   " << behaviors.getPooledCount() << " pooled, " << behaviors.getAdapterCount() << " adapters"
+			  << std::endl;
+}
+
+void benchHandles(const Tilemap& tilemap) {
+	const size_t objectCount = 20000;
+	const int queries = 20000;
+	std::mt19937 rng(3131);
+
+	// A level's worth of named objects with the one we want at the end, as main.cpp's death
+	// wall would be once other objects are spawned before it
+	const char* names[] = {"Spike", "Coin", "Crate", "Lamp", "Enemy"};
+	std::vector<GameObject> objects(objectCount);
+	for (size_t i = 0; i < objectCount; ++i) {
+		objects[i].setPosition(randomOpenPoint(tilemap, rng));
+		objects[i].setName(names[i % 5]);
+	}
+	objects.back().setName("DeathWall");
+	ObjectRegistry registry;
+	registry.sync(objects);
+
+	// Baseline: scan comparing names (fewer queries, it's that slow)
+	const int scanQueries = queries / 40;
+	long stringSum = 0;
+	double stringMs = timeMs([&] {
+		for (int q = 0; q < scanQueries; ++q) {
+			for (size_t i = 0; i < objects.size(); ++i) {
+				if (objects[i].getName() == "DeathWall") {
+					stringSum += static_cast<long>(i);
+					break;
+				}
+			}
+		}
+	});
+	report("name scan (string compare)", stringMs, scanQueries, stringSum);
+
+	TagId wallTag = internTag("DeathWall");
+	long tagSum = 0;
+	double tagMs = timeMs([&] {
+		for (int q = 0; q < queries; ++q) {
+			tagSum += registry.indexOf(registry.findFirst(wallTag));
+		}
+	});
+	report("tag lookup", tagMs, queries, tagSum);
+
+	ObjectHandle wall = registry.findFirst(wallTag);
+	long handleSum = 0;
+	double handleMs = timeMs([&] {
+		for (int q = 0; q < queries; ++q) {
+			handleSum += registry.indexOf(wall);
+		}
+	});
+	report("cached handle resolve", handleMs, queries, handleSum);
+
+	// Handles have to survive other objects being removed; indices don't
+	int removed = 0;
+	for (int i = 0; i < 1000; ++i) {
+		std::uniform_int_distribution<int> pick(0, static_cast<int>(objects.size()) - 1);
+		ObjectHandle victim = registry.handleAt(pick(rng));
+		if (victim != wall) {
+			registry.remove(objects, victim);
+			removed++;
+		}
+	}
+	const GameObject* resolved = registry.resolve(objects, wall);
+	std::cout << "[Bench]   after " << removed << " removals the cached handle resolves to "
+			  << (resolved ? resolved->getName() : std::string("nothing")) << std::endl;
+}
+
+void benchTransforms(const Tilemap& tilemap) {
+	const size_t objectCount = 20000;
+	const int frames = 300;
+	const int moves = 4; // Resolver/applyVelocity nudges per moving object per frame
+	const float T = tilemap.getTileSize();
+	std::mt19937 rng(4040);
+
+	// One object in ten moves each frame; all of them are collided against and drawn
+	std::vector<glm::vec2> spawn(objectCount);
+	for (auto& p : spawn)
+		p = randomOpenPoint(tilemap, rng);
+	const glm::vec2 nudge(0.001f * T, 0.0005f * T);
+
+	// Baseline: the old eager path, AABB redone on every setter and a fresh mat4 per draw
+	struct EagerObject {
+			glm::vec2 position, scale;
+			float rotation;
+			AABB aabb;
+			void computeAABB() {
+				glm::vec2 half = scale / 2.0f;
+				aabb = {position.x - half.x, position.x + half.x, position.y + half.y, position.y - half.y};
+			}
+			glm::mat4 modelMatrix() const {
+				glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(position, 0.0f));
+				model = glm::rotate(model, rotation, glm::vec3(0.0f, 0.0f, 1.0f));
+				return glm::scale(model, glm::vec3(scale, 1.0f));
+			}
+	};
+	std::vector<EagerObject> eager(objectCount);
+	for (size_t i = 0; i < objectCount; ++i) {
+		eager[i] = {spawn[i], glm::vec2(T * 0.5f), 0.0f, AABB()};
+		eager[i].computeAABB();
+	}
+	// Both paths hand every matrix to a submission buffer, like drawQuad does
+	std::vector<glm::mat4> submitted(objectCount);
+	auto checksumModels = [&] {
+		double sum = 0.0;
+		for (const auto& model : submitted)
+			sum += model[0][0] + model[1][1] + model[3][0] + model[3][1];
+		return sum;
+	};
+	double eagerSum = 0.0;
+	double eagerMs = timeMs([&] {
+		for (int frame = 0; frame < frames; ++frame) {
+			for (size_t i = 0; i < objectCount; i += 10) {
+				for (int m = 0; m < moves; ++m) {
+					eager[i].position += nudge;
+					eager[i].computeAABB();
+				}
+			}
+			for (size_t i = 0; i < objectCount; ++i) {
+				submitted[i] = eager[i].modelMatrix();
+				eagerSum += eager[i].aabb.left;
+			}
+		}
+	});
+	eagerSum += checksumModels();
+	report("eager AABB + mat4 per draw", eagerMs, objectCount * frames, static_cast<long>(eagerSum));
+
+	std::vector<GameObject> objects(objectCount);
+	for (size_t i = 0; i < objectCount; ++i) {
+		objects[i].setPosition(spawn[i]);
+		objects[i].setScale(glm::vec2(T * 0.5f));
+	}
+	double lazySum = 0.0;
+	double lazyMs = timeMs([&] {
+		for (int frame = 0; frame < frames; ++frame) {
+			for (size_t i = 0; i < objectCount; i += 10) {
+				for (int m = 0; m < moves; ++m) {
+					objects[i].offsetPosition(nudge);
+				}
+			}
+			for (size_t i = 0; i < objectCount; ++i) {
+				submitted[i] = objects[i].getModelMatrix();
+				lazySum += objects[i].getAABB().left;
+			}
+		}
+	});
+	lazySum += checksumModels();
+	report("lazy cached transforms", lazyMs, objectCount * frames, static_cast<long>(lazySum));
+}
+
+void benchTransform2D(const Tilemap& tilemap) {
+	const size_t quadCount = 100000;
+	const int frames = 50;
+	const float T = tilemap.getTileSize();
+	std::mt19937 rng(4141);
+	std::uniform_real_distribution<float> angle(-3.14159f, 3.14159f);
+	std::uniform_real_distribution<float> size(0.25f * T, 2.0f * T);
+
+	struct Placement {
+			glm::vec2 position, scale;
+			float rotation;
+	};
+	std::vector<Placement> placements(quadCount);
+	for (auto& p : placements)
+		p = {randomOpenPoint(tilemap, rng), glm::vec2(size(rng), size(rng)), angle(rng)};
+	glm::mat4 proj = glm::ortho(0.0f, 16.0f, 0.0f, 9.0f, -1.0f, 1.0f);
+	glm::mat4 view = glm::translate(glm::mat4(1.0f), glm::vec3(-3.0f, -1.0f, 0.0f));
+
+	// What drawQuad used to do per quad: build the model with translate/rotate/scale, then
+	// proj * view * model
+	std::vector<glm::mat4> mvps(quadCount);
+	double mat4Ms = timeMs([&] {
+		for (int frame = 0; frame < frames; ++frame) {
+			for (size_t i = 0; i < quadCount; ++i) {
+				const Placement& p = placements[i];
+				glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(p.position, 0.0f));
+				model = glm::rotate(model, p.rotation, glm::vec3(0.0f, 0.0f, 1.0f));
+				model = glm::scale(model, glm::vec3(p.scale, 1.0f));
+				mvps[i] = proj * view * model;
+			}
+		}
+	});
+	double mat4Sum = 0.0;
+	for (const auto& m : mvps)
+		mat4Sum += m[0][0] + m[1][0] + m[3][0] + m[3][1];
+	report("mat4 model + MVP", mat4Ms, quadCount * frames, static_cast<long>(mat4Sum * 1000.0));
+
+	glm::mat4 viewProj = proj * view;
+	double affineMs = timeMs([&] {
+		for (int frame = 0; frame < frames; ++frame) {
+			for (size_t i = 0; i < quadCount; ++i) {
+				const Placement& p = placements[i];
+				mvps[i] = mulAffine(viewProj, Transform2D::fromTRS(p.position, p.rotation, p.scale));
+			}
+		}
+	});
+	double affineSum = 0.0;
+	for (const auto& m : mvps)
+		affineSum += m[0][0] + m[1][0] + m[3][0] + m[3][1];
+	report("Transform2D + MVP", affineMs, quadCount * frames, static_cast<long>(affineSum * 1000.0));
+
+	// Batched corners: world-space quad vertices for the batcher from a cached transform
+	std::vector<Transform2D> transforms(quadCount);
+	for (size_t i = 0; i < quadCount; ++i)
+		transforms[i] = Transform2D::fromTRS(placements[i].position, placements[i].rotation, placements[i].scale);
+	std::vector<glm::mat4> models(quadCount);
+	for (size_t i = 0; i < quadCount; ++i)
+		models[i] = transforms[i].toMat4();
+	std::vector<glm::vec2> corners(quadCount * 4);
+	const glm::vec4 unitCorners[4] = {{-0.5f, -0.5f, 0.0f, 1.0f}, {0.5f, -0.5f, 0.0f, 1.0f}, {0.5f, 0.5f, 0.0f, 1.0f}, {-0.5f, 0.5f, 0.0f, 1.0f}};
+	double mat4CornerMs = timeMs([&] {
+		for (int frame = 0; frame < frames; ++frame) {
+			for (size_t i = 0; i < quadCount; ++i) {
+				for (int c = 0; c < 4; ++c)
+					corners[i * 4 + c] = glm::vec2(models[i] * unitCorners[c]);
+			}
+		}
+	});
+	double mat4CornerSum = 0.0;
+	for (const auto& c : corners)
+		mat4CornerSum += c.x + c.y;
+	report("quad corners via mat4", mat4CornerMs, quadCount * frames, static_cast<long>(mat4CornerSum));
+
+	double cornerMs = timeMs([&] {
+		for (int frame = 0; frame < frames; ++frame)
+			transformQuadCorners(transforms.data(), quadCount, corners.data());
+	});
+	double cornerSum = 0.0;
+	for (const auto& c : corners)
+		cornerSum += c.x + c.y;
+	report("quad corners via Transform2D", cornerMs, quadCount * frames, static_cast<long>(cornerSum));
+
+	// Round trip through compose and inverse
+	float maxError = 0.0f;
+	for (size_t i = 0; i < quadCount; i += 97) {
+		Transform2D roundTrip = transforms[i].inverse() * (transforms[i] * transforms[(i + 1) % quadCount]);
+		glm::vec2 p = placements[i].position;
+		glm::vec2 expected = transforms[(i + 1) % quadCount].apply(p);
+		maxError = std::max(maxError, glm::length(roundTrip.apply(p) - expected));
+	}
+	std::cout << "[Bench]   inverse * compose round trip max error " << maxError << std::endl;
+}
+
+void benchSceneGraph(const Tilemap& tilemap) {
+	const int rootCount = 1000;
+	const int childrenPerRoot = 20; // Each child carries 4 grandchildren: 101 nodes per tree
+	const int frames = 300;
+	const float T = tilemap.getTileSize();
+	std::mt19937 rng(4242);
+	std::uniform_int_distribution<int> pickRoot(0, rootCount - 1);
+	std::uniform_real_distribution<float> offset(-T, T);
+
+	// A level's moving things (platforms, walls) with attached hazards and effects; 1 in 100
+	// of them moves each frame
+	std::vector<glm::vec2> rootPos(rootCount);
+	for (auto& p : rootPos)
+		p = randomOpenPoint(tilemap, rng);
+	std::vector<Transform2D> childLocal(childrenPerRoot * 5);
+	for (auto& local : childLocal)
+		local = Transform2D::translation(glm::vec2(offset(rng), offset(rng)));
+	std::vector<std::vector<int>> moves(frames);
+	for (auto& frameMoves : moves) {
+		for (int i = 0; i < rootCount / 100; ++i)
+			frameMoves.push_back(pickRoot(rng));
+	}
+
+	// Baseline: pointer tree, every world transform recomputed recursively each frame
+	struct TreeNode {
+			Transform2D local, world;
+			std::vector<std::unique_ptr<TreeNode>> children;
+	};
+	std::vector<std::unique_ptr<TreeNode>> roots;
+	for (int r = 0; r < rootCount; ++r) {
+		auto root = std::make_unique<TreeNode>();
+		root->local = Transform2D::translation(rootPos[r]);
+		for (int c = 0; c < childrenPerRoot; ++c) {
+			auto child = std::make_unique<TreeNode>();
+			child->local = childLocal[c * 5];
+			for (int g = 1; g < 5; ++g) {
+				auto grandchild = std::make_unique<TreeNode>();
+				grandchild->local = childLocal[c * 5 + g];
+				child->children.push_back(std::move(grandchild));
+			}
+			root->children.push_back(std::move(child));
+		}
+		roots.push_back(std::move(root));
+	}
+	std::function<void(TreeNode&, const Transform2D&)> recompute = [&](TreeNode& node, const Transform2D& parent) {
+		node.world = parent * node.local;
+		for (auto& child : node.children)
+			recompute(*child, node.world);
+	};
+	const size_t nodeCount = static_cast<size_t>(rootCount) * (1 + childrenPerRoot * 5);
+	double treeMs = timeMs([&] {
+		for (int frame = 0; frame < frames; ++frame) {
+			for (int r : moves[frame])
+				roots[r]->local.tx += 0.01f;
+			for (auto& root : roots)
+				recompute(*root, Transform2D());
+		}
+	});
+	double treeSum = 0.0;
+	for (auto& root : roots)
+		treeSum += root->children.back()->children.back()->world.tx;
+	report("pointer tree, full recompute", treeMs, nodeCount * frames, static_cast<long>(treeSum * 100.0));
+
+	SceneGraph scene;
+	std::vector<SceneNode> rootNodes, lastLeaf;
+	for (int r = 0; r < rootCount; ++r) {
+		SceneNode root = scene.create(Transform2D::translation(rootPos[r]));
+		SceneNode leaf = NO_NODE;
+		for (int c = 0; c < childrenPerRoot; ++c) {
+			SceneNode child = scene.create(childLocal[c * 5], root);
+			for (int g = 1; g < 5; ++g)
+				leaf = scene.create(childLocal[c * 5 + g], child);
+		}
+		rootNodes.push_back(root);
+		lastLeaf.push_back(leaf);
+	}
+	scene.update();
+	long updated = 0;
+	double sceneMs = timeMs([&] {
+		for (int frame = 0; frame < frames; ++frame) {
+			for (int r : moves[frame]) {
+				Transform2D local = scene.getLocal(rootNodes[r]);
+				local.tx += 0.01f;
+				scene.setLocal(rootNodes[r], local);
+			}
+			scene.update();
+			updated += scene.getUpdatedCount();
+		}
+	});
+	double sceneSum = 0.0;
+	for (SceneNode leaf : lastLeaf)
+		sceneSum += scene.getWorld(leaf).tx;
+	report("flat scene graph, dirty subtrees", sceneMs, nodeCount * frames, static_cast<long>(sceneSum * 100.0));
+	std::cout << "[Bench]   " << nodeCount << " nodes, " << static_cast<double>(updated) / frames << " recomputed per frame"
+			  << std::endl;
+
+	// Worst case for the flat layout, everything moving: still one forward pass per tree
+	double allMs = timeMs([&] {
+		for (int frame = 0; frame < frames; ++frame) {
+			for (SceneNode root : rootNodes) {
+				Transform2D local = scene.getLocal(root);
+				local.tx += 0.01f;
+				scene.setLocal(root, local);
+			}
+			scene.update();
+		}
+	});
+	report("flat scene graph, all moving", allMs, nodeCount * frames, static_cast<long>(scene.getUpdatedCount()));
+}
+
+void benchEvents(const Tilemap& tilemap) {
+	const int frames = 2000;
+	const int eventsPerFrame = 200; // Deaths, goals, trigger crossings from a busy step
+	const float T = tilemap.getTileSize();
+
+	// Baseline: a deferred queue of std::function calls, subscribers also std::functions
+	std::vector<std::function<void(const PlayerDiedEvent&)>> subscribers;
+	long functionSum = 0;
+	subscribers.push_back([&functionSum](const PlayerDiedEvent& e) { functionSum += static_cast<long>(e.cause); });
+	subscribers.push_back([&functionSum](const PlayerDiedEvent& e) { functionSum += static_cast<long>(e.position.x); });
+	std::vector<std::function<void()>> queue;
+	double functionMs = timeMs([&] {
+		for (int frame = 0; frame < frames; ++frame) {
+			for (int i = 0; i < eventsPerFrame; ++i) {
+				PlayerDiedEvent event = {static_cast<DeathCause>(i % 4), glm::vec2(i * T, frame * T)};
+				queue.push_back([&subscribers, event] {
+					for (auto& fn : subscribers)
+						fn(event);
+				});
+			}
+			for (auto& call : queue)
+				call();
+			queue.clear();
+		}
+	});
+	report("std::function event queue", functionMs, static_cast<size_t>(frames) * eventsPerFrame, functionSum);
+
+	struct Counter {
+			long sum = 0;
+			void onDied(const PlayerDiedEvent& e) { sum += static_cast<long>(e.cause); }
+			void onDiedAt(const PlayerDiedEvent& e) { sum += static_cast<long>(e.position.x); }
+	};
+	Counter counter;
+	EventBus<PlayerDiedEvent> bus;
+	bus.subscribe<PlayerDiedEvent, Counter, &Counter::onDied>(&counter);
+	bus.subscribe<PlayerDiedEvent, Counter, &Counter::onDiedAt>(&counter);
+	double busMs = timeMs([&] {
+		for (int frame = 0; frame < frames; ++frame) {
+			for (int i = 0; i < eventsPerFrame; ++i)
+				bus.publish(PlayerDiedEvent{static_cast<DeathCause>(i % 4), glm::vec2(i * T, frame * T)});
+			bus.dispatch();
+		}
+	});
+	report("ring event bus", busMs, static_cast<size_t>(frames) * eventsPerFrame, counter.sum);
+
+	// Several producer threads publishing into one consumer; full queues are retried, so
+	// nothing may go missing
+	const int producers = 4;
+	const int perProducer = 50000;
+	ConcurrentEventBus<PlayerDiedEvent> mpsc;
+	Counter mpscCounter;
+	mpsc.subscribe<PlayerDiedEvent, Counter, &Counter::onDied>(&mpscCounter);
+	long received = 0;
+	mpsc.subscribe<PlayerDiedEvent>([](void* context, const PlayerDiedEvent&) { ++*static_cast<long*>(context); }, &received);
+	std::atomic<int> done{0};
+	double mpscMs = timeMs([&] {
+		std::vector<std::thread> threads;
+		for (int p = 0; p < producers; ++p) {
+			threads.emplace_back([&mpsc, &done, p, perProducer] {
+				for (int i = 0; i < perProducer; ++i) {
+					PlayerDiedEvent event = {static_cast<DeathCause>((p + i) % 4), glm::vec2(0.0f)};
+					while (!mpsc.publish(event))
+						std::this_thread::yield();
+				}
+				done.fetch_add(1);
+			});
+		}
+		while (done.load() < producers || mpsc.getPending<PlayerDiedEvent>() > 0) {
+			mpsc.dispatch();
+			std::this_thread::yield(); // Let producers run on small machines
+		}
+		for (auto& t : threads)
+			t.join();
+		mpsc.dispatch();
+	});
+	report("MPSC event bus (4 producers)", mpscMs, static_cast<size_t>(producers) * perProducer, mpscCounter.sum);
+	std::cout << "[Bench]   received " << received << " of " << producers * perProducer << std::endl;
+}
+
+void benchJobs(const Tilemap& tilemap) {
+	const size_t bodyCount = 8192;
+	const int steps = 60;
+	const float T = tilemap.getTileSize();
+	const float dt = 1.0f / 60.0f;
+	std::mt19937 rng(4404);
+	std::uniform_real_distribution<float> speed(1.0f, 12.0f);
+	std::vector<TileCollider> spawn(bodyCount);
+	for (auto& body : spawn) {
+		body.layout = SensorLayout::centred(glm::vec2(T * 0.375f + EPSILON, T * 0.5f + EPSILON));
+		body.position = fromFloatVec<PhysVec2>(randomOpenPoint(tilemap, rng));
+		body.velocity = fromFloatVec<PhysVec2>(glm::vec2((rng() & 1) ? speed(rng) : -speed(rng), 0.0f));
+	}
+	auto positionHash = [](const std::vector<TileCollider>& bodies) {
+		uint64_t hash = 1469598103934665603ull;
+		for (const auto& body : bodies) {
+			glm::vec2 p = toFloat(body.position);
+			uint32_t bits[2];
+			std::memcpy(bits, &p, sizeof(bits));
+			hash = (hash ^ bits[0]) * 1099511628211ull;
+			hash = (hash ^ bits[1]) * 1099511628211ull;
+		}
+		return hash;
+	};
+
+	// Same bodies stepped on the calling thread, through a system sized to the machine, and
+	// through an oversubscribed one; the end states must match bit for bit
+	JobSystem machine;
+	JobSystem four(4);
+	struct Run {
+			const char* name;
+			JobSystem* jobs;
+	};
+	Run runs[] = {{"tile bodies, no jobs", nullptr}, {"tile bodies, hardware jobs", &machine}, {"tile bodies, 4 threads", &four}};
+	uint64_t firstHash = 0;
+	for (const Run& run : runs) {
+		std::vector<TileCollider> bodies = spawn;
+		Physics physics;
+		physics.setJobSystem(run.jobs);
+		long substeps = 0;
+		double ms = timeMs([&] {
+			for (int step = 0; step < steps; ++step) {
+				physics.stepTileBodies(bodies, tilemap, dt);
+				substeps += physics.getStats().bodySubsteps;
+			}
+		});
+		uint64_t hash = positionHash(bodies);
+		if (run.jobs == nullptr)
+			firstHash = hash;
+		report(run.name, ms, bodyCount * steps, substeps);
+		std::cout << "[Bench]   state " << std::hex << hash << std::dec << (hash == firstHash ? " (matches)" : " (DIFFERS)")
+				  << std::endl;
+	}
+	std::cout << "[Bench]   " << machine.getThreadCount() << " hardware threads" << std::endl;
+
+	// Collision space rebuilds, rows banded over workers
+	SensorLayout layout = SensorLayout::centred(glm::vec2(T * 0.375f + EPSILON, T * 0.5f + EPSILON));
+	const int rebuilds = 8;
+	CollisionSpace serialSpace, jobSpace;
+	double serialMs = timeMs([&] {
+		for (int i = 0; i < rebuilds; ++i) {
+			serialSpace.sync(tilemap, layout);
+			layout.extents.x += (i & 1) ? EPSILON : -EPSILON; // Force a full rebuild each time
+		}
+	});
+	report("collision space rebuild, no jobs", serialMs, rebuilds, serialSpace.getRebuildCount());
+	jobSpace.setJobSystem(&four);
+	layout = SensorLayout::centred(glm::vec2(T * 0.375f + EPSILON, T * 0.5f + EPSILON));
+	double jobMs = timeMs([&] {
+		for (int i = 0; i < rebuilds; ++i) {
+			jobSpace.sync(tilemap, layout);
+			layout.extents.x += (i & 1) ? EPSILON : -EPSILON;
+		}
+	});
+	long spaceMismatches = 0;
+	for (int i = 0; i < 100000; ++i) {
+		glm::vec2 p(std::uniform_real_distribution<float>(0.0f, tilemap.getWidth() * T)(rng),
+					std::uniform_real_distribution<float>(0.0f, tilemap.getHeight() * T)(rng));
+		spaceMismatches += serialSpace.isFree(p) != jobSpace.isFree(p);
+	}
+	report("collision space rebuild, 4 threads", jobMs, rebuilds, spaceMismatches);
+
+	// Scheduling overhead: tiny chunks, plus a chain of dependent jobs seen by the profile hook
+	const int chunks = 200000;
+	std::vector<int> touched(chunks, 0);
+	double forMs = timeMs([&] { four.parallelFor("touch", chunks, 1, [&](int begin, int end) { touched[begin] += end - begin; }); });
+	long touchedSum = std::accumulate(touched.begin(), touched.end(), 0L);
+	report("parallelFor, 1-item chunks", forMs, chunks, touchedSum);
+
+	struct Profile {
+			std::atomic<int> jobs{0};
+			std::atomic<uint64_t> busyNs{0};
+	};
+	Profile profile;
+	four.setProfileHook(
+		[](void* context, const JobProfile& job) {
+			Profile* p = static_cast<Profile*>(context);
+			p->jobs.fetch_add(1);
+			p->busyNs.fetch_add(job.endNs - job.startNs);
+		},
+		&profile);
+	const int links = 10000;
+	std::vector<JobCounter> stages(links);
+	std::atomic<int> order{0};
+	int outOfOrder = 0;
+	std::vector<int> finishedAt(links, -1);
+	struct Link {
+			std::atomic<int>* order;
+			int* slot;
+	};
+	std::vector<Link> linkData(links);
+	double chainMs = timeMs([&] {
+		for (int i = 0; i < links; ++i) {
+			linkData[i] = {&order, &finishedAt[i]};
+			Job job;
+			job.fn = [](void* data, int, int) {
+				Link* link = static_cast<Link*>(data);
+				*link->slot = link->order->fetch_add(1);
+			};
+			job.data = &linkData[i];
+			job.name = "chain";
+			if (i == 0) {
+				four.run(job, &stages[0]);
+			} else {
+				four.runAfter(stages[i - 1], job, &stages[i]);
+			}
+		}
+		four.wait(stages[links - 1]);
+	});
+	four.setProfileHook(nullptr, nullptr);
+	for (int i = 0; i < links; ++i)
+		outOfOrder += finishedAt[i] != i;
+	report("dependent job chain", chainMs, links, outOfOrder);
+	std::cout << "[Bench]   profiled " << profile.jobs.load() << " jobs, " << profile.busyNs.load() / 1000 << " us busy, "
+			  << four.getSteals() << " steals in total" << std::endl;
+}
+
+void benchFrameHandoff(const Tilemap& tilemap) {
+	const int frames = 20000;
+	const int objectCount = 2000;
+	const float T = tilemap.getTileSize();
+	std::mt19937 rng(4505);
+	std::vector<GameObject> objects(objectCount);
+	for (auto& object : objects) {
+		object.setPosition(randomOpenPoint(tilemap, rng));
+		object.setScale(glm::vec2(T));
+	}
+	std::vector<GameObject> noPlatforms;
+	PlayerObject player;
+	player.setScale(glm::vec2(T));
+	player.setPosition(randomOpenPoint(tilemap, rng));
+
+	// Simulation-side cost of one snapshot: copy out the sprites and publish
+	TripleBuffer<FrameSnapshot> buffer;
+	long visible = 0;
+	double captureMs = timeMs([&] {
+		for (int i = 0; i < frames; ++i) {
+			FrameSnapshot& frame = buffer.getWriteSlot();
+			captureFrame(frame, player, objects, noPlatforms, tilemap, 16.0f / 9.0f);
+			frame.step = i + 1;
+			buffer.publish();
+			const TileRange& tiles = buffer.acquire().visibleTiles;
+			visible += (tiles.x1 - tiles.x0 + 1) * (tiles.y1 - tiles.y0 + 1);
+		}
+	});
+	report("capture + publish snapshot (2000 sprites)", captureMs, frames, visible / frames);
+	std::cout << "[Bench]   " << visible / frames << " visible tiles of " << tilemap.getWidth() * tilemap.getHeight() << std::endl;
+
+	// A writer thread publishing as fast as it can while this thread reads: every snapshot
+	// read must be whole (all sprites from the same step) and steps must never go back
+	TripleBuffer<FrameSnapshot> shared;
+	std::atomic<bool> writing{true};
+	std::thread writer([&] {
+		for (uint64_t step = 1; writing.load(); ++step) {
+			FrameSnapshot& frame = shared.getWriteSlot();
+			frame.step = step;
+			frame.sprites.resize(256);
+			for (auto& sprite : frame.sprites)
+				sprite.color = glm::vec4(static_cast<float>(step));
+			shared.publish();
+		}
+	});
+	long torn = 0, reads = 0, backwards = 0;
+	uint64_t lastStep = 0;
+	auto until = std::chrono::steady_clock::now() + std::chrono::milliseconds(200);
+	while (std::chrono::steady_clock::now() < until) {
+		const FrameSnapshot& frame = shared.acquire();
+		for (const auto& sprite : frame.sprites)
+			torn += sprite.color.x != static_cast<float>(frame.step);
+		backwards += frame.step < lastStep;
+		lastStep = frame.step;
+		reads++;
+		std::this_thread::yield();
+	}
+	writing.store(false);
+	writer.join();
+	std::cout << "[Bench] triple buffer under contention: " << reads << " reads of " << shared.getPublished() << " publishes, "
+			  << torn << " torn sprites, " << backwards << " steps backwards" << std::endl;
+
+	// Frame time, same work either way: a 4 ms simulation step and a renderer that spends
+	// 8 ms waiting on vsync. Back to back that's their sum; decoupled it's the larger one.
+	const auto simCost = std::chrono::milliseconds(4);
+	const auto renderWait = std::chrono::milliseconds(8);
+	const int renderFrames = 30;
+	auto simulate = [&] {
+		auto end = std::chrono::steady_clock::now() + simCost;
+		while (std::chrono::steady_clock::now() < end) {
+		}
+	};
+	double serialMs = timeMs([&] {
+		for (int i = 0; i < renderFrames; ++i) {
+			simulate();
+			std::this_thread::sleep_for(renderWait);
+		}
+	});
+	TripleBuffer<FrameSnapshot> handoff;
+	SimulationThread sim;
+	uint64_t simStep = 0;
+	uint64_t shown = 0;
+	double threadedMs = timeMs([&] {
+		sim.start(1.0f / 120.0f, [&](float) {
+			simulate();
+			handoff.getWriteSlot().step = ++simStep;
+			handoff.publish();
+			return true;
+		});
+		for (int i = 0; i < renderFrames; ++i) {
+			shown = handoff.acquire().step;
+			std::this_thread::sleep_for(renderWait);
+		}
+		sim.stop();
+	});
+	report("sim + render back to back", serialMs, renderFrames, renderFrames);
+	report("sim thread + render thread", threadedMs, renderFrames, static_cast<long>(sim.getSteps()));
+	std::cout << "[Bench]   " << sim.getSteps() << " sim steps ran alongside " << renderFrames << " frames (last shown step "
+			  << shown << ")" << std::endl;
+}
+
+void benchLevelLoading(const std::string& levelPath) {
+	const float T = TILE_SIZE;
+	const SensorLayout layout = SensorLayout::centred(glm::vec2(T * 0.375f + EPSILON, T * 0.5f + EPSILON));
+	const std::string bigPath = (fs::temp_directory_path() / "bench_generated_level.tmap").string();
+	writeGeneratedLevel(bigPath, 20000, 50);
+
+	for (const std::string& path : {levelPath, bigPath}) {
+		// Old path: everything on the calling thread, which is the UI thread in the menu
+		std::unique_ptr<LoadedLevel> syncLevel;
+		double syncMs = timeMs([&] {
+			syncLevel = std::make_unique<LoadedLevel>(loadTilemapFromFile(path, T, nullptr, nullptr));
+			syncLevel->playerSpace.sync(syncLevel->tilemap, layout);
+			syncLevel->mesh.build(syncLevel->tilemap);
+		});
+		const Tilemap& expected = syncLevel->tilemap;
+		std::cout << "[Bench] Level load " << expected.getWidth() << "x" << expected.getHeight() << ": synchronous "
+				  << syncMs << " ms stall (" << syncLevel->mesh.getChunkCount() << " chunks, " << syncLevel->mesh.getQuadCount()
+				  << " quads)" << std::endl;
+
+		// Loader thread, polled once per ~1 ms "frame" the way handleLoadingState does. The
+		// compiled copy goes first so this is the parse-and-cache first load.
+		fs::remove(compiledLevelPath(path));
+		LevelLoader loader;
+		std::unique_ptr<LoadedLevel> level;
+		int frames = 0;
+		double worstPollMs = 0.0;
+		double asyncMs = timeMs([&] {
+			loader.start(path, nullptr, nullptr, layout);
+			while (!level) {
+				double pollMs = timeMs([&] {
+					loader.getProgress();
+					if (loader.getStage() == LoadStage::READY)
+						level = loader.take();
+				});
+				worstPollMs = std::max(worstPollMs, pollMs);
+				if (loader.getStage() == LoadStage::FAILED) {
+					std::cerr << "[Bench] Async load failed: " << loader.getError() << std::endl;
+					return;
+				}
+				++frames;
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+		});
+		if (!level)
+			continue;
+
+		// Moved in the way applyLoadedLevel does; the prebuilt space must not rebuild
+		Tilemap current(1, 1, T);
+		current = std::move(level->tilemap);
+		CollisionSpace space = std::move(level->playerSpace);
+		int rebuilds = space.getRebuildCount();
+		space.sync(current, layout);
+		bool same = current.getSolidTileCount() == expected.getSolidTileCount() &&
+					current.getCollisionRects().size() == expected.getCollisionRects().size() &&
+					level->mesh.getQuadCount() == syncLevel->mesh.getQuadCount();
+		std::cout << "[Bench]   background: " << asyncMs << " ms over " << frames << " frames, longest frame poll "
+				  << worstPollMs * 1000.0 << " us, rebuilds after move-in: " << space.getRebuildCount() - rebuilds
+				  << (same ? ", matches synchronous load" : ", MISMATCH") << std::endl;
+
+		// Changing your mind mid-load, early (parsing a fresh copy and writing its cache) and
+		// late (building geometry). Cancel itself doesn't wait; the thread winds down after.
+		auto windDownMs = [&] {
+			return timeMs([&] {
+				while (loader.getWindingDown() > 0) {
+					loader.reap();
+					std::this_thread::sleep_for(std::chrono::microseconds(100));
+				}
+			});
+		};
+		fs::remove(compiledLevelPath(path));
+		loader.start(path, nullptr, nullptr, layout);
+		std::this_thread::sleep_for(std::chrono::milliseconds(2));
+		double cancelMs = timeMs([&] { loader.cancel(); });
+		double earlyMs = windDownMs();
+		loader.start(path, nullptr, nullptr, layout);
+		while (loader.getStage() != LoadStage::GEOMETRY && loader.isBusy())
+			std::this_thread::yield();
+		double lateCancelMs = timeMs([&] { loader.cancel(); });
+		double lateMs = windDownMs();
+		std::cout << "[Bench]   cancel mid-load: " << cancelMs << " ms, thread done " << earlyMs << " ms later; during geometry: "
+				  << lateCancelMs << " ms, thread done " << lateMs << " ms later" << std::endl;
+	}
+	fs::remove(bigPath);
+	fs::remove(compiledLevelPath(bigPath));
+}
+
+void benchLevelPreloading(const std::string& levelPath) {
+	const float T = TILE_SIZE;
+	const SensorLayout layout = SensorLayout::centred(glm::vec2(T * 0.375f + EPSILON, T * 0.5f + EPSILON));
+	std::vector<std::string> paths;
+	for (int i = 0; i < 3; ++i) {
+		paths.push_back((fs::temp_directory_path() / ("bench_preload_" + std::to_string(i) + ".tmap")).string());
+		writeGeneratedLevel(paths.back(), 4000 + 1000 * i, 50);
+	}
+
+	// "Load Level" pressed with nothing prepared vs. after the highlighted level had a
+	// moment to preload: time until the level is in hand
+	auto waitFor = [](LevelCache& cache, const std::string& path) {
+		std::unique_ptr<LoadedLevel> level;
+		while (!(level = cache.take(path)) && !cache.hasFailed(path))
+			std::this_thread::sleep_for(std::chrono::microseconds(200));
+		return level;
+	};
+	for (const std::string& path : {levelPath, paths[2]}) {
+		fs::remove(compiledLevelPath(path)); // A first load, nothing compiled yet
+		LevelCache cold;
+		cold.configure(nullptr, nullptr, layout);
+		double coldMs = timeMs([&] {
+			cold.prefetch(path);
+			waitFor(cold, path);
+		});
+		LevelCache warm;
+		warm.configure(nullptr, nullptr, layout);
+		warm.prefetch(path); // Selected in the list
+		while (warm.isLoading(path))
+			std::this_thread::sleep_for(std::chrono::milliseconds(1)); // Player reading the details
+		double warmMs = timeMs([&] {
+			warm.prefetch(path);
+			waitFor(warm, path);
+		});
+		std::cout << "[Bench] Load pressed -> level ready (" << fs::path(path).filename().string() << "): " << coldMs
+				  << " ms cold, " << warmMs << " ms preloaded" << std::endl;
+	}
+
+	// Clicking through the list, one row per frame: each click evicts the previous pick.
+	// Prefetching right away starts (and cancels) a load per row; the settled prefetch
+	// waits for the highlight to stay put.
+	auto churn = [&](bool settled, int& started) {
+		LevelCache cache;
+		cache.configure(nullptr, nullptr, layout);
+		started = 0;
+		return timeMs([&] {
+			for (int i = 0; i < 30; ++i) {
+				if (i > 0)
+					cache.evict(paths[(i - 1) % 3]);
+				if (settled)
+					cache.prefetchSettled(paths[i % 3]);
+				else
+					cache.prefetch(paths[i % 3]);
+				cache.poll();
+				started += cache.isLoading(paths[i % 3]);
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+		});
+	};
+	int immediateLoads = 0, settledLoads = 0;
+	double immediateMs = churn(false, immediateLoads);
+	double settledMs = churn(true, settledLoads);
+	std::cout << "[Bench]   30 selection changes: " << immediateMs << " ms and " << immediateLoads << " loads started prefetching at once, "
+			  << settledMs << " ms and " << settledLoads << " once settled" << std::endl;
+
+	// Budget: room for about one of the generated levels, so older ones are pushed out
+	LevelCache probe;
+	probe.configure(nullptr, nullptr, layout);
+	probe.prefetch(paths[1]);
+	size_t levelBytes = waitFor(probe, paths[1])->getMemoryBytes();
+	LevelCache small(levelBytes * 3 / 2);
+	small.configure(nullptr, nullptr, layout);
+	for (const std::string& path : paths) {
+		small.prefetch(path);
+		while (small.isLoading(path))
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		small.poll();
+	}
+	std::cout << "[Bench]   budget " << small.getBudget() / 1024 << " KB: " << small.getCount() << " of " << paths.size()
+			  << " levels kept, " << small.getUsedBytes() / 1024 << " KB used, newest kept: "
+			  << (small.isCached(paths[2]) ? "yes" : "no") << std::endl;
+
+	for (const std::string& path : paths) {
+		fs::remove(path);
+		fs::remove(compiledLevelPath(path));
+	}
+}
+
+void benchLevelIndex() {
+	const int levelCount = 2000;
+	const fs::path dir = fs::temp_directory_path() / "bench_level_index";
+	fs::remove_all(dir);
+	fs::create_directories(dir);
+	for (int i = 0; i < levelCount; ++i) {
+		char name[32];
+		std::snprintf(name, sizeof(name), "level_%04d.tmap", i);
+		writeGeneratedLevel((dir / name).string(), 200 + i % 50, 20);
+	}
+
+	// Polled once per ~1 ms "frame" like the menu does; reports the slowest poll
+	double worstPollMs = 0.0;
+	auto scanToEnd = [&](LevelManager& levels) {
+		worstPollMs = 0.0;
+		bool scanning = true;
+		while (scanning) {
+			scanning = levels.isScanning();
+			worstPollMs = std::max(worstPollMs, timeMs([&] { levels.pollLevelList(); }));
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	};
+	auto availableCount = [](LevelManager& levels) {
+		int count = 0;
+		for (const auto& level : levels.getAvailableLevels())
+			count += level.available;
+		return count;
+	};
+
+	// What loadLevelList used to do on the main thread: open every file for its dimensions
+	long dims = 0;
+	double legacyMs = timeMs([&] {
+		for (const auto& entry : fs::directory_iterator(dir)) {
+			if (entry.path().extension() != ".tmap")
+				continue;
+			std::ifstream file(entry.path().string());
+			int w = 0, h = 0;
+			file >> w >> h;
+			dims += w * h;
+		}
+	});
+	std::cout << "[Bench] Level list, " << levelCount << " files: open every file " << legacyMs << " ms on the main thread ("
+			  << dims << " tiles)" << std::endl;
+
+	// No index yet: every file read in the background
+	LevelManager cold(dir.string());
+	double coldListMs = timeMs([&] { cold.loadLevelList(); });
+	double coldScanMs = timeMs([&] { scanToEnd(cold); });
+	std::cout << "[Bench]   no index: loadLevelList " << coldListMs << " ms, background scan " << coldScanMs << " ms, "
+			  << availableCount(cold) << " levels, slowest frame poll " << worstPollMs << " ms" << std::endl;
+
+	// Index present and nothing changed: the scan only stats
+	LevelManager warm(dir.string());
+	double warmListMs = timeMs([&] { warm.loadLevelList(); });
+	double warmScanMs = timeMs([&] { scanToEnd(warm); });
+	std::cout << "[Bench]   index: loadLevelList " << warmListMs << " ms, background check " << warmScanMs << " ms, "
+			  << availableCount(warm) << " levels, slowest frame poll " << worstPollMs << " ms" << std::endl;
+
+	// One file edited, one deleted
+	const fs::path edited = dir / "level_0007.tmap";
+	uint64_t oldHash = warm.getAvailableLevels()[7].contentHash;
+	writeGeneratedLevel(edited.string(), 321, 20);
+	fs::last_write_time(edited, fs::last_write_time(edited) + std::chrono::seconds(5));
+	fs::remove(dir / "level_0011.tmap");
+	LevelManager changed(dir.string());
+	changed.loadLevelList();
+	double changedScanMs = timeMs([&] { scanToEnd(changed); });
+	bool reread = false, hidden = true;
+	for (const auto& level : changed.getAvailableLevels()) {
+		if (level.filename == "level_0007.tmap")
+			reread = level.contentHash != oldHash && level.dimensions.x == 321;
+		if (level.filename == "level_0011.tmap")
+			hidden = hidden && !level.available;
+	}
+	std::cout << "[Bench]   1 edited + 1 deleted: background check " << changedScanMs << " ms, edited re-read: "
+			  << (reread ? "yes" : "NO") << ", deleted hidden: " << (hidden ? "yes" : "NO") << ", "
+			  << availableCount(changed) << " levels" << std::endl;
+
+	fs::remove_all(dir);
+}
+
+void benchLevelFormats() {
+	const float T = TILE_SIZE;
+	std::vector<std::string> paths;
+	for (const auto& entry : fs::directory_iterator("./assets/levels")) {
+		if (entry.path().extension() == ".tmap")
+			paths.push_back(entry.path().string());
+	}
+	std::sort(paths.begin(), paths.end());
+	const std::string hugePath = (fs::temp_directory_path() / "bench_huge_level.tmap").string();
+	writeGeneratedLevel(hugePath, 100000, 100); // 10M tiles
+	paths.push_back(hugePath);
+
+	// Same tiles, textures, markers and collision shapes either way
+	auto sameLevel = [](const Tilemap& a, const Tilemap& b) {
+		if (a.getWidth() != b.getWidth() || a.getHeight() != b.getHeight() ||
+			a.getPlayerPosition() != b.getPlayerPosition() || a.getGoalPos() != b.getGoalPos() ||
+			a.getPlatformSpawns().size() != b.getPlatformSpawns().size() ||
+			a.getCollisionRects().size() != b.getCollisionRects().size())
+			return false;
+		for (int y = 0; y < a.getHeight(); ++y) {
+			for (int x = 0; x < a.getWidth(); ++x) {
+				Tile ta = a.getTile(x, y), tb = b.getTile(x, y);
+				if (ta.tileType.type != tb.tileType.type || ta.tileType.color != tb.tileType.color || ta.texture != tb.texture ||
+					a.getEdgeMask(x, y) != b.getEdgeMask(x, y) || a.isSolidTile(x, y) != b.isSolidTile(x, y))
+					return false;
+			}
+		}
+		return true;
+	};
+
+	// Stand-ins for the two tile textures: only compared, never dereferenced
+	Texture* floorTex = reinterpret_cast<Texture*>(uintptr_t(0x10));
+	Texture* wallTex = reinterpret_cast<Texture*>(uintptr_t(0x20));
+	for (const std::string& path : paths) {
+		const std::string compiledPath = (fs::temp_directory_path() / fs::path(path).filename()).string() + ".tlvl";
+		LevelSource source;
+		statLevelSource(path, source);
+
+		// Text: parse, then the geometry the loader builds next
+		Tilemap parsed(1, 1, T);
+		TileMesh parsedMesh;
+		double parseMs = timeMs([&] { parsed = loadTilemapFromFile(path, T, floorTex, wallTex); });
+		double parsedMeshMs = timeMs([&] { parsedMesh.build(parsed); });
+
+		std::vector<LevelChunkInfo> chunks;
+		double writeMs = timeMs([&] { writeCompiledLevel(parsed, compiledPath, source, &chunks); });
+
+		// Compiled: the mmap itself, then a first pass over every grid (what actually pages it
+		// in), then the geometry with empty chunks skipped
+		Tilemap mapped(1, 1, T);
+		TileMesh mappedMesh;
+		std::vector<LevelChunkInfo> mappedChunks;
+		bool loaded = false;
+		double mapMs = timeMs([&] { loaded = loadCompiledLevel(compiledPath, T, floorTex, wallTex, mapped, &source, &mappedChunks); });
+		long touched = 0;
+		double touchMs = timeMs([&] {
+			touched = mapped.getSolidTileCount();
+			for (int y = 0; y < mapped.getHeight(); ++y) {
+				const uint8_t* row = mapped.getTileRow(y);
+				for (int x = 0; x < mapped.getWidth(); ++x)
+					touched += row[x];
+			}
+		});
+		double mappedMeshMs = timeMs([&] { mappedMesh.build(mapped, &mappedChunks); });
+
+		const bool same = loaded && sameLevel(parsed, mapped) && parsedMesh.getQuadCount() == mappedMesh.getQuadCount();
+		std::cout << "[Bench] Level format " << fs::path(path).filename().string() << " (" << parsed.getWidth() << "x"
+				  << parsed.getHeight() << ", " << fs::file_size(path) / 1024 << " KB text, "
+				  << fs::file_size(compiledPath) / 1024 << " KB compiled):" << std::endl;
+		std::cout << "[Bench]   text parse " << parseMs << " ms + geometry " << parsedMeshMs << " ms; compile "
+				  << writeMs << " ms" << std::endl;
+		std::cout << "[Bench]   mmap " << mapMs << " ms + first full read " << touchMs << " ms + geometry "
+				  << mappedMeshMs << " ms (checksum " << touched << ")" << (same ? ", identical level" : ", MISMATCH")
+				  << std::endl;
+		fs::remove(compiledPath);
+	}
+
+	// The game's path: the first load parses and writes the cache, later ones map it
+	fs::remove(compiledLevelPath(hugePath));
+	double firstMs = timeMs([&] { loadLevelFile(hugePath, T, nullptr, nullptr); });
+	double againMs = timeMs([&] { loadLevelFile(hugePath, T, nullptr, nullptr); });
+	writeGeneratedLevel(hugePath, 100000, 100);
+	fs::last_write_time(hugePath, fs::last_write_time(hugePath) + std::chrono::seconds(5));
+	double editedMs = timeMs([&] { loadLevelFile(hugePath, T, nullptr, nullptr); });
+	std::cout << "[Bench]   loadLevelFile 10M tiles: first " << firstMs << " ms (parse + cache), then " << againMs
+			  << " ms, after the .tmap changed " << editedMs << " ms" << std::endl;
+
+	fs::remove(hugePath);
+	fs::remove_all(fs::path(compiledLevelPath(hugePath)).parent_path());
+}
+
+void benchTileWorld() {
+	const float T = TILE_SIZE;
+
+	// Same answers as the Tilemap it was written from, with a budget of a few chunks so the
+	// queries keep evicting and reloading
+	const std::string levelPath = (fs::temp_directory_path() / "bench_world_level.tmap").string();
+	const std::string smallPath = (fs::temp_directory_path() / "bench_small.tworld").string();
+	writeGeneratedLevel(levelPath, 3000, 150);
+	Tilemap tilemap = loadTilemapFromFile(levelPath, T, nullptr, nullptr);
+	writeTileWorld(tilemap, smallPath);
+	TileWorld small(64 * 1024);
+	bool same = small.open(smallPath, T) && small.getWidth() == tilemap.getWidth() &&
+				small.getHeight() == tilemap.getHeight() && small.getPlayerPosition() == tilemap.getPlayerPosition() &&
+				small.getGoalPos() == tilemap.getGoalPos();
+	for (int y = 0; y < tilemap.getHeight() && same; ++y) {
+		small.update(0, y, 63, y);
+		for (int x = 0; x < tilemap.getWidth() && same; ++x) {
+			same = small.getTileType(x, y) == tilemap.getTileType(x, y) && small.isSolidTile(x, y) == tilemap.isSolidTile(x, y) &&
+				   small.isGoalTile(x, y) == tilemap.isGoalTile(x, y) && small.isHazardTile(x, y) == tilemap.isHazardTile(x, y) &&
+				   small.getEdgeMask(x, y) == tilemap.getEdgeMask(x, y);
+		}
+	}
+	std::mt19937 rng(7);
+	std::uniform_int_distribution<int> px(-20, tilemap.getWidth() + 20), py(-20, tilemap.getHeight() + 20), span(0, 90);
+	std::uniform_real_distribution<float> angle(0.0f, 6.2831853f), dist(0.0f, 40.0f * T);
+	long rectHits = 0, rayHits = 0, boxHits = 0;
+	for (int i = 0; i < 20000 && same; ++i) {
+		if (i % 100 == 0)
+			small.update(0, 0, 0, 0);
+		int x0 = px(rng), y0 = py(rng), x1 = x0 + span(rng), y1 = y0 + span(rng);
+		same = small.anySolidInRect(x0, y0, x1, y1) == tilemap.anySolidInRect(x0, y0, x1, y1) &&
+			   small.anyGoalInRect(x0, y0, x1, y1) == tilemap.anyGoalInRect(x0, y0, x1, y1) &&
+			   small.anyHazardInRect(x0, y0, x1, y1) == tilemap.anyHazardInRect(x0, y0, x1, y1);
+		rectHits += small.anySolidInRect(x0, y0, x1, y1);
+
+		glm::vec2 p = randomOpenPoint(tilemap, rng);
+		float a = angle(rng), d = dist(rng), half = T * 0.25f;
+		glm::vec2 dir(std::cos(a), std::sin(a));
+		AABB box = {p.x - half, p.x + half, p.y + half, p.y - half};
+		TileHit ray = small.raycast(p, dir, d), expectedRay = tilemap.raycast(p, dir, d);
+		TileHit sweep = small.boxcast(box, dir * d / 8.0f), expectedSweep = tilemap.boxcast(box, dir * d / 8.0f);
+		same = same && ray.hit == expectedRay.hit && ray.tile == expectedRay.tile && ray.distance == expectedRay.distance &&
+			   sweep.hit == expectedSweep.hit && sweep.tile == expectedSweep.tile && sweep.distance == expectedSweep.distance;
+		rayHits += ray.hit;
+		boxHits += sweep.hit;
+	}
+	std::cout << "[Bench] TileWorld vs Tilemap " << tilemap.getWidth() << "x" << tilemap.getHeight() << " ("
+			  << small.getBudget() / 1024 << " KB budget): " << small.getLoadCount() << " chunk loads, "
+			  << small.getEvictCount() << " evictions, " << rectHits << "/" << rayHits << "/" << boxHits
+			  << " rect/ray/box hits" << (same ? ", identical answers" : ", MISMATCH") << std::endl;
+
+	// Read back whole through loadLevelFile
+	Tilemap readBack = loadLevelFile(smallPath, T, nullptr, nullptr);
+	bool readSame = readBack.getWidth() == tilemap.getWidth() && readBack.getHeight() == tilemap.getHeight() &&
+					readBack.getPlayerPosition() == tilemap.getPlayerPosition() && readBack.getGoalPos() == tilemap.getGoalPos() &&
+					readBack.getPlatformSpawns().size() == tilemap.getPlatformSpawns().size();
+	for (int y = 0; y < tilemap.getHeight() && readSame; ++y) {
+		for (int x = 0; x < tilemap.getWidth() && readSame; ++x)
+			readSame = readBack.getTileType(x, y) == tilemap.getTileType(x, y) && readBack.getEdgeMask(x, y) == tilemap.getEdgeMask(x, y);
+	}
+
+	// Played as a streamed level: triggers cover the same tiles (split at chunk edges), and
+	// the player's run and the snapshot tiles match the same run on the Tilemap
+	TriggerSystem mapTriggers, worldTriggers;
+	mapTriggers.load(tilemap);
+	double triggerMs = timeMs([&] { worldTriggers.load(small); });
+	auto coveredTiles = [&](const TriggerSystem& triggers) {
+		long tiles = 0;
+		for (int i = 0; i < triggers.getCount(); ++i) {
+			const AABB& box = triggers.getTrigger(i).box;
+			tiles += std::lround((box.right - box.left) / T) * std::lround((box.top - box.bottom) / T);
+		}
+		return tiles;
+	};
+	const glm::ivec2 start = tilemap.getPlayerPosition();
+	PlayerObject mapPlayer = setupPlayerObject(tilemap, 0.75f, 1.0f, start.x, start.y);
+	PlayerObject worldPlayer = setupPlayerObject(tilemap, 0.75f, 1.0f, start.x, start.y);
+	Physics mapPhysics, worldPhysics;
+	CollisionSpace mapSpace; // Synced up front, as the level loader does
+	mapSpace.sync(tilemap, mapPlayer.getSensorLayout());
+	mapPhysics.setPlayerSpace(std::move(mapSpace));
+	FrameSnapshot mapFrame, worldFrame;
+	std::vector<GameObject> noObjects;
+	const int runSteps = 6000;
+	float maxDrift = 0.0f;
+	long frameTiles = 0, frameMismatches = 0;
+	double mapStepMs = 0.0, worldStepMs = 0.0;
+	for (int step = 0; step < runSteps; ++step) {
+		for (PlayerObject* player : {&mapPlayer, &worldPlayer}) {
+			// Run right, jumping every so often
+			glm::vec2 velocity(6.0f, player->getVelocity().y);
+			if (step % 90 == 0 && player->isGrounded())
+				velocity.y = 9.0f;
+			player->setVelocity(velocity);
+		}
+		mapStepMs += timeMs([&] { mapPhysics.stepPlayer(mapPlayer, tilemap, 1.0f / 120.0f); });
+		worldStepMs += timeMs([&] { worldPhysics.stepPlayer(worldPlayer, small, 1.0f / 120.0f); });
+		maxDrift = std::max(maxDrift, glm::length(mapPlayer.getPosition() - worldPlayer.getPosition()));
+		if (step % 30 == 0) {
+			captureFrame(mapFrame, mapPlayer, noObjects, noObjects, tilemap, 16.0f / 9.0f);
+			captureFrame(worldFrame, worldPlayer, noObjects, noObjects, small, 16.0f / 9.0f);
+			const TileRange& tiles = mapFrame.visibleTiles;
+			long visible = 0;
+			for (int y = tiles.y0; y <= tiles.y1; ++y) {
+				for (int x = tiles.x0; x <= tiles.x1; ++x)
+					visible += tilemap.getTile(x, y).tileType.visible;
+			}
+			frameTiles += visible;
+			frameMismatches += visible != static_cast<long>(worldFrame.tiles.size());
+		}
+	}
+	std::cout << "[Bench]   loadLevelFile of the .tworld: " << (readSame ? "same tilemap" : "MISMATCH") << "; triggers "
+			  << worldTriggers.getCount() << " (tilemap " << mapTriggers.getCount() << ") covering " << coveredTiles(worldTriggers)
+			  << "/" << coveredTiles(mapTriggers) << " tiles, loaded in " << triggerMs << " ms" << std::endl;
+	std::cout << "[Bench]   player run " << runSteps << " steps to x " << worldPlayer.getPosition().x / T << ": "
+			  << mapStepMs * 1e6 / runSteps << " ns/step on Tilemap, " << worldStepMs * 1e6 / runSteps
+			  << " ns/step streamed, max drift " << maxDrift / T << " tiles; " << frameTiles << " snapshot tiles, "
+			  << frameMismatches << " frames differing" << std::endl;
+	small.close();
+	fs::remove(smallPath);
+	fs::remove(levelPath);
+
+	// A world far too big to hold densely: rolling ground over solid rock with ledges, pits of
+	// hazard, sky above. Generated chunk by chunk straight into the file.
+	const int width = 4000000, height = 256;
+	const std::string worldPath = (fs::temp_directory_path() / "bench_huge.tworld").string();
+	std::vector<TilePaletteEntry> palette = {
+		{{TileEnum::EMPTY, false, false, glm::vec4(0.0f)}, TileSkin::NONE},
+		{{TileEnum::SOLID, true, true, glm::vec4(0.3f, 0.3f, 0.3f, 1.0f)}, TileSkin::WALL},
+		{{TileEnum::SOLID, true, true, glm::vec4(0.4f, 0.6f, 0.3f, 1.0f)}, TileSkin::FLOOR},
+		{{TileEnum::HAZARD, true, false, glm::vec4(0.9f, 0.2f, 0.1f, 1.0f)}, TileSkin::NONE},
+		{{TileEnum::GOAL, true, false, glm::vec4(1.0f, 0.9f, 0.2f, 1.0f)}, TileSkin::NONE},
+	};
+	auto ground = [](int x) {
+		uint32_t h = static_cast<uint32_t>(x / 16) * 2654435761u;
+		return 80 + static_cast<int>((h >> 16) % 48) + (x / 16 % 2 == 0 ? 0 : 8);
+	};
+	std::vector<LevelMarker> markers = {{LevelMarkerKind::PLAYER, 2, ground(2) + 1, 0, 0, 0},
+										{LevelMarkerKind::GOAL, width - 3, ground(width - 3) + 1, 0, 0, 0}};
+	double writeMs = timeMs([&] {
+		writeTileWorld(worldPath, width, height, palette, markers, [&](int x0, int y0, uint8_t* tiles) {
+			for (int x = x0; x < std::min(x0 + WORLD_CHUNK_TILES, width); ++x) {
+				const int g = ground(x);
+				const bool pit = (x * 2246822519u >> 20) % 64 == 0;
+				const bool ledge = x % 32 < 5 && (x / 32) % 3 == 0;
+				for (int y = y0; y < std::min(y0 + WORLD_CHUNK_TILES, height); ++y) {
+					uint8_t id = y < g ? 1 : (y == g ? (pit ? 3 : 2) : 0);
+					if (ledge && y == g + 6)
+						id = 2;
+					if (x == width - 3 && y == g + 1)
+						id = 4;
+					tiles[(y - y0) * WORLD_CHUNK_TILES + (x - x0)] = id;
+				}
+			}
+		});
+	});
+	const long rssBefore = peakRssKb();
+	TileWorld world;
+	bool opened = false;
+	double openMs = timeMs([&] { opened = world.open(worldPath, T); });
+	if (!opened) {
+		std::cout << "[Bench] TileWorld: failed to open " << worldPath << std::endl;
+		fs::remove(worldPath);
+		return;
+	}
+
+	// The camera runs right at 64 tiles a frame, following the ground, with the per-frame
+	// queries a player and a few enemies would make
+	const int viewW = 64, viewH = 36, frames = 20000;
+	std::vector<double> frameMs(frames);
+	size_t peakBytes = 0;
+	long checksum = 0;
+	for (int f = 0; f < frames; ++f) {
+		const int cx = 32 + f * 64;
+		const int cy = ground(cx);
+		frameMs[f] = timeMs([&] {
+			world.update(cx - viewW / 2, cy - viewH / 2, cx + viewW / 2, cy + viewH / 2);
+			const glm::vec2 p = world.tileIndexToWorldPos(cx, cy + 2);
+			for (int i = 0; i < 8; ++i) {
+				glm::vec2 dir(std::cos(i * 0.785f), std::sin(i * 0.785f));
+				checksum += world.raycast(p, dir, 20.0f * T).hit;
+				checksum += world.anySolidInRect(cx + i * 4 - 1, cy, cx + i * 4 + 1, cy + 3);
+				checksum += world.isHazardTile(cx + i * 4, cy);
+			}
+			AABB box = {p.x - T * 0.4f, p.x + T * 0.4f, p.y + T * 0.9f, p.y - T * 0.9f};
+			checksum += world.boxcast(box, glm::vec2(0.0f, -4.0f * T)).hit;
+		});
+		peakBytes = std::max(peakBytes, world.getResidentBytes());
+	}
+	const double total = std::accumulate(frameMs.begin(), frameMs.end(), 0.0);
+	const double worst = *std::max_element(frameMs.begin(), frameMs.end());
+	const long rssAfter = peakRssKb();
+	std::cout << "[Bench] TileWorld " << width << "x" << height << " (" << static_cast<long>(width) * height / 1000000
+			  << "M tiles, dense Tilemap would be " << Tilemap::storageBytes(width, height) / (1024 * 1024) << " MB): "
+			  << fs::file_size(worldPath) / 1024 << " KB on disk, written in " << writeMs << " ms, open " << openMs << " ms"
+			  << std::endl;
+	std::cout << "[Bench]   " << frames << " frames across " << frames * 64 << " columns: avg " << total / frames
+			  << " ms, worst " << worst << " ms; " << world.getLoadCount() << " loads, " << world.getEvictCount()
+			  << " evictions; peak resident " << peakBytes / 1024 << " KB of " << world.getBudget() / 1024
+			  << " KB budget; peak RSS " << rssBefore / 1024 << " -> " << rssAfter / 1024 << " MB (checksum " << checksum
+			  << ")" << std::endl;
+	world.close();
+
+	// Through the level loader, as the level select loads it: open plus the trigger pass
+	LevelLoader loader;
+	std::unique_ptr<LoadedLevel> level;
+	double loaderMs = timeMs([&] {
+		loader.start(worldPath, nullptr, nullptr, SensorLayout());
+		while (loader.isBusy())
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		level = loader.take();
+	});
+	if (level && level->world) {
+		std::cout << "[Bench]   LevelLoader: streamed level ready in " << loaderMs << " ms with " << level->triggers.getCount()
+				  << " triggers, " << level->getMemoryBytes() / 1024 << " KB counted against the level cache" << std::endl;
+	} else {
+		std::cout << "[Bench]   LevelLoader: FAILED to load " << worldPath << ": " << loader.getError() << std::endl;
+	}
+	level.reset();
+	fs::remove(worldPath);
+}
+
+int runBenchmarks(const std::string& levelPath) {
+	std::cout << "[Bench] Level: " << levelPath << std::endl;
+	Tilemap tilemap(1, 1, TILE_SIZE);
+	try {
+		tilemap = loadTilemapFromFile(levelPath, TILE_SIZE, nullptr, nullptr);
+	} catch (const std::exception& e) {
+		std::cerr << "[Bench] Failed to load level: " << e.what() << std::endl;
+		return -1;
+	}
+	std::cout << "[Bench] " << tilemap.getWidth() << "x" << tilemap.getHeight() << " tiles" << std::endl;
+
+	benchTilemapQueries(tilemap);
+	benchCollisionSpace(tilemap);
+	benchTileColliders(tilemap);
+	benchSubstepping(tilemap);
+	benchActivity(tilemap);
+	benchPlatforms(tilemap);
+	benchAABBBatch(tilemap);
+	benchTriggers(tilemap);
+	benchBehaviors(tilemap);
+	benchHandles(tilemap);
+	benchTransforms(tilemap);
+	benchTransform2D(tilemap);
+	benchSceneGraph(tilemap);
+	benchEvents(tilemap);
+	benchJobs(tilemap);
+	benchFrameHandoff(tilemap);
+	benchLevelLoading(levelPath);
+	benchLevelPreloading(levelPath);
+	benchLevelIndex();
+	benchLevelFormats();
+	benchTileWorld();
+	// Float and fixed point disagreeing is a physics bug, not a slow run
+	return benchFixedPoint(tilemap) ? 0 : 1;
+}
@@ -0,0 +1,147 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "collisionspace.hpp"
+#include "globals.hpp"
+
+void CollisionSpace::sync(const Tilemap& tilemap, const SensorLayout& layout, const std::atomic<bool>* cancel) {
+	if (tilemap.getId() != tilemapId_ || layout != layout_) {
+		layout_ = layout;
+		rebuild(tilemap, cancel);
+		return;
+	}
+	if (tilemap.getRevision() == revision_)
+		return;
+
+	if (!tilemap.changesSince(revision_, changes_)) {
+		rebuild(tilemap, cancel);
+		return;
+	}
+	// A tile change affects every cell whose sensors can reach that tile
+	float farX = layout_.extents.x, farY = layout_.extents.y;
+	for (int i = 0; i < layout_.footCount; ++i)
+		farX = std::max(farX, std::abs(layout_.footOffsets[i]));
+	for (int i = 0; i < layout_.sideCount; ++i)
+		farY = std::max(farY, std::abs(layout_.sideOffsets[i]));
+	int reachX = static_cast<int>(std::ceil(farX / cellSize_)) + 1;
+	int reachY = static_cast<int>(std::ceil(farY / cellSize_)) + 1;
+	for (const auto& tile : changes_) {
+		updateCells(tilemap, tile.x * SUBDIV - reachX, tile.y * SUBDIV - reachY, (tile.x + 1) * SUBDIV - 1 + reachX,
+					(tile.y + 1) * SUBDIV - 1 + reachY);
+	}
+	revision_ = tilemap.getRevision();
+}
+
+void CollisionSpace::rebuild(const Tilemap& tilemap, const std::atomic<bool>* cancel) {
+	tilemapId_ = tilemap.getId();
+	revision_ = tilemap.getRevision();
+	tileSize_ = tilemap.getTileSize();
+	cellSize_ = tileSize_ / SUBDIV;
+	cellsX_ = tilemap.getWidth() * SUBDIV;
+	cellsY_ = tilemap.getHeight() * SUBDIV;
+	words_ = (cellsX_ + 63) / 64;
+	free_.assign(static_cast<size_t>(words_) * cellsY_, 0);
+	auto cancelled = [cancel] { return cancel && cancel->load(std::memory_order_relaxed); };
+	if (jobs_) {
+		// Each row owns its words, so bands of rows never share a write
+		jobs_->parallelFor("collision space rows", cellsY_, 16, [&](int begin, int end) {
+			if (!cancelled())
+				updateCells(tilemap, 0, begin, cellsX_ - 1, end - 1);
+		});
+	} else {
+		// Bands of a few rows, so a cancel is seen within milliseconds even on very wide maps
+		for (int cy = 0; cy < cellsY_ && !cancelled(); cy += 4)
+			updateCells(tilemap, 0, cy, cellsX_ - 1, cy + 3);
+	}
+	if (cancelled())
+		tilemapId_ = 0; // Half built; not a match for anything
+	rebuildCount_++;
+}
+
+void CollisionSpace::updateCells(const Tilemap& tilemap, int cx0, int cy0, int cx1, int cy1) {
+	cx0 = std::max(cx0, 0);
+	cy0 = std::max(cy0, 0);
+	cx1 = std::min(cx1, cellsX_ - 1);
+	cy1 = std::min(cy1, cellsY_ - 1);
+	for (int cy = cy0; cy <= cy1; ++cy) {
+		uint64_t* row = &free_[static_cast<size_t>(cy) * words_];
+		for (int cx = cx0; cx <= cx1; ++cx) {
+			uint64_t bit = uint64_t(1) << (cx & 63);
+			if (computeFree(tilemap, cx, cy)) {
+				row[cx >> 6] |= bit;
+			} else {
+				row[cx >> 6] &= ~bit;
+			}
+		}
+	}
+}
+
+bool CollisionSpace::computeFree(const Tilemap& tilemap, int cx, int cy) const {
+	// Centre positions covered by the cell, padded so float rounding in isFree() and the
+	// sensor offsets can never classify a touching position as free
+	const float pad = EPSILON;
+	float x0 = cx * cellSize_ - pad, x1 = (cx + 1) * cellSize_ + pad;
+	float y0 = cy * cellSize_ - pad, y1 = (cy + 1) * cellSize_ + pad;
+	auto tileIdx = [this](float v) { return static_cast<int>(std::floor(v / tileSize_)); };
+
+	// Left/right sensors sweep the cell's rows shifted by their offsets and -/+ extents.x
+	const glm::vec2& ext = layout_.extents;
+	for (int i = 0; i < layout_.sideCount; ++i) {
+		float off = layout_.sideOffsets[i];
+		int ty0 = tileIdx(y0 + off), ty1 = tileIdx(y1 + off);
+		if (tilemap.anySolidInRect(tileIdx(x0 - ext.x), ty0, tileIdx(x1 - ext.x), ty1))
+			return false;
+		if (tilemap.anySolidInRect(tileIdx(x0 + ext.x), ty0, tileIdx(x1 + ext.x), ty1))
+			return false;
+	}
+
+	// Bottom/top sensors sweep the cell's columns shifted by their offsets and -/+ extents.y
+	for (int i = 0; i < layout_.footCount; ++i) {
+		float off = layout_.footOffsets[i];
+		int tx0 = tileIdx(x0 + off), tx1 = tileIdx(x1 + off);
+		if (tilemap.anySolidInRect(tx0, tileIdx(y0 - ext.y), tx1, tileIdx(y1 - ext.y)))
+			return false;
+		if (tilemap.anySolidInRect(tx0, tileIdx(y0 + ext.y), tx1, tileIdx(y1 + ext.y)))
+			return false;
+	}
+	return true;
+}
+
+bool CollisionSpace::isFree(const glm::vec2& centre) const {
+	if (free_.empty())
+		return false;
+	return cellFree(static_cast<int>(std::floor(centre.x / cellSize_)), static_cast<int>(std::floor(centre.y / cellSize_)));
+}
+
+float CollisionSpace::sweep(const glm::vec2& centre, const glm::vec2& delta) const {
+	if (!isFree(centre))
+		return 0.0f;
+
+	glm::ivec2 cell(static_cast<int>(std::floor(centre.x / cellSize_)), static_cast<int>(std::floor(centre.y / cellSize_)));
+	int stepX = (delta.x > 0.0f) ? 1 : (delta.x < 0.0f ? -1 : 0);
+	int stepY = (delta.y > 0.0f) ? 1 : (delta.y < 0.0f ? -1 : 0);
+
+	// Same grid traversal as Tilemap::raycast, parametrised over the fraction of delta
+	const float inf = std::numeric_limits<float>::infinity();
+	float tMaxX = stepX != 0 ? ((cell.x + (stepX > 0 ? 1 : 0)) * cellSize_ - centre.x) / delta.x : inf;
+	float tMaxY = stepY != 0 ? ((cell.y + (stepY > 0 ? 1 : 0)) * cellSize_ - centre.y) / delta.y : inf;
+	float tDeltaX = stepX != 0 ? cellSize_ / std::abs(delta.x) : inf;
+	float tDeltaY = stepY != 0 ? cellSize_ / std::abs(delta.y) : inf;
+
+	while (true) {
+		float t;
+		if (tMaxX < tMaxY) {
+			t = tMaxX;
+			cell.x += stepX;
+			tMaxX += tDeltaX;
+		} else {
+			t = tMaxY;
+			cell.y += stepY;
+			tMaxY += tDeltaY;
+		}
+		if (t >= 1.0f)
+			return 1.0f;
+		if (!cellFree(cell.x, cell.y))
+			return t;
+	}
+}
@@ -0,0 +1,327 @@
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include "compiledlevel.hpp"
+#include "debug.hpp"
+#include "globals.hpp"
+#include "tilemesh.hpp"
+#include "tileworld.hpp"
+
+namespace fs = std::filesystem;
+
+static const char COMPILED_LEVEL_MAGIC[4] = {'T', 'L', 'V', 'L'};
+
+static uint64_t alignUp(uint64_t offset, uint64_t alignment) { return (offset + alignment - 1) / alignment * alignment; }
+
+bool statLevelSource(const std::string& tmapPath, LevelSource& source) {
+	std::error_code ec;
+	source.size = fs::file_size(tmapPath, ec);
+	if (ec)
+		return false;
+	source.modified = fs::last_write_time(tmapPath, ec).time_since_epoch().count();
+	return !ec;
+}
+
+std::string compiledLevelPath(const std::string& tmapPath) {
+	fs::path path(tmapPath);
+	return (path.parent_path() / ".compiled" / path.stem()).string() + ".tlvl";
+}
+
+// Stops early once *cancel is set; the caller checks it and throws the table away
+static std::vector<LevelChunkInfo> countChunks(const Tilemap& tilemap, const std::atomic<bool>* cancel = nullptr) {
+	const int chunkTiles = TileMesh::CHUNK_TILES;
+	const int chunksX = (tilemap.getWidth() + chunkTiles - 1) / chunkTiles;
+	const int chunksY = (tilemap.getHeight() + chunkTiles - 1) / chunkTiles;
+	std::vector<LevelChunkInfo> chunks(static_cast<size_t>(chunksX) * chunksY, LevelChunkInfo{0, 0});
+	for (int y = 0; y < tilemap.getHeight(); ++y) {
+		if (cancel && cancel->load(std::memory_order_relaxed))
+			break;
+		const uint8_t* row = tilemap.getTileRow(y);
+		LevelChunkInfo* chunkRow = &chunks[static_cast<size_t>(y / chunkTiles) * chunksX];
+		for (int x = 0; x < tilemap.getWidth(); ++x) {
+			chunkRow[x / chunkTiles].visibleTiles += tilemap.getPaletteEntry(row[x]).tileType.visible;
+			chunkRow[x / chunkTiles].solidTiles += tilemap.isSolidTile(x, y);
+		}
+	}
+	return chunks;
+}
+
+CompiledPaletteEntry compilePaletteEntry(const TilePaletteEntry& entry) {
+	const glm::vec4& c = entry.tileType.color;
+	return {static_cast<uint8_t>(entry.tileType.type), entry.tileType.visible, entry.tileType.solid,
+			static_cast<uint8_t>(entry.skin), {c.r, c.g, c.b, c.a}};
+}
+
+TilePaletteEntry readPaletteEntry(const CompiledPaletteEntry& entry) {
+	return {{static_cast<TileEnum>(entry.type), entry.visible != 0, entry.solid != 0,
+			 glm::vec4(entry.color[0], entry.color[1], entry.color[2], entry.color[3])},
+			static_cast<TileSkin>(entry.skin)};
+}
+
+std::vector<LevelMarker> collectLevelMarkers(const Tilemap& tilemap) {
+	auto at = [](LevelMarkerKind kind, glm::ivec2 tile) { return LevelMarker{kind, tile.x, tile.y, 0, 0, 0}; };
+	std::vector<LevelMarker> markers = {at(LevelMarkerKind::PLAYER, tilemap.getPlayerPosition()),
+										at(LevelMarkerKind::GOAL, tilemap.getGoalPos()),
+										at(LevelMarkerKind::DEATH_WALL_START, tilemap.getDeathWallStartPosition()),
+										at(LevelMarkerKind::DEATH_WALL_END, tilemap.getDeathWallEndPosition())};
+	for (const PlatformSpawn& spawn : tilemap.getPlatformSpawns()) {
+		markers.push_back({LevelMarkerKind::PLATFORM, spawn.tile.x, spawn.tile.y, spawn.width, spawn.travel.x,
+						   spawn.travel.y});
+	}
+	return markers;
+}
+
+bool writeCompiledLevel(const Tilemap& tilemap, const std::string& path, const LevelSource& source,
+						std::vector<LevelChunkInfo>* chunks, const std::atomic<bool>* cancel) {
+	auto cancelled = [cancel] { return cancel && cancel->load(std::memory_order_relaxed); };
+	std::vector<CompiledPaletteEntry> palette;
+	for (const TilePaletteEntry& entry : tilemap.getPalette())
+		palette.push_back(compilePaletteEntry(entry));
+	std::vector<LevelMarker> markers = collectLevelMarkers(tilemap);
+
+	std::vector<LevelChunkInfo> chunkTable = countChunks(tilemap, cancel);
+	if (cancelled())
+		return false;
+	const std::vector<CollisionRect>& rects = tilemap.getCollisionRects();
+
+	CompiledLevelHeader header = {};
+	std::memcpy(header.magic, COMPILED_LEVEL_MAGIC, sizeof(header.magic));
+	header.version = COMPILED_LEVEL_VERSION;
+	header.width = tilemap.getWidth();
+	header.height = tilemap.getHeight();
+	header.sourceSize = source.size;
+	header.sourceModified = source.modified;
+	header.paletteCount = static_cast<uint32_t>(palette.size());
+	header.markerCount = static_cast<uint32_t>(markers.size());
+	header.chunkTiles = TileMesh::CHUNK_TILES;
+	header.chunkCount = static_cast<uint32_t>(chunkTable.size());
+	header.rectCount = rects.size();
+	header.paletteOffset = alignUp(sizeof(header), 8);
+	header.markerOffset = alignUp(header.paletteOffset + palette.size() * sizeof(CompiledPaletteEntry), 8);
+	header.chunkOffset = alignUp(header.markerOffset + markers.size() * sizeof(LevelMarker), 8);
+	header.rectOffset = alignUp(header.chunkOffset + chunkTable.size() * sizeof(LevelChunkInfo), 8);
+	header.gridOffset = alignUp(header.rectOffset + rects.size() * sizeof(CollisionRect), 64);
+	header.gridBytes = tilemap.getStorageBytes();
+
+	// Everything up to the grids is small; assemble it and write the grids straight from the tilemap
+	std::vector<uint8_t> prefix(header.gridOffset, 0);
+	auto put = [&](uint64_t offset, const void* data, size_t bytes) {
+		if (bytes > 0)
+			std::memcpy(&prefix[offset], data, bytes);
+	};
+	put(0, &header, sizeof(header));
+	put(header.paletteOffset, palette.data(), palette.size() * sizeof(CompiledPaletteEntry));
+	put(header.markerOffset, markers.data(), markers.size() * sizeof(LevelMarker));
+	put(header.chunkOffset, chunkTable.data(), chunkTable.size() * sizeof(LevelChunkInfo));
+	put(header.rectOffset, rects.data(), rects.size() * sizeof(CollisionRect));
+
+	fs::path target(path);
+	std::error_code ec;
+	if (target.has_parent_path())
+		fs::create_directories(target.parent_path(), ec);
+	fs::path temp = target;
+	temp += ".tmp";
+	{
+		std::ofstream file(temp.string(), std::ios::binary | std::ios::trunc);
+		if (!file.is_open()) {
+			std::cerr << "[CompiledLevel] Failed to write " << temp << std::endl;
+			return false;
+		}
+		file.write(reinterpret_cast<const char*>(prefix.data()), prefix.size());
+		// The grids go out in blocks so a cancel doesn't wait for the whole level to hit the disk
+		const size_t WRITE_BLOCK = 1u << 20;
+		const char* grids = reinterpret_cast<const char*>(tilemap.getStorage());
+		for (uint64_t done = 0; done < header.gridBytes && file && !cancelled(); done += WRITE_BLOCK) {
+			file.write(grids + done, std::min<uint64_t>(WRITE_BLOCK, header.gridBytes - done));
+		}
+		if (cancelled()) {
+			file.close();
+			fs::remove(temp, ec);
+			return false;
+		}
+		if (!file) {
+			std::cerr << "[CompiledLevel] Failed to write " << temp << std::endl;
+			return false;
+		}
+	}
+	fs::rename(temp, target, ec);
+	if (ec) {
+		std::cerr << "[CompiledLevel] Failed to replace " << target << ": " << ec.message() << std::endl;
+		return false;
+	}
+	if (chunks)
+		*chunks = std::move(chunkTable);
+	return true;
+}
+
+static void applyLevelMarkers(Tilemap& tilemap, const std::vector<LevelMarker>& markers) {
+	for (const LevelMarker& marker : markers) {
+		switch (marker.kind) {
+			case LevelMarkerKind::PLAYER:
+				tilemap.setPlayerPos(marker.x, marker.y);
+				break;
+			case LevelMarkerKind::GOAL:
+				tilemap.setGoalPos(marker.x, marker.y);
+				break;
+			case LevelMarkerKind::DEATH_WALL_START:
+				tilemap.setDeathWallStartPos(marker.x, marker.y);
+				break;
+			case LevelMarkerKind::DEATH_WALL_END:
+				tilemap.setDeathWallEndPos(marker.x, marker.y);
+				break;
+			case LevelMarkerKind::PLATFORM:
+				tilemap.addPlatformSpawn({glm::ivec2(marker.x, marker.y), marker.width, glm::ivec2(marker.travelX, marker.travelY)});
+				break;
+		}
+	}
+}
+
+bool loadCompiledLevel(const std::string& path, float tileSize, Texture* floorTex, Texture* wallTex, Tilemap& tilemap,
+					   const LevelSource* source, std::vector<LevelChunkInfo>* chunks) {
+	auto file = std::make_unique<MappedFile>();
+	if (!file->open(path))
+		return false;
+	const uint8_t* data = file->getData();
+	const uint64_t size = file->getSize();
+
+	CompiledLevelHeader header;
+	if (size < sizeof(header))
+		return false;
+	std::memcpy(&header, data, sizeof(header));
+	if (std::memcmp(header.magic, COMPILED_LEVEL_MAGIC, sizeof(header.magic)) != 0 || header.version != COMPILED_LEVEL_VERSION)
+		return false; // Older build's file; the caller recompiles
+	if (source && (header.sourceSize != source->size || header.sourceModified != source->modified))
+		return false; // Stale
+
+	// Everything below is checked against the file before it's read, so a truncated or
+	// corrupt file is rejected rather than read past
+	auto fits = [size](uint64_t offset, uint64_t count, uint64_t elementSize) {
+		return offset <= size && count <= (size - offset) / elementSize;
+	};
+	const uint64_t tiles = static_cast<uint64_t>(std::max(header.width, 0)) * std::max(header.height, 0);
+	const uint64_t chunkTiles = std::max<uint32_t>(header.chunkTiles, 1);
+	const uint64_t expectedChunks = ((header.width + chunkTiles - 1) / chunkTiles) * ((header.height + chunkTiles - 1) / chunkTiles);
+	if (tiles == 0 || tiles > static_cast<uint64_t>(INT32_MAX) || header.paletteCount == 0 ||
+		header.paletteCount > static_cast<uint32_t>(Tilemap::MAX_PALETTE) || header.chunkCount != expectedChunks ||
+		header.gridBytes != Tilemap::storageBytes(header.width, header.height) || header.gridOffset % 8 != 0 ||
+		!fits(header.paletteOffset, header.paletteCount, sizeof(CompiledPaletteEntry)) ||
+		!fits(header.markerOffset, header.markerCount, sizeof(LevelMarker)) ||
+		!fits(header.chunkOffset, header.chunkCount, sizeof(LevelChunkInfo)) ||
+		!fits(header.rectOffset, header.rectCount, sizeof(CollisionRect)) || !fits(header.gridOffset, header.gridBytes, 1)) {
+		std::cerr << "[CompiledLevel] Ignoring malformed level file: " << path << std::endl;
+		return false;
+	}
+
+	std::vector<TilePaletteEntry> palette(header.paletteCount);
+	for (uint32_t i = 0; i < header.paletteCount; ++i) {
+		CompiledPaletteEntry entry;
+		std::memcpy(&entry, data + header.paletteOffset + i * sizeof(entry), sizeof(entry));
+		palette[i] = readPaletteEntry(entry);
+	}
+	std::vector<CollisionRect> rects(header.rectCount);
+	std::memcpy(rects.data(), data + header.rectOffset, rects.size() * sizeof(CollisionRect));
+	for (const CollisionRect& rect : rects) {
+		// Indexed by row as soon as the tilemap takes them
+		if (rect.x0 < 0 || rect.y0 < 0 || rect.x0 > rect.x1 || rect.y0 > rect.y1 || rect.x1 >= header.width ||
+			rect.y1 >= header.height) {
+			std::cerr << "[CompiledLevel] Ignoring malformed level file: " << path << std::endl;
+			return false;
+		}
+	}
+	std::vector<LevelMarker> markers(header.markerCount);
+	std::memcpy(markers.data(), data + header.markerOffset, markers.size() * sizeof(LevelMarker));
+	if (chunks) {
+		chunks->clear();
+		if (header.chunkTiles == static_cast<uint32_t>(TileMesh::CHUNK_TILES)) {
+			chunks->resize(header.chunkCount);
+			std::memcpy(chunks->data(), data + header.chunkOffset, chunks->size() * sizeof(LevelChunkInfo));
+		}
+	}
+
+	Tilemap loaded(header.width, header.height, tileSize, std::move(file), header.gridOffset, palette, std::move(rects));
+	loaded.setTextures(floorTex, wallTex);
+	applyLevelMarkers(loaded, markers);
+	tilemap = std::move(loaded);
+	return true;
+}
+
+// Reads the whole world into tilemap through TileWorld, chunk by chunk
+static bool loadTileWorld(const std::string& path, float tileSize, Texture* floorTex, Texture* wallTex, Tilemap& tilemap) {
+	TileWorld world;
+	if (!world.open(path, tileSize))
+		return false;
+	const int N = WORLD_CHUNK_TILES;
+	Tilemap loaded(world.getWidth(), world.getHeight(), tileSize);
+	loaded.setTextures(floorTex, wallTex);
+	auto empty = [&](uint8_t index) { return world.getPaletteEntry(index).tileType.type == TileEnum::EMPTY; };
+	world.scanChunks(
+		[&](int x0, int y0, const uint8_t* tiles) {
+			for (int y = 0; y < std::min(N, world.getHeight() - y0); ++y) {
+				for (int x = 0; x < std::min(N, world.getWidth() - x0); ++x) {
+					const uint8_t index = tiles[y * N + x];
+					if (!empty(index))
+						loaded.setTile(x0 + x, y0 + y, world.getPaletteEntry(index).tileType, world.getPaletteEntry(index).skin);
+				}
+			}
+		},
+		empty);
+	loaded.mergeCollisionRects();
+	applyLevelMarkers(loaded, world.getMarkers());
+	tilemap = std::move(loaded);
+	return true;
+}
+
+Tilemap loadLevelFile(const std::string& path, float tileSize, Texture* floorTex, Texture* wallTex, LoadProgress* progress,
+					  std::vector<LevelChunkInfo>* chunks) {
+	Tilemap tilemap(1, 1, tileSize);
+	if (fs::path(path).extension() == ".tlvl") {
+		if (!loadCompiledLevel(path, tileSize, floorTex, wallTex, tilemap, nullptr, chunks)) {
+			std::cerr << "Failed to load compiled level: " << path << std::endl;
+			throw std::runtime_error("Failed to load compiled level");
+		}
+	} else if (fs::path(path).extension() == ".tworld") {
+		if (!loadTileWorld(path, tileSize, floorTex, wallTex, tilemap)) {
+			std::cerr << "Failed to load tile world: " << path << std::endl;
+			throw std::runtime_error("Failed to load tile world");
+		}
+	} else {
+		LevelSource source;
+		const std::string cachePath = compiledLevelPath(path);
+		if (!statLevelSource(path, source) ||
+			!loadCompiledLevel(cachePath, tileSize, floorTex, wallTex, tilemap, &source, chunks)) {
+			// First load of this version of the file
+			tilemap = loadTilemapFromFile(path, tileSize, floorTex, wallTex, progress);
+			const std::atomic<bool>* cancel = progress ? &progress->cancelled : nullptr;
+			if (writeCompiledLevel(tilemap, cachePath, source, chunks, cancel)) {
+				DEBUG_ONLY(std::cout << "[CompiledLevel] Cached " << path << " as " << cachePath << std::endl;);
+			}
+			if (cancel && cancel->load(std::memory_order_relaxed))
+				throw std::runtime_error("Tilemap load cancelled");
+		}
+	}
+	if (progress)
+		progress->fraction.store(1.0f, std::memory_order_relaxed);
+	return tilemap;
+}
+
+int compileLevelFile(const std::string& tmapPath, const std::string& outPath) {
+	const std::string target = outPath.empty() ? compiledLevelPath(tmapPath) : outPath;
+	LevelSource source;
+	if (!statLevelSource(tmapPath, source)) {
+		std::cerr << "Level file not found: " << tmapPath << std::endl;
+		return 1;
+	}
+	try {
+		Tilemap tilemap = loadTilemapFromFile(tmapPath, TILE_SIZE, nullptr, nullptr);
+		// A .tworld target gets the streaming format instead, see TileWorld
+		const bool world = fs::path(target).extension() == ".tworld";
+		if (world ? !writeTileWorld(tilemap, target) : !writeCompiledLevel(tilemap, target, source))
+			return 1;
+		std::cout << "Compiled " << tmapPath << " (" << tilemap.getWidth() << "x" << tilemap.getHeight() << ") to " << target
+				  << std::endl;
+	} catch (const std::exception& e) {
+		std::cerr << "Failed to compile " << tmapPath << ": " << e.what() << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -1,6 +1,6 @@
 #include "debug.hpp"
 
-bool g_debugEnabled = false; // Global debug flag
+std::atomic<bool> g_debugEnabled{false}; // Global debug flag
 
 void toggleDebugMode() {
 	g_debugEnabled = !g_debugEnabled;
@@ -8,9 +8,44 @@ GameManager::GameManager(Window& window, Shader& shader, Renderer2D& renderer, L
 	gameState_ = GameState::MENU;
 
 	hasLevels_ = levelManager_.loadLevelList();  // pre-load levels list
+	physics_.setEventBus(&events_);
+	physics_.setJobSystem(&jobs_);
+	scene_.setJobSystem(&jobs_);
+	events_.subscribe<ReachedGoalEvent, GameManager, &GameManager::onReachedGoal>(this);
+	events_.subscribe<PlayerDiedEvent, GameManager, &GameManager::onPlayerDied>(this);
+	events_.subscribe<CheckpointReachedEvent, GameManager, &GameManager::onCheckpointReached>(this);
+	registry_.sync(objects_);
+	behaviors_.build(objects_, registry_);
+	deathWall_ = registry_.findFirst(internTag("DeathWall"));
+	platforms_.load(tilemap_);
+	triggers_.load(tilemap_);
+	tileMesh_.build(tilemap_);
+	levelCache_.configure(levelManager_.floorTex_, levelManager_.wallTex_, player_.getSensorLayout());
 }
 
+void GameManager::onReachedGoal(const ReachedGoalEvent& event) {
+	if (stateRequested_.load(std::memory_order_relaxed))
+		return;
+	requestState(GameState::WIN);
+	DEBUG_ONLY(std::cout << "Player reached goal, transitioning to WIN state." << std::endl;);
+}
+
+void GameManager::onPlayerDied(const PlayerDiedEvent& event) {
+	if (stateRequested_.load(std::memory_order_relaxed))
+		return; // Already won or died this step
+	requestState(GameState::DEAD);
+	DEBUG_ONLY(std::cout << "Player died (cause " << static_cast<int>(event.cause) << "), transitioning to DEAD state." << std::endl;);
+}
+
+void GameManager::onCheckpointReached(const CheckpointReachedEvent& event) { triggers_.setCheckpoint(event.trigger); }
+
 void GameManager::setState(GameState state) {
+	// Anything leaving PLAY (including a force quit) first waits out the simulation step,
+	// after which this thread owns the game state again
+	if (sim_.isStarted()) {
+		sim_.stop();
+		stateRequested_.store(false);
+	}
 	Input::clear();
 
 	// Reset timing when entering PLAY state to avoid delta time glitches
@@ -26,6 +61,8 @@ void GameManager::runGameLoop() {
 	// Force quit button in any state
 
 	Input::update();
+	levelCache_.poll(); // Background level loads finishing, in any state
+	levelManager_.pollLevelList(); // Levels the directory scan found or re-read
 
 	// Toggle true fullscreen: F11 or Alt+Enter
 	bool altPressed = Input::isKeyPressed(GLFW_KEY_LEFT_ALT) || Input::isKeyPressed(GLFW_KEY_RIGHT_ALT);
@@ -47,6 +84,9 @@ void GameManager::runGameLoop() {
 		case GameState::LEVEL_SELECT:
 			handleMenuState(); // For now, LEVEL_SELECT uses same handler as MENU
 			break;
+		case GameState::LOADING:
+			handleLoadingState();
+			break;
 		case GameState::PLAY:
 			handlePlayState();
 			break;
@@ -170,7 +210,9 @@ void GameManager::handleMenuState() {
 
 			static int selectedLevelIndex = -1;
 
-			if (levels.empty()) {
+			if (levels.empty() && levelManager_.isScanning()) {
+				ImGui::Text("Looking for levels...");
+			} else if (levels.empty()) {
 				ImGui::Text("No levels found in ./assets/levels/");
 				ImGui::Text("Please add some .tmap files to the levels directory.");
 			} else {
@@ -183,11 +225,18 @@ void GameManager::handleMenuState() {
 					ImGui::SetWindowFontScale(2.0f);
 					for (int i = 0; i < (int)levels.size(); i++) {
 						const auto& level = levels[i];
+						if (!level.available)
+							continue; // Deleted since the index was written
 						bool isSelected = (selectedLevelIndex == i);
 						
 						// Use Selectable for larger, more prominent selection boxes
 						if (ImGui::Selectable(level.displayName.c_str(), isSelected, 0, ImVec2(0, 30))) {
-							selectedLevelIndex = i;
+							if (i != selectedLevelIndex) {
+								// Prepare the highlighted level once the player stops on it; the previous pick isn't wanted anymore
+								if (selectedLevelIndex >= 0) levelCache_.evict(levelPath(selectedLevelIndex));
+								selectedLevelIndex = i;
+								levelCache_.prefetchSettled(levelPath(i));
+							}
 						}
 						
 						// Optional: Add hover tooltip with basic info
@@ -215,6 +264,13 @@ void GameManager::handleMenuState() {
 						ImGui::Text("Name: %s", selectedLevel.displayName.c_str());
 						ImGui::Text("File: %s", selectedLevel.filename.c_str());
 						ImGui::Text("Dimensions: %dx%d tiles", selectedLevel.dimensions.x, selectedLevel.dimensions.y);
+						ImGui::Text("Checkpoints: %d, hazards: %d", selectedLevel.checkpoints, selectedLevel.hazards);
+						std::string path = selectedLevel.filepath.string();
+						if (levelCache_.isCached(path)) {
+							ImGui::Text("Ready to play");
+						} else if (levelCache_.isLoading(path) || levelCache_.isPending(path)) {
+							ImGui::Text("Preparing... %d%%", static_cast<int>(levelCache_.getLoader().getProgress() * 100.0f));
+						}
 						// Add more metadata fields here as you expand the system
 						// ImGui::Text("Description: %s", selectedLevel.description.c_str());
 						ImGui::Unindent();
@@ -232,38 +288,11 @@ void GameManager::handleMenuState() {
 			if (selectedLevelIndex >= 0 && !levels.empty()) {
 				if (ImGui::Button("Load Level", ImVec2(400, 0))) {
 					try {
-						// Load the selected level
-						tilemap_ = levelManager_.loadLevel(selectedLevelIndex);
-						
-						// Reset player to new level's starting position
-						player_.setPosition(tilemap_.tileIndexToWorldPos(tilemap_.getInitPlayerPos().x, tilemap_.getInitPlayerPos().y) + glm::vec2(tilemap_.getTileSize() / 2.0f, tilemap_.getTileSize() / 2.0f));
-						player_.setVelocity(glm::vec2(0.0f, 0.0f));
-						player_.setAcceleration(glm::vec2(0.0f, 0.0f));
-						player_.moveState_ = MoveState::IDLE;
-						player_.prevMoveState_ = MoveState::IDLE;
-						// player_.currentFrame_ = player_.idleAnim.startIdx;
-						// player_.initAnimation();
-						std::cout<<"Loading anim"<<std::endl;
-						player_.initAtlasAnimation();
-						player_.sensorUpdate();
-						player_.setShouldDie(false);
-						player_.setGoalCount(0);
-						player_.setInGoal(false);
-						
-						levelCountdown_ = true;
+						// Load the selected level in the background; LOADING shows progress
+						beginLevelLoad(selectedLevelIndex);
 
-						// Reset death wall if it exists
-						if (!objects_.empty()) {
-							auto* deathWallBehavior = dynamic_cast<DeathWallBehavior*>(objects_[0].getBehavior());
-							if (deathWallBehavior) {
-								deathWallBehavior->reset(objects_[0]);
-							}
-						}
-						
 						ImGui::CloseCurrentPopup();
 						selectedLevelIndex = -1; // Reset for next time
-						setState(GameState::PLAY);
-						
 					} catch (const std::exception& e) {
 						std::cerr << "Failed to load level: " << e.what() << std::endl;
 					}
@@ -279,6 +308,7 @@ void GameManager::handleMenuState() {
 			ImGui::SameLine();
 			if (ImGui::Button("Cancel", ImVec2(400, 0))) { 
 				ImGui::CloseCurrentPopup();
+				if (selectedLevelIndex >= 0) levelCache_.evict(levelPath(selectedLevelIndex));
 				selectedLevelIndex = -1; // Reset selection
 			}
 			ImGui::EndPopup();
@@ -299,109 +329,337 @@ void GameManager::handleMenuState() {
 	); 
 }
 
-void GameManager::handlePlayState() {
-	float currentFrameTime = glfwGetTime();
-	auto frameStart = std::chrono::high_resolution_clock::now();
-	float deltaTime = currentFrameTime - lastFrameTime_;
-	lastFrameTime_ = currentFrameTime;
+void GameManager::beginLevelLoad(int levelIndex) {
+	std::string path = levelPath(levelIndex);
+	if (path.empty()) {
+		throw std::out_of_range("Invalid level index");
+	}
+	// Usually already prefetched, or at least under way
+	if (levelCache_.hasFailed(path)) {
+		levelCache_.cancel(); // Try again instead of showing the old error
+	}
+	levelCache_.prefetch(path);
+	loadingPath_ = path;
+	currentLevelIndex_ = levelIndex;
+	levelPending_ = false;
+	setState(GameState::LOADING);
+}
 
-	// Poll for events
+std::string GameManager::levelPath(int levelIndex) const {
+	const auto& levels = levelManager_.getAvailableLevels();
+	if (levelIndex < 0 || levelIndex >= static_cast<int>(levels.size()) || !levels[levelIndex].available)
+		return "";
+	return levels[levelIndex].filepath.string();
+}
+
+void GameManager::applyLoadedLevel(LoadedLevel&& level) {
+	// Nothing else runs outside PLAY, so this thread owns the game state here
+	tileMesh_.release(renderer_);
+	tilemap_ = std::move(level.tilemap);
+	world_ = std::move(level.world);
+	if (world_)
+		triggers_ = std::move(level.triggers);
+	physics_.setPlayerSpace(std::move(level.playerSpace));
+	tileMesh_ = std::move(level.mesh);
+	levelPending_ = true;
+	pendingChunks_ = std::max(1, tileMesh_.getChunkCount());
+}
+
+void GameManager::startLevel() {
+	player_.moveState_ = MoveState::IDLE;
+	player_.prevMoveState_ = MoveState::IDLE;
+	// player_.currentFrame_ = player_.idleAnim.startIdx;
+	// player_.initAnimation();
+	std::cout<<"Loading anim"<<std::endl;
+	player_.initAtlasAnimation();
+	resetLevelState(false);
+
+	levelCountdown_ = true;
+	setState(GameState::PLAY);
+}
+
+void GameManager::resetLevelState(bool keepCheckpoint) {
+	const glm::ivec2 start = world_ ? world_->getPlayerPosition() : tilemap_.getInitPlayerPos();
+	const float T = world_ ? world_->getTileSize() : tilemap_.getTileSize();
+	glm::vec2 spawn = glm::vec2(start.x * T, start.y * T) + glm::vec2(T / 2.0f, T / 2.0f);
+	if (keepCheckpoint)
+		triggers_.getCheckpointSpawn(spawn);
+	player_.setPosition(spawn);
+	player_.setVelocity(glm::vec2(0.0f, 0.0f));
+	player_.setAcceleration(glm::vec2(0.0f, 0.0f));
+	player_.sensorUpdate();
+
+	events_.discard(); // Anything the last attempt published
+
+	// Reset death walls
+	behaviors_.resetDeathWalls(objects_);
+	activity_.wakeAll();
+	if (world_)
+		platforms_.load(world_->getPlatformSpawns(), world_->getTileSize());
+	else
+		platforms_.load(tilemap_);
+	if (keepCheckpoint)
+		triggers_.clearContacts();
+	else if (world_)
+		triggers_.restart(); // Read out of the world when it loaded
+	else
+		triggers_.load(tilemap_);
+}
+
+void GameManager::handleLoadingState() {
 	window_.pollEvents();
 
-	if(levelCountdown_){
-		if(countdownTimer_ <= 0.0f){
-			countdownTimer_ = 3.0f;
+	// A finished load is moved in on this thread; its tile buffers then upload a few
+	// chunks per frame so no single frame pays for all of them
+	if (!levelPending_) {
+		levelCache_.prefetch(loadingPath_); // Restarts it if something pushed it out meanwhile
+		if (std::unique_ptr<LoadedLevel> level = levelCache_.take(loadingPath_)) {
+			applyLoadedLevel(std::move(*level));
 		}
-		countdownTimer_ -= deltaTime;
-		if(countdownTimer_ <= 0.0f){
-			levelCountdown_ = false;
-		}
-	} else{
-		auto inputResult = playerInput(player_);
-		
-		if (inputResult == InputResult::PAUSE) {
-			setState(GameState::PAUSE);
-			DEBUG_ONLY(std::cout << "Pausing game." << std::endl;);
-			return;
-		}
-		physics_.deltaTime = deltaTime; // Update physics system delta time - kinda weird, might consolidate
-		
-		updatePStatePlayer(player_, physics_, tilemap_, objects_, deltaTime);
-		if (player_.checkIfInGoal()) {
-			// Transition to WIN state
-			setState(GameState::WIN);
-			DEBUG_ONLY(std::cout << "Player reached goal, transitioning to WIN state." << std::endl;);
-			return;
-		}
-		if (player_.getShouldDie()) {
-			// Transition to DEAD state
-			setState(GameState::DEAD);
-			DEBUG_ONLY(std::cout << "Player died, transitioning to DEAD state." << std::endl;);
-			return;
-		}
-		static float frameDuration;
-		player_.updateMoveState();
-		if(player_.getSpeed().x <= 5.0f){
-			frameDuration = 1 / 8.0f; // 8 FPS
-		} else if(player_.getSpeed().x <= 10.0f){
-			frameDuration = 1 / 12.0f; // 12 FPS
-		} else if(player_.getSpeed().x <= 16.0f){
-			frameDuration = 1 / 16.0f; // 16 FPS
-		} else if(player_.getSpeed().x <= 28.0f){
-			frameDuration = 1 / 20.0f; // 20 FPS
-		} else if(player_.getSpeed().x > 32.0f){
-			frameDuration = 1 / 30.0f; // 24 FPS
+	}
+	const LevelLoader& loader = levelCache_.getLoader();
+	bool failed = levelCache_.hasFailed(loadingPath_);
+	float progress = levelCache_.isLoading(loadingPath_) ? 0.9f * loader.getProgress() : 0.0f;
+	const char* status = LevelLoader::stageName(loader.getStage());
+	bool finished = false;
+	if (levelPending_) {
+		int remaining = tileMesh_.upload(renderer_, TILE_UPLOADS_PER_FRAME);
+		progress = 0.9f + 0.1f * (1.0f - static_cast<float>(remaining) / pendingChunks_);
+		status = "Uploading tiles";
+		finished = remaining == 0;
+	}
+
+	int fbWidth, fbHeight;
+	window_.getFramebufferSize(fbWidth, fbHeight);
+	glm::mat4 projection = glm::ortho(0.0f, static_cast<float>(fbWidth), 0.0f, static_cast<float>(fbHeight), -1.0f, 1.0f);
+	renderer_.beginScene(shader_, IDENTITY_MATRIX, projection);
+	glm::mat4 model = IDENTITY_MATRIX;
+	model = glm::translate(model, glm::vec3(fbWidth / 2.0f, fbHeight / 2.0f, 0.0f));
+	model = glm::scale(model, glm::vec3(fbWidth, fbHeight, 1.0f));
+	renderer_.drawQuad(shader_, model, hexToVec4("#2d0664"));
+
+	ImGui_ImplOpenGL3_NewFrame();
+	ImGui_ImplGlfw_NewFrame();
+	ImGui::NewFrame();
+	auto menuFlags = ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoMove;
+	ImGuiViewport* viewport = ImGui::GetMainViewport();
+	ImVec2 windowSize(800, 240);
+	ImVec2 windowPos(viewport->WorkPos.x + (viewport->WorkSize.x - windowSize.x) * 0.5f,
+					 viewport->WorkPos.y + (viewport->WorkSize.y - windowSize.y) * 0.5f);
+	ImGui::SetNextWindowPos(windowPos, ImGuiCond_Always);
+	ImGui::SetNextWindowSize(windowSize, ImGuiCond_Always);
+
+	bool backToMenu = false;
+	if (ImGui::Begin("Loading", nullptr, menuFlags)) {
+		ImGui::SetWindowFontScale(2.0f);
+		std::string name = fs::path(loadingPath_).filename().string();
+		ImGui::Text("Loading %s", name.c_str());
+		ImGui::Dummy(ImVec2(0.0f, 20.0f));
+
+		if (failed) {
+			ImGui::TextWrapped("Failed to load level: %s", loader.getError().c_str());
+			ImGui::Dummy(ImVec2(0.0f, 20.0f));
+			backToMenu = ImGui::Button("Back", ImVec2(400, 50));
+		} else {
+			ImGui::ProgressBar(progress, ImVec2(-1.0f, 40.0f), status);
+			ImGui::Dummy(ImVec2(0.0f, 20.0f));
+			// Once moved in the level is the current one; only the upload is left
+			if (!levelPending_) {
+				backToMenu = ImGui::Button("Cancel", ImVec2(400, 50));
+			}
 		}
-		player_.updateAtlasAnimation(deltaTime, frameDuration);
+	}
+	ImGui::End();
 
-		
-		// updateDeathWall(objects_[0], deltaTime); // Update the death wall behavior
+	ImGui::Render();
+	ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+	finishDraw(window_, renderer_, shader_);
+
+	if (backToMenu) {
+		levelCache_.evict(loadingPath_);
+		setState(GameState::MENU);
+	} else if (finished) {
+		levelPending_ = false;
+		startLevel();
+	}
+}
+
+void GameManager::handlePlayState() {
+	// The simulation runs on its own thread while in PLAY; this thread only draws the
+	// snapshots it publishes, so vsync no longer holds the simulation back
+	if (!sim_.isStarted()) {
+		startSimulation();
+	}
+
+	// Poll for events
+	window_.pollEvents();
+
+	int fbWidth, fbHeight;
+	window_.getFramebufferSize(fbWidth, fbHeight);
+	if (fbWidth > 0 && fbHeight > 0) {
+		viewAspect_.store(static_cast<float>(fbWidth) / static_cast<float>(fbHeight));
+	}
+
+	// Chunks a load didn't get to (or the startup level's) upload a few per frame; until
+	// then they draw tile by tile
+	if (!tileMesh_.isUploaded()) {
+		tileMesh_.upload(renderer_, TILE_UPLOADS_PER_FRAME);
 	}
-	// drawVisuals(window_, renderer_, shader_, tilemap_, player_, objects_);
-	drawBackground(window_, renderer_, shader_, levelManager_, player_);
-	drawTilemapAndPlayer(window_, renderer_, shader_, tilemap_, player_);
-	drawObjects(window_, renderer_, shader_, objects_);
+
+	const FrameSnapshot& frame = frames_.acquire();
+	drawFrame(window_, renderer_, shader_, levelManager_, tilemap_, tileMesh_, frame);
 
 	ImGui_ImplOpenGL3_NewFrame();
 	ImGui_ImplGlfw_NewFrame();
 	ImGui::NewFrame();
 	
-	ImGui::SetNextWindowSize(ImVec2(570, 280), ImGuiCond_Always);
+	ImGui::SetNextWindowSize(ImVec2(570, 300), ImGuiCond_Always);
 	ImGui::SetNextWindowPos(ImVec2(15, 15), ImGuiCond_Always);
 	ImGui::SetNextWindowBgAlpha(0.5f); // Transparent background
 	
 	if (g_debugEnabled) {
+		const FrameStats& stats = frame.stats;
 		ImGui::PushFont(Fonts::mediumFont);
 		if (ImGui::Begin("Debug Info")) {
-			ImGui::Text("Player Position: %.2f, %.2f", player_.getPosition().x, player_.getPosition().y);
-			ImGui::Text("Player Velocity: %.2f, %.2f", player_.getVelocity().x, player_.getVelocity().y);
-			ImGui::Text("Player Move State: %s", moveStateToString(player_.moveState_).c_str());
-			// ImGui::Text("Player Animation Frame Indices: (%d, %d)", player_.currentFrame_.x, player_.currentFrame_.y);
-			ImGui::Text("Player UV: Min(%.2f, %.2f) Max(%.2f, %.2f)", player_.uvMin.x, player_.uvMin.y, player_.uvMax.x, player_.uvMax.y);
-			ImGui::Text("Player Facing Direction: %s", facingDirectionToString(player_.getFacingDirection()).c_str());
-			ImGui::Text("Player Grounded: %s", player_.isGrounded() ? "Yes" : "No");
+			ImGui::Text("Player Position: %.2f, %.2f", stats.playerPosition.x, stats.playerPosition.y);
+			ImGui::Text("Player Velocity: %.2f, %.2f", stats.playerVelocity.x, stats.playerVelocity.y);
+			ImGui::Text("Player Move State: %s", moveStateToString(stats.moveState).c_str());
+			ImGui::Text("Player UV: Min(%.2f, %.2f) Max(%.2f, %.2f)", frame.playerUVMin.x, frame.playerUVMin.y, frame.playerUVMax.x, frame.playerUVMax.y);
+			ImGui::Text("Player Facing Direction: %s", facingDirectionToString(stats.facing).c_str());
+			ImGui::Text("Player Grounded: %s", stats.grounded ? "Yes" : "No");
+			if (frame.streamed)
+				ImGui::Text("Streamed Chunks: %d resident (%ld loads, %ld evictions)", stats.residentChunks, stats.chunkLoads, stats.chunkEvictions);
+			else
+				ImGui::Text("Collision Shapes: %d tiles -> %d rects", tilemap_.getSolidTileCount(), static_cast<int>(tilemap_.getCollisionRects().size()));
+			ImGui::Text("Player C-Space: %s (rebuilds: %d)", stats.playerSpaceFree ? "free" : "near solid", stats.spaceRebuilds);
+			ImGui::Text("Objects: %d active / %d sleeping", stats.activeObjects, stats.sleepingObjects);
+			if (stats.hasDeathWall) {
+				ImGui::Text("Death Wall Position: %.2f, %.2f", stats.deathWallPosition.x, stats.deathWallPosition.y);
+			}
+			ImGui::Text("Platforms: %d (%d ridden)", stats.platforms, stats.riddenPlatforms);
+			ImGui::Text("Triggers: %d (%d tested, %d inside)", stats.triggers, stats.testedTriggers, stats.insideTriggers);
+			ImGui::Text("Player Sub-steps: %d (capped steps: %ld)", stats.playerSubsteps, stats.playerCappedSteps);
+			ImGui::Text("Sim Step: %lu (%lu published)", static_cast<unsigned long>(frame.step), frames_.getPublished());
 			ImGui::Text("FPS: %.1f", ImGui::GetIO().Framerate);
 		}
 		ImGui::End();
 		ImGui::PopFont();
 	}
-	if(levelCountdown_) renderCountdown(countdownTimer_);
+	if (frame.countdown > 0.0f) renderCountdown(frame.countdown);
 
 	ImGui::Render();
 	ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 	finishDraw(window_, renderer_, shader_);
 
-	auto frameEnd = std::chrono::high_resolution_clock::now();
-	std::chrono::duration<double> elapsed = frameEnd - frameStart;
+	// Death, goal and pause end the simulation thread; the state change happens here
+	if (stateRequested_.load(std::memory_order_acquire)) {
+		setState(requestedState_);
+	}
+}
+
+void GameManager::startSimulation() {
+	stateRequested_.store(false);
+	// First snapshot comes from this thread, so the renderer never sees an empty one
+	publishFrame();
+	sim_.start(SIM_STEP, [this](float deltaTime) { return simulateStep(deltaTime); });
+}
+
+void GameManager::requestState(GameState state) {
+	if (stateRequested_.load(std::memory_order_relaxed))
+		return; // First request in a step wins
+	requestedState_ = state;
+	stateRequested_.store(true, std::memory_order_release);
+}
+
+bool GameManager::simulateStep(float deltaTime) {
+	InputFrame input = Input::takeFrame();
+	if (levelCountdown_) {
+		if (countdownTimer_ <= 0.0f) {
+			countdownTimer_ = 3.0f;
+		}
+		countdownTimer_ -= deltaTime;
+		if (countdownTimer_ <= 0.0f) {
+			levelCountdown_ = false;
+		}
+	} else if (playerInput(player_, input) == InputResult::PAUSE) {
+		requestState(GameState::PAUSE);
+		DEBUG_ONLY(std::cout << "Pausing game." << std::endl;);
+	} else {
+		physics_.deltaTime = deltaTime; // Update physics system delta time - kinda weird, might consolidate
+
+		if (world_)
+			updatePStatePlayer(player_, physics_, *world_, objects_, activity_, behaviors_, platforms_, triggers_, deltaTime);
+		else
+			updatePStatePlayer(player_, physics_, tilemap_, objects_, activity_, behaviors_, platforms_, triggers_, deltaTime);
+		// Attached objects follow whatever they're attached to; free when nothing is
+		scene_.pullDrivers(objects_, registry_);
+		scene_.update();
+		scene_.pushFollowers(objects_, registry_);
+		// Deaths, goals and checkpoints published during the step; the handlers may end PLAY
+		events_.dispatch();
+
+		if (!stateRequested_.load(std::memory_order_relaxed)) {
+			static float frameDuration;
+			player_.updateMoveState();
+			if(player_.getSpeed().x <= 5.0f){
+				frameDuration = 1 / 8.0f; // 8 FPS
+			} else if(player_.getSpeed().x <= 10.0f){
+				frameDuration = 1 / 12.0f; // 12 FPS
+			} else if(player_.getSpeed().x <= 16.0f){
+				frameDuration = 1 / 16.0f; // 16 FPS
+			} else if(player_.getSpeed().x <= 28.0f){
+				frameDuration = 1 / 20.0f; // 20 FPS
+			} else if(player_.getSpeed().x > 32.0f){
+				frameDuration = 1 / 30.0f; // 24 FPS
+			}
+			player_.updateAtlasAnimation(deltaTime, frameDuration);
+		}
+	}
+	publishFrame();
+	return !stateRequested_.load(std::memory_order_relaxed);
+}
+
+void GameManager::publishFrame() {
+	FrameSnapshot& frame = frames_.getWriteSlot();
+	if (world_)
+		captureFrame(frame, player_, objects_, platforms_.getObjects(), *world_, viewAspect_.load());
+	else
+		captureFrame(frame, player_, objects_, platforms_.getObjects(), tilemap_, viewAspect_.load());
+	frame.step = ++simSteps_;
+	frame.countdown = levelCountdown_ ? countdownTimer_ : 0.0f;
+
+	FrameStats& stats = frame.stats;
+	stats.playerPosition = player_.getPosition();
+	stats.playerVelocity = player_.getVelocity();
+	stats.moveState = player_.moveState_;
+	stats.facing = player_.getFacingDirection();
+	stats.grounded = player_.isGrounded();
+	stats.playerSpaceFree = physics_.getPlayerSpace().isFree(player_.getPosition());
+	stats.spaceRebuilds = physics_.getPlayerSpace().getRebuildCount();
+	stats.activeObjects = activity_.getActiveCount();
+	stats.sleepingObjects = activity_.getSleepingCount();
+	const GameObject* wall = registry_.resolve(objects_, deathWall_);
+	stats.hasDeathWall = wall != nullptr;
+	stats.deathWallPosition = wall ? wall->getPosition() : glm::vec2(0.0f);
+	stats.platforms = platforms_.getCount();
+	stats.riddenPlatforms = platforms_.getRiddenCount();
+	stats.triggers = triggers_.getCount();
+	stats.testedTriggers = triggers_.getTestedCount();
+	stats.insideTriggers = triggers_.getInsideCount();
+	stats.playerSubsteps = physics_.getStats().playerSubsteps;
+	stats.playerCappedSteps = physics_.getStats().playerCappedSteps;
+	stats.residentChunks = world_ ? world_->getResidentCount() : 0;
+	stats.chunkLoads = world_ ? world_->getLoadCount() : 0;
+	stats.chunkEvictions = world_ ? world_->getEvictCount() : 0;
+	frames_.publish();
 }
 
 void GameManager::handlePauseState() {
 	// Poll events but don't update game systems
 	window_.pollEvents();
 
-	// Still render the current frame (game world frozen)
-	drawTilemapAndPlayer(window_, renderer_, shader_, tilemap_, player_);
-	drawObjects(window_, renderer_, shader_, objects_);
+	// Still render the last simulated frame (game world frozen)
+	drawFrame(window_, renderer_, shader_, levelManager_, tilemap_, tileMesh_, frames_.acquire());
 
 	ImGui_ImplOpenGL3_NewFrame();
 	ImGui_ImplGlfw_NewFrame();
@@ -455,24 +713,8 @@ void GameManager::handlePauseState() {
 
 		if (ImGui::Button("Restart Level", buttonSize)) {
 			// tilemap_ remains the same as when level was loaded
-
-			player_.setPosition(tilemap_.tileIndexToWorldPos(tilemap_.getInitPlayerPos().x, tilemap_.getInitPlayerPos().y) + glm::vec2(tilemap_.getTileSize() / 2.0f, tilemap_.getTileSize() / 2.0f));
-			player_.setVelocity(glm::vec2(0.0f, 0.0f));
-			player_.setAcceleration(glm::vec2(0.0f, 0.0f));
-			player_.sensorUpdate();
-			player_.setShouldDie(false);
-			player_.setGoalCount(0);
-			player_.setInGoal(false);
-			
+			resetLevelState(false);
 			levelCountdown_ = true;
-			
-			// Reset death wall if it exists
-			if (!objects_.empty()) {
-				auto* deathWallBehavior = dynamic_cast<DeathWallBehavior*>(objects_[0].getBehavior());
-				if (deathWallBehavior) {
-					deathWallBehavior->reset(objects_[0]);
-				}
-			}
 			setState(GameState::PLAY);
 			DEBUG_ONLY(std::cout<<"Restarting level"<<std::endl;);
 		}
@@ -565,21 +807,8 @@ void GameManager::handleDeadState() {
 
 	// Check for input to reset level or exit
 	if (Input::isKeyPressed(GLFW_KEY_ENTER)) {
-		// Reset level and return to PLAY state
-		player_.setPosition(tilemap_.tileIndexToWorldPos(tilemap_.getInitPlayerPos().x, tilemap_.getInitPlayerPos().y) + glm::vec2(tilemap_.getTileSize() / 2.0f, tilemap_.getTileSize() / 2.0f));
-		player_.setVelocity(glm::vec2(0.0f, 0.0f));
-		player_.setAcceleration(glm::vec2(0.0f, 0.0f));
-		player_.sensorUpdate();
-		player_.setShouldDie(false);
-
-		// Reset goal-related states
-		player_.setGoalCount(0);
-		player_.setInGoal(false);
-
-		// Reset death wall
-		auto* deathWallBehavior = dynamic_cast<DeathWallBehavior*>(objects_[0].getBehavior());
-		deathWallBehavior->reset(objects_[0]);
-
+		// Reset level and return to PLAY state, respawning at the last checkpoint reached
+		resetLevelState(true);
 		setState(GameState::PLAY);
 		DEBUG_ONLY(std::cout << "Level reset, returning to PLAY state." << std::endl;);
 	}
@@ -596,9 +825,19 @@ void GameManager::handleWinState(){
 	window_.pollEvents();
 	Input::update();
 
-	// Still render the current frame (game world frozen)
-	drawTilemapAndPlayer(window_, renderer_, shader_, tilemap_, player_);
-	drawObjects(window_, renderer_, shader_, objects_);
+	// Still render the last simulated frame (game world frozen)
+	drawFrame(window_, renderer_, shader_, levelManager_, tilemap_, tileMesh_, frames_.acquire());
+
+	// The next level in the list loads while the player looks at this screen, so picking
+	// it is close to instant. The startup level isn't in the list; the first one follows it.
+	const int levelCount = static_cast<int>(levelManager_.getAvailableLevels().size());
+	int nextLevel = currentLevelIndex_ + 1;
+	while (nextLevel < levelCount && levelPath(nextLevel).empty())
+		++nextLevel; // Skip levels deleted since startup
+	bool hasNextLevel = nextLevel < levelCount;
+	if (hasNextLevel) {
+		levelCache_.prefetch(levelPath(nextLevel));
+	}
 
 	ImGui_ImplOpenGL3_NewFrame();
 	ImGui_ImplGlfw_NewFrame();
@@ -634,7 +873,7 @@ void GameManager::handleWinState(){
 		// ImGui::PopFont();
 
 		// Add scalable spacing - more space between title and instructions
-		spacingAmount = windowHeight * 0.3f; // 30% of window height
+		spacingAmount = windowHeight * 0.2f; // 20% of window height, leaves room for Next Level
 		ImGui::Dummy(ImVec2(0.0f, spacingAmount));
 
 		// Center the button
@@ -642,25 +881,19 @@ void GameManager::handleWinState(){
 		float buttonWidth = buttonSize.x;
 		ImGui::SetCursorPosX((windowWidth - buttonWidth) * 0.5f);
 
+		if (hasNextLevel) {
+			if (ImGui::Button("Next Level", buttonSize)) {
+				beginLevelLoad(nextLevel);
+				DEBUG_ONLY(std::cout << "Loading next level." << std::endl;);
+			}
+			ImGui::Dummy(ImVec2(0.0f, 20.0f));
+			ImGui::SetCursorPosX((windowWidth - buttonWidth) * 0.5f);
+		}
+
 		if (ImGui::Button("Restart Level", buttonSize)) {
 			// tilemap_ remains the same as when level was loaded
-
-			player_.setPosition(tilemap_.tileIndexToWorldPos(tilemap_.getInitPlayerPos().x, tilemap_.getInitPlayerPos().y) + glm::vec2(tilemap_.getTileSize() / 2.0f, tilemap_.getTileSize() / 2.0f));
-			player_.setVelocity(glm::vec2(0.0f, 0.0f));
-			player_.setAcceleration(glm::vec2(0.0f, 0.0f));
-			player_.sensorUpdate();
-			player_.setShouldDie(false);
-			player_.setGoalCount(0);
-			player_.setInGoal(false);
-			
+			resetLevelState(false);
 			levelCountdown_ = true;
-			// Reset death wall if it exists
-			if (!objects_.empty()) {
-				auto* deathWallBehavior = dynamic_cast<DeathWallBehavior*>(objects_[0].getBehavior());
-				if (deathWallBehavior) {
-					deathWallBehavior->reset(objects_[0]);
-				}
-			}
 			setState(GameState::PLAY);
 			DEBUG_ONLY(std::cout<<"Restarting level"<<std::endl;);
 		}
@@ -1069,4 +1302,8 @@ void GameManager::handleDemo3D(){
 	finishDraw3D(window_, *renderer3D_, *shader3D_);
 
 }
-void GameManager::handleExitState() { window_.setShouldClose(true); }
\ No newline at end of file
+void GameManager::handleExitState() {
+	levelCache_.cancel();
+	tileMesh_.release(renderer_); // While the GL context is still around
+	window_.setShouldClose(true);
+}
\ No newline at end of file
@@ -9,8 +9,7 @@ GameObject::GameObject() {
 	scale_ = glm::vec2(1.0f, 1.0f);
 	rotation_ = 0.0f;
 	color_ = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f); // Default white color
-	name_ = "Unnamed";
-	computeAABB(); // Compute AABB based on default position and scale
+	setName("Unnamed");
 }
 
 GameObject::GameObject(const glm::vec2& position, const glm::vec4& color) {
@@ -19,9 +18,8 @@ GameObject::GameObject(const glm::vec2& position, const glm::vec4& color) {
 	scale_ = glm::vec2(1.0f, 1.0f); // Default scale
 	rotation_ = 0.0f;				// Default rotation
 	color_ = color;
-	name_ = "Unnamed";
-	computeAABB(); // Compute AABB based on position and scale
-				   // Note: AABB will be computed with default scale (1,1) and rotation
+	setName("Unnamed");
+	// AABB and transform start dirty and are computed on first use
 }
 
 GameObject::GameObject(const glm::vec2& position, const glm::vec2& scale, float rotation, const glm::vec4& color) {
@@ -30,20 +28,16 @@ GameObject::GameObject(const glm::vec2& position, const glm::vec2& scale, float
 	scale_ = scale;
 	rotation_ = rotation;
 	color_ = color;
-	name_ = "Unnamed";
-	computeAABB(); // Compute AABB based on position, scale,
+	setName("Unnamed");
 }
 
-glm::mat4 GameObject::getModelMatrix() const {
-	// Compute the model matrix based on position, scale, and rotation
-	glm::mat4 model = glm::mat4(1.0f);									// Start with identity matrix
-	model = glm::translate(model, glm::vec3(position_, 0.0f));			// Translate to position
-	model = glm::rotate(model, rotation_, glm::vec3(0.0f, 0.0f, 1.0f)); // Rotate around Z-axis
-	model = glm::scale(model, glm::vec3(scale_, 1.0f));					// Scale in X and Y directions
-	return model;
+void GameObject::computeTransform() const {
+	// Scale, then rotate around Z, then translate to position
+	transform_ = Transform2D::fromTRS(position_, rotation_, scale_);
+	dirty_ &= ~DIRTY_TRANSFORM;
 }
 
-const void GameObject::computeAABB() {
+void GameObject::computeAABB() const {
 	// Compute the Axis-Aligned Bounding Box (AABB) based on position, scale, and rotation
 	float halfWidth = scale_.x / 2.0f;
 	float halfHeight = scale_.y / 2.0f;
@@ -52,6 +46,7 @@ const void GameObject::computeAABB() {
 	aabb_.right = position_.x + halfWidth;
 	aabb_.top = position_.y + halfHeight;
 	aabb_.bottom = position_.y - halfHeight;
+	dirty_ &= ~DIRTY_AABB;
 }
 
 bool checkCollision(const AABB& a, const AABB& b) {
@@ -87,9 +82,9 @@ void GameObject::updateBehavior(float deltaTime) {
 	}
 }
 
-void GameObject::handlePlayerCollision(PlayerObject& player) {
+void GameObject::handlePlayerCollision(PlayerObject& player, GameEvents& events) {
 	if (behavior_) {
-		behavior_->onPlayerCollision(*this, player);
+		behavior_->onPlayerCollision(*this, player, events);
 	}
 }
 
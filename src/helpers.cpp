@@ -36,9 +36,9 @@ PlayerObject setupPlayerObject(Tilemap& tilemap, float horizSensorScale, float v
 	return player;
 }
 
-InputResult playerInput(GameObject& player) {
+InputResult playerInput(GameObject& player, const InputFrame& input) {
 	
-	if (Input::isKeyPressed(GLFW_KEY_LEFT) || Input::isKeyPressed(GLFW_KEY_A)) {
+	if (input.isKeyPressed(GLFW_KEY_LEFT) || input.isKeyPressed(GLFW_KEY_A)) {
 		// If not grounded, tie direction to INPUT (typical of 2D Sonic)
 		if (!player.isGrounded()) player.setFacingDirection(FacingDirection::LEFT);
 		if (player.getVelocity().x > 0) {
@@ -51,7 +51,7 @@ InputResult playerInput(GameObject& player) {
 		} else {
 			player.setAcceleration(glm::vec2(-movementAccel, player.getAcceleration().y));
 		}
-	} else if (Input::isKeyPressed(GLFW_KEY_RIGHT) || Input::isKeyPressed(GLFW_KEY_D)) {
+	} else if (input.isKeyPressed(GLFW_KEY_RIGHT) || input.isKeyPressed(GLFW_KEY_D)) {
 		if (!player.isGrounded()) player.setFacingDirection(FacingDirection::RIGHT);
 		if (player.getVelocity().x < 0) {
 			// Player is currently moving left, increase acceleration in opposite direction
@@ -77,19 +77,19 @@ InputResult playerInput(GameObject& player) {
 			player.setAcceleration(glm::vec2(0.0f, player.getAcceleration().y));
 		}
 	}
-	if (Input::isKeyJustPressed(GLFW_KEY_UP) || Input::isKeyPressed(GLFW_KEY_W)) {
+	if (input.isKeyJustPressed(GLFW_KEY_UP) || input.isKeyPressed(GLFW_KEY_W)) {
 		if (player.isGrounded()) {
 			player.addVelocity(glm::vec2(0.0f, 7.0f)); // Apply upward velocity
 			player.setGrounded(false);				   // Set player to not grounded`
 		}
 	}
-	if (Input::isKeyPressed(GLFW_KEY_DOWN) || Input::isKeyPressed(GLFW_KEY_S)) {
+	if (input.isKeyPressed(GLFW_KEY_DOWN) || input.isKeyPressed(GLFW_KEY_S)) {
 		// Increase freefall speed
 		if (!player.isGrounded()) {
 			player.setVelocity(glm::vec2(player.getVelocity().x, -10.0f)); // Apply downward velocity
 		}
 	}
-	if (Input::isKeyJustPressed(GLFW_KEY_ESCAPE) || Input::isKeyJustPressed(GLFW_KEY_P)) {
+	if (input.isKeyJustPressed(GLFW_KEY_ESCAPE) || input.isKeyJustPressed(GLFW_KEY_P)) {
 		return InputResult::PAUSE;
 	}
 
@@ -129,41 +129,36 @@ void drawStep(Window& window, Renderer2D& renderer, Shader& shader, const std::v
 	renderer.beginScene(shader, view, projection); // Begin the scene
 
 	for (const auto& object : objects) {
-		glm::mat4 model = object.getModelMatrix();
-		renderer.drawQuad(shader, model, object.getColor());
+		renderer.drawQuad(shader, object.getTransform2D(), object.getColor());
 	}
 
 	// Swap buffers
 	window.swap();
 }
 
-void drawBackground(Window& window, Renderer2D& renderer, Shader& shader, const LevelManager& levelManager, const PlayerObject& player) {
-	
+void drawBackground(Window& window, Renderer2D& renderer, Shader& shader, const LevelManager& levelManager, const glm::vec2& cameraCenter) {
 	// Get current framebuffer size
 	int fbWidth, fbHeight;
 	window.getFramebufferSize(fbWidth, fbHeight);
 	float aspect = static_cast<float>(fbWidth) / static_cast<float>(fbHeight);
 
 	// Define a fixed vertical size for the in-game "world"
-	float zoomFactor = 0.8f; // temp
-	float worldHeight = 5.5f / zoomFactor;
+	float worldHeight = CAMERA_WORLD_HEIGHT;
 	float worldWidth = worldHeight * aspect;
 
 	// Projection matrix (orthographic): dynamic, based on aspect
 	glm::mat4 projection = glm::ortho(0.0f, worldWidth, 0.0f, worldHeight, -1.0f, 1.0f);
 
 	// View matrix: camera follows player
-	glm::vec2 cameraCenter = player.getPosition();
-
 	// Position the background so that after applying 'view' it's centered on screen.
 	// Given the view translates by (-camera + centerOffset), placing the model at
 	// (camera + inverseOffset) keeps it visually centered.
 	glm::mat4 bgModel = glm::translate(glm::mat4(1.0f),
-									   glm::vec3(cameraCenter.x + 2.0f,
-											  cameraCenter.y + 0.7f,
+									   glm::vec3(cameraCenter.x + CAMERA_LEAD.x,
+											  cameraCenter.y + CAMERA_LEAD.y,
 											  0.0f));
-	glm::mat4 view = glm::translate(glm::mat4(1.0f), glm::vec3(-cameraCenter.x + worldWidth / 2.0f - 2.0f,
-												  -cameraCenter.y + worldHeight / 2.0f - 0.7f,
+	glm::mat4 view = glm::translate(glm::mat4(1.0f), glm::vec3(-cameraCenter.x + worldWidth / 2.0f - CAMERA_LEAD.x,
+												  -cameraCenter.y + worldHeight / 2.0f - CAMERA_LEAD.y,
 												  0.0f));
 	bgModel = glm::scale(bgModel, glm::vec3(worldWidth, worldHeight, 1.0f));
 
@@ -188,11 +183,27 @@ void drawBackground(Window& window, Renderer2D& renderer, Shader& shader, const
 
 }
 
+void drawCollisionRects(Renderer2D& renderer, Shader& shader, const Tilemap& tilemap) {
+	const float T = tilemap.getTileSize();
+	const glm::vec4 rectColor(1.0f, 0.85f, 0.0f, 1.0f);
+	for (const auto& rect : tilemap.getCollisionRects()) {
+		glm::vec2 bl(rect.x0 * T, rect.y0 * T);
+		glm::vec2 tr((rect.x1 + 1) * T, (rect.y1 + 1) * T);
+		renderer.drawLine(shader, bl, glm::vec2(tr.x, bl.y), rectColor);
+		renderer.drawLine(shader, glm::vec2(tr.x, bl.y), tr, rectColor);
+		renderer.drawLine(shader, tr, glm::vec2(bl.x, tr.y), rectColor);
+		renderer.drawLine(shader, glm::vec2(bl.x, tr.y), bl, rectColor);
+	}
+}
+
 void drawTilemapAndPlayer(Window& window, Renderer2D& renderer, Shader& shader, const Tilemap& tilemap, const PlayerObject& player) {
 
 	tilemap.renderTileMap(shader, renderer); // Render the tilemap
 
-	glm::mat4 model = player.getModelMatrix();
+	if (g_debugEnabled)
+		drawCollisionRects(renderer, shader, tilemap);
+
+	const Transform2D& model = player.getTransform2D();
 	if (player.getTexture() != nullptr) {
 		// renderer.drawTexturedQuad(shader, model, player.getColor(), player.getTexture());
 		
@@ -240,8 +251,7 @@ void drawStepPlayer(Window& window, Renderer2D& renderer, Shader& shader, const
 
 	renderer.beginScene(shader, view, projection); // Begin the scene
 
-	glm::mat4 model = player.getModelMatrix();
-	renderer.drawQuad(shader, model, player.getColor());
+	renderer.drawQuad(shader, player.getTransform2D(), player.getColor());
 
 	// Swap buffers
 	// window.swap();
@@ -249,8 +259,7 @@ void drawStepPlayer(Window& window, Renderer2D& renderer, Shader& shader, const
 
 void drawObjects(Window& window, Renderer2D& renderer, Shader& shader, const std::vector<GameObject>& objects) {
 	for (const auto& object : objects) {
-		glm::mat4 model = object.getModelMatrix();   
-		renderer.drawQuad(shader, model, object.getColor());
+		renderer.drawQuad(shader, object.getTransform2D(), object.getColor()); // Cached until the object moves
 	}
 }
 
@@ -301,30 +310,135 @@ void renderCountdown(float countdownTime) {
     drawList->AddText(font, fontSize, textPos, textColor, countdownText.c_str());
 }
 
-void updateDeathWall(GameObject& deathWall, float deltaTime) {
-	// Call the behavior's update method
-	deathWall.updateBehavior(deltaTime);
+AABB cameraView(const glm::vec2& cameraCenter, float aspect) {
+	glm::vec2 centre = cameraCenter + CAMERA_LEAD;
+	glm::vec2 half = glm::vec2(CAMERA_WORLD_HEIGHT * aspect, CAMERA_WORLD_HEIGHT) / 2.0f;
+	return {centre.x - half.x, centre.x + half.x, centre.y + half.y, centre.y - half.y};
 }
 
-void updatePStatePlayer(PlayerObject& player, Physics& physics, Tilemap& tilemap, std::vector<GameObject>& objects, float deltaTime) {
-	physics.playerMovementStep(player, deltaTime);
-	physics.checkPlayerWorldCollisions(player, tilemap);
+// One tile of margin so tiles entering the view during the next render aren't missing
+template <typename Grid>
+static TileRange viewTiles(const Grid& grid, const glm::vec2& camera, float aspect) {
+	AABB view = cameraView(camera, aspect);
+	glm::ivec2 lo = grid.worldToTileIndex(glm::vec2(view.left, view.bottom)) - glm::ivec2(1);
+	glm::ivec2 hi = grid.worldToTileIndex(glm::vec2(view.right, view.top)) + glm::ivec2(1);
+	return {std::max(lo.x, 0), std::max(lo.y, 0), std::min(hi.x, grid.getWidth() - 1), std::min(hi.y, grid.getHeight() - 1)};
+}
 
-	GameObject* deathWall = nullptr;
-	if (!objects.empty()) {
-		for (auto& obj : objects) {
-			if (obj.getName() == "DeathWall") {
-				deathWall = &obj;
-				break;
-			}
+// Everything but the camera and tiles
+static void captureActors(FrameSnapshot& frame, const PlayerObject& player, const std::vector<GameObject>& objects,
+						  const std::vector<GameObject>& platforms) {
+	frame.player = {player.getTransform2D(), player.getColor(), player.getTexture()};
+	frame.playerUVMin = player.uvMin;
+	frame.playerUVMax = player.uvMax;
+	frame.playerUVOffset = 0.0f;
+	const AtlasAnimation* anim = player.getCurrentAtlasAnim();
+	if (player.isGrounded() && anim != nullptr && !anim->frames.empty()) {
+		frame.playerUVOffset = -1.0f / anim->frames[anim->currentFrameIdx].h; // Slight downward offset when grounded
+	}
+
+	// Cleared, not reallocated: the slot keeps its capacity from three frames ago
+	frame.sprites.clear();
+	for (const auto& object : objects)
+		frame.sprites.push_back({object.getTransform2D(), object.getColor(), nullptr});
+	for (const auto& platform : platforms)
+		frame.sprites.push_back({platform.getTransform2D(), platform.getColor(), nullptr});
+
+	frame.debugLines.clear();
+	if (g_debugEnabled) {
+		glm::vec2 origin = player.getPosition();
+		for (const Sensor* sensor : {&player.getBottomSensor(), &player.getTopSensor(), &player.getLeftSensor(), &player.getRightSensor()})
+			frame.debugLines.push_back({origin, sensor->position, sensor->color});
+	}
+}
+
+void captureFrame(FrameSnapshot& frame, const PlayerObject& player, const std::vector<GameObject>& objects,
+				  const std::vector<GameObject>& platforms, const Tilemap& tilemap, float aspect) {
+	frame.camera = player.getPosition();
+	frame.visibleTiles = viewTiles(tilemap, frame.camera, aspect);
+	frame.streamed = false;
+	frame.tiles.clear();
+	captureActors(frame, player, objects, platforms);
+}
+
+void captureFrame(FrameSnapshot& frame, const PlayerObject& player, const std::vector<GameObject>& objects,
+				  const std::vector<GameObject>& platforms, TileWorld& world, float aspect) {
+	frame.camera = player.getPosition();
+	const TileRange& tiles = frame.visibleTiles = viewTiles(world, frame.camera, aspect);
+	world.update(tiles.x0, tiles.y0, tiles.x1, tiles.y1);
+	frame.streamed = true;
+	frame.tiles.clear();
+	world.collectTiles(tiles.x0, tiles.y0, tiles.x1, tiles.y1, frame.tiles);
+	captureActors(frame, player, objects, platforms);
+}
+
+void drawFrame(Window& window, Renderer2D& renderer, Shader& shader, const LevelManager& levelManager, const Tilemap& tilemap,
+			   const TileMesh& tileMesh, const FrameSnapshot& frame) {
+	drawBackground(window, renderer, shader, levelManager, frame.camera);
+	const TileRange& tiles = frame.visibleTiles;
+	if (frame.streamed) {
+		// Same drawing as Tilemap::renderTileMap
+		for (const SpriteInstance& tile : frame.tiles) {
+			if (tile.texture == nullptr)
+				renderer.addQuadtoBatch(shader, tile.transform, tile.color);
+			else
+				renderer.drawTexturedQuad(shader, tile.transform, tile.color, tile.texture);
 		}
+		renderer.flushBatch(shader);
+	} else if (tileMesh.matches(tilemap)) {
+		tileMesh.draw(shader, renderer, tilemap, tiles.x0, tiles.y0, tiles.x1, tiles.y1);
+	} else {
+		tilemap.renderTileMap(shader, renderer, tiles.x0, tiles.y0, tiles.x1, tiles.y1);
 	}
 
-	if (deathWall) {
-		physics.checkPlayerDeathWallCollision(player, *deathWall);
+	if (g_debugEnabled && !frame.streamed)
+		drawCollisionRects(renderer, shader, tilemap);
+
+	if (frame.player.texture != nullptr) {
+		renderer.setPlayerUVRect(frame.playerUVMin, frame.playerUVMax, frame.playerUVOffset);
+		renderer.drawPlayer(shader, frame.player.transform, frame.player.color, frame.player.texture);
+	} else {
+		renderer.drawQuad(shader, frame.player.transform, frame.player.color);
 	}
+	for (const DebugLine& line : frame.debugLines)
+		renderer.drawLine(shader, line.start, line.end, line.color);
+
+	for (const SpriteInstance& sprite : frame.sprites)
+		renderer.drawQuad(shader, sprite.transform, sprite.color);
+}
+
+void updateDeathWall(GameObject& deathWall, float deltaTime) {
+	// Call the behavior's update method
+	deathWall.updateBehavior(deltaTime);
 }
 
+void updateActiveBehaviors(std::vector<GameObject>& objects, BehaviorPools& behaviors, const ActivitySet& activity,
+						   float deltaTime) {
+	behaviors.update(objects, activity, deltaTime);
+}
+
+template <typename Grid>
+void updatePStatePlayer(PlayerObject& player, Physics& physics, const Grid& tilemap, std::vector<GameObject>& objects,
+						ActivitySet& activity, BehaviorPools& behaviors, PlatformSystem& platforms, TriggerSystem& triggers,
+						float deltaTime) {
+	platforms.step(deltaTime);
+	physics.stepPlayer(player, tilemap, deltaTime, &platforms);
+	physics.checkPlayerTriggers(player, triggers);
+
+	// Objects within WAKE_RADIUS tiles of the player stay awake; everything else may sleep
+	const float reach = WAKE_RADIUS * tilemap.getTileSize();
+	const AABB& box = player.getAABB();
+	AABB wakeRegion = {box.left - reach, box.right + reach, box.top + reach, box.bottom - reach};
+	activity.update(objects, deltaTime, wakeRegion);
+
+	physics.checkPlayerEntityCollisions(player, objects, activity, behaviors);
+}
+
+template void updatePStatePlayer(PlayerObject&, Physics&, const Tilemap&, std::vector<GameObject>&, ActivitySet&, BehaviorPools&,
+								 PlatformSystem&, TriggerSystem&, float);
+template void updatePStatePlayer(PlayerObject&, Physics&, const TileWorld&, std::vector<GameObject>&, ActivitySet&, BehaviorPools&,
+								 PlatformSystem&, TriggerSystem&, float);
+
 std::string currentShapeToString(CurrentShape shape) {
 	switch (shape) {
 		case CurrentShape::NONE:
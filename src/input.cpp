@@ -5,6 +5,8 @@ GLFWwindow* Input::s_window = nullptr;
 
 std::unordered_map<int, int> Input::s_currentKeys_;
 std::unordered_map<int, int> Input::s_previousKeys_;
+std::mutex Input::s_frameMutex_;
+InputFrame Input::s_pendingFrame_;
 
 void Input::initialize(GLFWwindow* window) {
 	s_window = window;
@@ -21,6 +23,49 @@ void Input::update() {
 		// 0 -> GLFW_RELEASED, 1-> GLFW_PRESS
 		s_currentKeys_[key] = state;
 	}
+
+	// Same transitions, accumulated for whichever thread takes the next frame
+	std::lock_guard<std::mutex> lock(s_frameMutex_);
+	for (size_t slot = 0; slot < s_trackedKeys_.size(); ++slot) {
+		bool down = s_currentKeys_[s_trackedKeys_[slot]] == GLFW_PRESS;
+		bool wasDown = s_pendingFrame_.held[slot];
+		if (down && !wasDown)
+			s_pendingFrame_.pressed[slot] = true;
+		if (!down && wasDown)
+			s_pendingFrame_.released[slot] = true;
+		s_pendingFrame_.held[slot] = down;
+	}
+}
+
+InputFrame Input::takeFrame() {
+	std::lock_guard<std::mutex> lock(s_frameMutex_);
+	InputFrame frame = s_pendingFrame_;
+	s_pendingFrame_.pressed.reset();
+	s_pendingFrame_.released.reset();
+	return frame;
+}
+
+int Input::keySlot(int key) {
+	for (size_t slot = 0; slot < s_trackedKeys_.size(); ++slot) {
+		if (s_trackedKeys_[slot] == key)
+			return static_cast<int>(slot);
+	}
+	return -1;
+}
+
+bool InputFrame::isKeyPressed(int key) const {
+	int slot = Input::keySlot(key);
+	return slot >= 0 && held[slot];
+}
+
+bool InputFrame::isKeyJustPressed(int key) const {
+	int slot = Input::keySlot(key);
+	return slot >= 0 && pressed[slot];
+}
+
+bool InputFrame::isKeyJustReleased(int key) const {
+	int slot = Input::keySlot(key);
+	return slot >= 0 && released[slot];
 }
 
 void Input::clear() {
@@ -28,6 +73,9 @@ void Input::clear() {
 	// and ensures no "just pressed" states carry over
 	update();
 	update();
+	std::lock_guard<std::mutex> lock(s_frameMutex_);
+	s_pendingFrame_.pressed.reset();
+	s_pendingFrame_.released.reset();
 }
 
 bool Input::isKeyPressed(int key) {
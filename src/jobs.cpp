@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <chrono>
+#include "jobs.hpp"
+
+namespace {
+// Which system and worker the current thread belongs to; threads outside any system are -1
+thread_local const JobSystem* t_system = nullptr;
+thread_local int t_worker = -1;
+
+uint64_t nowNs() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+} // namespace
+
+JobSystem::JobSystem(int threads) : queues_((threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency())) + 1) {
+	int total = static_cast<int>(queues_.size()) - 1;
+	owner_ = std::this_thread::get_id();
+	t_system = this;
+	t_worker = 0;
+	for (int i = 1; i < total; ++i) {
+		workers_.emplace_back([this, i] { workerLoop(i); });
+	}
+}
+
+JobSystem::~JobSystem() {
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex_);
+		running_.store(false);
+	}
+	wake_.notify_all();
+	for (auto& worker : workers_)
+		worker.join();
+	if (t_system == this)
+		t_system = nullptr;
+}
+
+int JobSystem::currentWorker() const {
+	if (t_system == this)
+		return t_worker;
+	return std::this_thread::get_id() == owner_ ? 0 : -1;
+}
+
+void JobSystem::run(const Job& job, JobCounter* counter) {
+	Job queued = job;
+	queued.counter = counter;
+	if (counter)
+		counter->pending_.fetch_add(1, std::memory_order_relaxed);
+	if (isSerial()) {
+		execute(queued, currentWorker());
+		return;
+	}
+	submit(&queued, 1);
+}
+
+void JobSystem::runAfter(JobCounter& dependency, const Job& job, JobCounter* counter) {
+	Job queued = job;
+	queued.counter = counter;
+	if (counter)
+		counter->pending_.fetch_add(1, std::memory_order_relaxed);
+	{
+		std::lock_guard<std::mutex> lock(dependency.mutex_);
+		if (!dependency.isDone()) {
+			dependency.continuations_.push_back(queued);
+			return;
+		}
+	}
+	if (isSerial()) {
+		execute(queued, currentWorker());
+		return;
+	}
+	submit(&queued, 1);
+}
+
+void JobSystem::wait(JobCounter& counter) {
+	int worker = currentWorker();
+	while (!counter.isDone()) {
+		if (!tryRunOne(worker))
+			std::this_thread::yield(); // Remaining jobs are running elsewhere
+	}
+	// The last finisher zeroes the count under the lock; taking it here means that
+	// finisher is done with the counter before the caller can destroy it
+	std::lock_guard<std::mutex> lock(counter.mutex_);
+}
+
+void JobSystem::submit(const Job* jobs, int count) {
+	int worker = currentWorker();
+	WorkQueue& queue = queues_[worker >= 0 ? worker : queues_.size() - 1];
+	{
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.jobs.insert(queue.jobs.end(), jobs, jobs + count);
+	}
+	queued_.fetch_add(count, std::memory_order_release);
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex_); // Orders against a worker about to sleep
+	}
+	if (count > 1) {
+		wake_.notify_all();
+	} else {
+		wake_.notify_one();
+	}
+}
+
+bool JobSystem::popLocal(int worker, Job& job) {
+	if (worker < 0)
+		return false;
+	WorkQueue& queue = queues_[worker];
+	std::lock_guard<std::mutex> lock(queue.mutex);
+	if (queue.jobs.empty())
+		return false;
+	job = queue.jobs.back();
+	queue.jobs.pop_back();
+	return true;
+}
+
+bool JobSystem::steal(int worker, Job& job) {
+	// Start after our own queue so thieves spread over victims instead of all hitting
+	// worker 0; the shared queue is the last index
+	int count = static_cast<int>(queues_.size());
+	for (int i = 1; i <= count; ++i) {
+		int victim = (worker + i + count) % count;
+		if (victim == worker)
+			continue;
+		WorkQueue& queue = queues_[victim];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.jobs.empty())
+			continue;
+		job = queue.jobs.front();
+		queue.jobs.pop_front();
+		steals_.fetch_add(1, std::memory_order_relaxed);
+		return true;
+	}
+	return false;
+}
+
+bool JobSystem::tryRunOne(int worker) {
+	if (queued_.load(std::memory_order_acquire) == 0)
+		return false;
+	Job job;
+	if (!popLocal(worker, job) && !steal(worker, job))
+		return false;
+	queued_.fetch_sub(1, std::memory_order_relaxed);
+	execute(job, worker);
+	return true;
+}
+
+void JobSystem::execute(const Job& job, int worker) {
+	if (profileHook_) {
+		uint64_t start = nowNs();
+		job.fn(job.data, job.begin, job.end);
+		profileHook_(profileContext_, {job.name, worker, job.begin, job.end, start, nowNs()});
+	} else {
+		job.fn(job.data, job.begin, job.end);
+	}
+	jobsRun_.fetch_add(1, std::memory_order_relaxed);
+	if (job.counter)
+		finish(job.counter);
+}
+
+void JobSystem::finish(JobCounter* counter) {
+	int pending = counter->pending_.load(std::memory_order_relaxed);
+	while (pending > 1) {
+		if (counter->pending_.compare_exchange_weak(pending, pending - 1, std::memory_order_acq_rel))
+			return;
+	}
+	// Possibly the last job: reach zero and collect the continuations in one step, so
+	// runAfter either parks its job before this or sees zero and submits it itself
+	std::vector<Job> ready;
+	{
+		std::lock_guard<std::mutex> lock(counter->mutex_);
+		if (counter->pending_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			ready.swap(counter->continuations_);
+	}
+	for (const Job& job : ready) {
+		if (isSerial()) {
+			execute(job, currentWorker());
+		} else {
+			submit(&job, 1);
+		}
+	}
+}
+
+void JobSystem::workerLoop(int worker) {
+	t_system = this;
+	t_worker = worker;
+	while (running_.load(std::memory_order_relaxed)) {
+		if (tryRunOne(worker))
+			continue;
+		std::unique_lock<std::mutex> lock(sleepMutex_);
+		wake_.wait(lock, [this] { return !running_.load() || queued_.load(std::memory_order_acquire) > 0; });
+	}
+}
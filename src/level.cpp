@@ -1,4 +1,14 @@
+#include <algorithm>
+#include <sstream>
+#include <unordered_map>
 #include "level.hpp"
+#include "tileworld.hpp"
+#include "nlohmann/json.hpp"
+
+using json = nlohmann::json;
+
+// Bumped whenever LevelMetaData gains or changes a field, so old indexes are rebuilt
+const int LEVEL_INDEX_VERSION = 1;
 
 LevelManager::LevelManager(const std::string &levelsDir) : levelsDir_(levelsDir) {
 	if (!std::filesystem::exists(levelsDir_)) {
@@ -6,49 +16,254 @@ LevelManager::LevelManager(const std::string &levelsDir) : levelsDir_(levelsDir)
 	}
 }
 
+LevelManager::~LevelManager() {
+	stopScan_.store(true);
+	if (scanner_.joinable())
+		scanner_.join();
+}
+
 bool LevelManager::extractMetadata(const fs::directory_entry& entry, LevelMetaData& metadata){
 	// Assumes file at entry.path():
 	// - exists
 	// - is a regular file
-	// - has a .tmap extension
+	// - has a .tmap or .tworld extension
 	metadata.filepath = entry.path();
 	metadata.filename = metadata.filepath.filename().string();
 	metadata.displayName = metadata.filepath.filename().string();
 
-	// Extract dimensions from .tmap file (first two lines)
-	std::ifstream file(metadata.filepath.string());
+	std::ifstream file(metadata.filepath.string(), std::ios::binary);
 	if (!file.is_open()) {
 		std::cerr << "Failed to open level file: " << metadata.filepath << std::endl;
 		return false;
 	}
+	std::error_code ec;
+	metadata.fileSize = entry.file_size(ec);
+	metadata.modifiedTime = entry.last_write_time(ec).time_since_epoch().count();
 
-	file >> metadata.dimensions.x >> metadata.dimensions.y;
+	if (metadata.filepath.extension() == ".tworld") {
+		// Streamed levels can be far too big to read here: dimensions come from the header,
+		// the hash covers everything before the chunk payloads and the tile counts stay 0
+		TileWorldHeader header;
+		if (!readTileWorldHeader(file, header)) {
+			std::cerr << "Not a tile world this build can read: " << metadata.filepath << std::endl;
+			return false;
+		}
+		metadata.dimensions = glm::ivec2(header.width, header.height);
+		uint64_t remaining = header.indexOffset + static_cast<uint64_t>(header.chunksX) * header.chunksY * sizeof(TileWorldChunkEntry);
+		uint64_t hash = 14695981039346656037ull;
+		char block[1 << 16];
+		file.seekg(0);
+		while (remaining > 0) {
+			file.read(block, static_cast<std::streamsize>(std::min<uint64_t>(remaining, sizeof(block))));
+			if (file.gcount() <= 0)
+				break;
+			for (std::streamsize i = 0; i < file.gcount(); ++i)
+				hash = (hash ^ static_cast<unsigned char>(block[i])) * 1099511628211ull;
+			remaining -= file.gcount();
+		}
+		metadata.contentHash = hash;
+		metadata.available = true;
+		return true;
+	}
+
+	std::stringstream buffer;
+	buffer << file.rdbuf();
+	const std::string contents = buffer.str();
+
+	// Extract dimensions from .tmap file (first two lines)
+	std::istringstream header(contents);
+	header >> metadata.dimensions.x >> metadata.dimensions.y;
+
+	// One pass for the hash and the tile counts; the header digits never match a tile
+	uint64_t hash = 14695981039346656037ull;
+	int solid = 0, checkpoints = 0, hazards = 0;
+	for (char c : contents) {
+		hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+		solid += c == '#';
+		checkpoints += c == 'C';
+		hazards += c == '^';
+	}
+	metadata.contentHash = hash;
+	metadata.solidTiles = solid;
+	metadata.checkpoints = checkpoints;
+	metadata.hazards = hazards;
+	metadata.fileSize = contents.size();
+	metadata.available = true;
 
 	return true;
 }
 
 bool LevelManager::loadLevelList() {
-	// Iterates over directory provided in constructor, extracts metadata, and populates level options
-	for (const auto& entry : fs::directory_iterator(levelsDir_)) {
-		if (entry.is_regular_file() && entry.path().extension() == ".tmap") {
-			LevelMetaData metadata;
-			if (extractMetadata(entry, metadata)) {
-				availableLevels_.push_back(metadata);
+	// Everything happens on the scanner; the list fills in through pollLevelList
+	startScan();
+	return fs::exists(levelsDir_);
+	// false if there is no levels directory to scan
+}
+
+void LevelManager::refreshLevelList() {
+	if (!isScanning())
+		startScan();
+}
+
+void LevelManager::startScan() {
+	if (scanner_.joinable())
+		scanner_.join();
+	scanning_.store(true, std::memory_order_release);
+	stopScan_.store(false);
+	scanner_ = std::thread([this, known = availableLevels_] { scanLevels(known); });
+}
+
+void LevelManager::scanLevels(std::vector<LevelMetaData> known) {
+	// First scan: what the index file knows stands in for the list we don't have yet
+	if (known.empty())
+		readIndex(known);
+
+	// Stat every level file; only files whose size or mtime differ from the index get opened
+	std::vector<fs::directory_entry> entries;
+	std::error_code ec;
+	for (const auto& entry : fs::directory_iterator(levelsDir_, ec)) {
+		if (entry.is_regular_file() && (entry.path().extension() == ".tmap" || entry.path().extension() == ".tworld")) {
+			entries.push_back(entry);
+		}
+	}
+	std::sort(entries.begin(), entries.end(),
+			  [](const fs::directory_entry& a, const fs::directory_entry& b) { return a.path().filename() < b.path().filename(); });
+
+	std::unordered_map<std::string, size_t> knownByPath;
+	for (size_t i = 0; i < known.size(); ++i)
+		knownByPath.emplace(known[i].filepath.string(), i);
+	std::vector<char> seen(known.size(), 0);
+
+	std::vector<LevelMetaData> current;
+	int reread = 0;
+	for (const auto& entry : entries) {
+		if (stopScan_.load(std::memory_order_relaxed)) {
+			scanning_.store(false, std::memory_order_release);
+			return; // Index left as it was
+		}
+		auto found = knownByPath.find(entry.path().string());
+		if (found != knownByPath.end()) {
+			seen[found->second] = 1;
+			const LevelMetaData& level = known[found->second];
+			if (level.available && level.fileSize == entry.file_size(ec) &&
+				level.modifiedTime == entry.last_write_time(ec).time_since_epoch().count()) {
+				current.push_back(level); // Unchanged; sent again in case the list came from the index
+				std::lock_guard<std::mutex> lock(scanMutex_);
+				scanned_.push_back(level);
+				continue;
 			}
 		}
+		LevelMetaData metadata;
+		if (extractMetadata(entry, metadata)) {
+			current.push_back(metadata);
+			std::lock_guard<std::mutex> lock(scanMutex_);
+			scanned_.push_back(metadata);
+			++reread;
+		}
+	}
+
+	// Indexed levels the directory no longer has
+	std::vector<LevelMetaData> gone;
+	for (size_t i = 0; i < known.size(); ++i) {
+		if (!seen[i] && known[i].available) {
+			gone.push_back(known[i]);
+			gone.back().available = false;
+		}
+	}
+	{
+		std::lock_guard<std::mutex> lock(scanMutex_);
+		scanned_.insert(scanned_.end(), gone.begin(), gone.end());
+	}
+
+	if (reread > 0 || !gone.empty() || current.size() != known.size()) {
+		writeIndex(current);
 	}
-	return !availableLevels_.empty();
-	// false if no levels found, true if level list populated
+	DEBUG_ONLY(std::cout << "[LevelManager] Scanned " << entries.size() << " levels, re-read " << reread << ", "
+						 << gone.size() << " gone" << std::endl;);
+	scanning_.store(false, std::memory_order_release);
 }
 
-std::vector<LevelMetaData>& LevelManager::getAvailableLevels() {
-	return availableLevels_;
+void LevelManager::pollLevelList() {
+	std::vector<LevelMetaData> updates;
+	{
+		std::lock_guard<std::mutex> lock(scanMutex_);
+		if (scanned_.empty())
+			return;
+		updates.swap(scanned_);
+	}
+	for (LevelMetaData& update : updates) {
+		auto slot = levelSlots_.find(update.filename);
+		if (slot != levelSlots_.end()) {
+			availableLevels_[slot->second] = std::move(update);
+		} else if (update.available) {
+			levelSlots_.emplace(update.filename, availableLevels_.size());
+			availableLevels_.push_back(std::move(update));
+		}
+	}
+}
+
+bool LevelManager::readIndex(std::vector<LevelMetaData>& levels) const {
+	std::ifstream file((fs::path(levelsDir_) / LEVEL_INDEX_FILE).string());
+	if (!file.is_open())
+		return false; // First run; the scan writes one
+	try {
+		json index = json::parse(file);
+		if (index.value("version", 0) != LEVEL_INDEX_VERSION)
+			return false;
+		for (const auto& entry : index.at("levels")) {
+			LevelMetaData metadata;
+			metadata.filename = entry.at("file").get<std::string>();
+			metadata.filepath = fs::path(levelsDir_) / metadata.filename;
+			metadata.displayName = metadata.filename;
+			metadata.dimensions = glm::ivec2(entry.at("width").get<int>(), entry.at("height").get<int>());
+			metadata.fileSize = entry.at("size").get<uintmax_t>();
+			metadata.modifiedTime = entry.at("mtime").get<int64_t>();
+			metadata.contentHash = entry.at("hash").get<uint64_t>();
+			metadata.solidTiles = entry.value("solid", 0);
+			metadata.checkpoints = entry.value("checkpoints", 0);
+			metadata.hazards = entry.value("hazards", 0);
+			levels.push_back(metadata);
+		}
+	} catch (const std::exception& e) {
+		std::cerr << "[LevelManager] Ignoring unreadable level index: " << e.what() << std::endl;
+		levels.clear();
+		return false;
+	}
+	return true;
 }
 
-Tilemap LevelManager::loadLevel(int index) {
-	if (index < 0 || index >= static_cast<int>(availableLevels_.size())) {
-		throw std::out_of_range("Invalid level index");
+bool LevelManager::writeIndex(const std::vector<LevelMetaData>& levels) const {
+	json index;
+	index["version"] = LEVEL_INDEX_VERSION;
+	index["levels"] = json::array();
+	for (const LevelMetaData& level : levels) {
+		index["levels"].push_back({{"file", level.filename},
+								   {"width", level.dimensions.x},
+								   {"height", level.dimensions.y},
+								   {"size", level.fileSize},
+								   {"mtime", level.modifiedTime},
+								   {"hash", level.contentHash},
+								   {"solid", level.solidTiles},
+								   {"checkpoints", level.checkpoints},
+								   {"hazards", level.hazards}});
 	}
-	auto& metadata = availableLevels_[index];
-	return loadTilemapFromFile(metadata.filepath.string(), TILE_SIZE, floorTex_, wallTex_);
-}
\ No newline at end of file
+	// Written beside the real one and renamed over it, so a crash never leaves half an index
+	fs::path path = fs::path(levelsDir_) / LEVEL_INDEX_FILE;
+	fs::path temp = path;
+	temp += ".tmp";
+	{
+		std::ofstream file(temp.string());
+		if (!file.is_open()) {
+			std::cerr << "[LevelManager] Failed to write level index: " << temp << std::endl;
+			return false;
+		}
+		file << index.dump(1, '\t');
+	}
+	std::error_code ec;
+	fs::rename(temp, path, ec);
+	return !ec;
+}
+
+std::vector<LevelMetaData>& LevelManager::getAvailableLevels() {
+	return availableLevels_;
+}
@@ -0,0 +1,223 @@
+#include <algorithm>
+#include <filesystem>
+#include "levelloader.hpp"
+#include "compiledlevel.hpp"
+
+// Rough share of the total load time each stage takes, for the progress bar
+const float PARSE_SHARE = 0.7f;
+const float COLLISION_SHARE = 0.2f;
+
+LevelLoader::~LevelLoader() {
+	cancel();
+	// Nothing may outlive the loader, so this is the one place that waits
+	for (auto& job : retired_)
+		job->thread.join();
+}
+
+void LevelLoader::start(const std::string& path, Texture* floorTex, Texture* wallTex, const SensorLayout& layout) {
+	cancel();
+	path_ = path;
+	job_ = std::make_unique<Job>();
+	job_->path = path;
+	Job* job = job_.get(); // Joined before it's destroyed, so the thread can hold on to it
+	job->thread = std::thread([job, floorTex, wallTex, layout] { run(*job, floorTex, wallTex, layout); });
+}
+
+void LevelLoader::cancel() {
+	if (job_) {
+		job_->progress.cancelled.store(true);
+		retired_.push_back(std::move(job_));
+	}
+	reap();
+}
+
+void LevelLoader::reap() {
+	retired_.erase(std::remove_if(retired_.begin(), retired_.end(),
+								  [](std::unique_ptr<Job>& job) {
+									  if (!job->done.load(std::memory_order_acquire))
+										  return false;
+									  job->thread.join();
+									  return true;
+								  }),
+				   retired_.end());
+}
+
+std::unique_ptr<LoadedLevel> LevelLoader::take() {
+	if (getStage() != LoadStage::READY)
+		return nullptr;
+	job_->thread.join(); // Already past its last write
+	std::unique_ptr<LoadedLevel> level = std::move(job_->result);
+	job_.reset();
+	reap();
+	return level;
+}
+
+const std::string& LevelLoader::getError() const {
+	static const std::string none;
+	return job_ ? job_->error : none;
+}
+
+float LevelLoader::getProgress() const {
+	switch (getStage()) {
+		case LoadStage::PARSING:
+			return PARSE_SHARE * job_->progress.fraction.load(std::memory_order_relaxed);
+		case LoadStage::COLLISION:
+			return PARSE_SHARE;
+		case LoadStage::GEOMETRY:
+			return PARSE_SHARE + COLLISION_SHARE;
+		case LoadStage::READY:
+			return 1.0f;
+		default:
+			return 0.0f;
+	}
+}
+
+const char* LevelLoader::stageName(LoadStage stage) {
+	switch (stage) {
+		case LoadStage::IDLE:
+			return "Idle";
+		case LoadStage::PARSING:
+			return "Reading tiles";
+		case LoadStage::COLLISION:
+			return "Building collision";
+		case LoadStage::GEOMETRY:
+			return "Building geometry";
+		case LoadStage::READY:
+			return "Ready";
+		case LoadStage::FAILED:
+			return "Failed";
+	}
+	return "";
+}
+
+void LevelLoader::run(Job& job, Texture* floorTex, Texture* wallTex, SensorLayout layout) {
+	const std::atomic<bool>& cancelled = job.progress.cancelled;
+	try {
+		std::unique_ptr<LoadedLevel> level;
+		if (std::filesystem::path(job.path).extension() == ".tworld") {
+			// Streamed: only the header, palette and markers are read now, chunks load during play
+			level = std::make_unique<LoadedLevel>(Tilemap(1, 1, TILE_SIZE));
+			level->world = std::make_unique<TileWorld>();
+			if (!level->world->open(job.path, TILE_SIZE))
+				throw std::runtime_error("Failed to open tile world");
+			level->world->setTextures(floorTex, wallTex);
+
+			job.stage.store(LoadStage::COLLISION, std::memory_order_release);
+			level->triggers.load(*level->world);
+		} else {
+			std::vector<LevelChunkInfo> chunks;
+			level = std::make_unique<LoadedLevel>(loadLevelFile(job.path, TILE_SIZE, floorTex, wallTex, &job.progress, &chunks));
+
+			job.stage.store(LoadStage::COLLISION, std::memory_order_release);
+			level->playerSpace.sync(level->tilemap, layout, &cancelled);
+			if (cancelled.load())
+				throw std::runtime_error("Level load cancelled");
+
+			job.stage.store(LoadStage::GEOMETRY, std::memory_order_release);
+			level->mesh.build(level->tilemap, &chunks, &cancelled);
+			if (cancelled.load())
+				throw std::runtime_error("Level load cancelled");
+		}
+
+		job.result = std::move(level);
+		job.stage.store(LoadStage::READY, std::memory_order_release);
+	} catch (const std::exception& e) {
+		job.error = e.what();
+		job.stage.store(LoadStage::FAILED, std::memory_order_release);
+	}
+	job.done.store(true, std::memory_order_release);
+}
+
+void LevelCache::configure(Texture* floorTex, Texture* wallTex, const SensorLayout& playerLayout) {
+	floorTex_ = floorTex;
+	wallTex_ = wallTex;
+	layout_ = playerLayout;
+}
+
+const LevelCache::Entry* LevelCache::find(const std::string& path) const {
+	for (const Entry& entry : entries_) {
+		if (entry.path == path)
+			return &entry;
+	}
+	return nullptr;
+}
+
+void LevelCache::prefetch(const std::string& path) {
+	if (pending_ == path)
+		pending_.clear(); // Wanted now rather than later
+	for (Entry& entry : entries_) {
+		if (entry.path == path) {
+			entry.lastUse = ++useClock_;
+			return;
+		}
+	}
+	if (isLoading(path) || hasFailed(path) || (loader_.getStage() == LoadStage::READY && loader_.getPath() == path))
+		return;
+	loader_.start(path, floorTex_, wallTex_, layout_);
+}
+
+void LevelCache::prefetchSettled(const std::string& path, int frames) {
+	pending_ = path;
+	pendingFrames_ = frames;
+}
+
+void LevelCache::evict(const std::string& path) {
+	if (pending_ == path)
+		pending_.clear();
+	if (loader_.getPath() == path)
+		loader_.cancel();
+	entries_.erase(std::remove_if(entries_.begin(), entries_.end(), [&](const Entry& entry) { return entry.path == path; }),
+				   entries_.end());
+}
+
+void LevelCache::cancel() {
+	pending_.clear();
+	loader_.cancel();
+}
+
+void LevelCache::poll() {
+	if (!pending_.empty() && --pendingFrames_ <= 0) {
+		std::string path = std::move(pending_);
+		pending_.clear();
+		prefetch(path);
+	}
+	if (loader_.getStage() != LoadStage::READY)
+		return;
+	std::string path = loader_.getPath();
+	std::unique_ptr<LoadedLevel> level = loader_.take();
+	size_t bytes = level->getMemoryBytes();
+	entries_.push_back({path, std::move(level), bytes, ++useClock_});
+	trim(path);
+}
+
+std::unique_ptr<LoadedLevel> LevelCache::take(const std::string& path) {
+	poll();
+	for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+		if (it->path == path) {
+			std::unique_ptr<LoadedLevel> level = std::move(it->level);
+			entries_.erase(it);
+			return level;
+		}
+	}
+	return nullptr;
+}
+
+size_t LevelCache::getUsedBytes() const {
+	size_t bytes = 0;
+	for (const Entry& entry : entries_)
+		bytes += entry.bytes;
+	return bytes;
+}
+
+void LevelCache::trim(const std::string& keep) {
+	while (getUsedBytes() > budget_) {
+		auto oldest = entries_.end();
+		for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+			if (it->path != keep && (oldest == entries_.end() || it->lastUse < oldest->lastUse))
+				oldest = it;
+		}
+		if (oldest == entries_.end())
+			return; // Only the newest is left
+		entries_.erase(oldest);
+	}
+}
@@ -1,6 +1,17 @@
 #include "helpers.hpp"
+#include "benchmark.hpp"
+#include "compiledlevel.hpp"
+
+int main(int argc, char** argv) {
+	// Headless benchmark mode: ./game --bench [level.tmap]
+	if (argc > 1 && std::string(argv[1]) == "--bench") {
+		return runBenchmarks(argc > 2 ? argv[2] : "./assets/levels/open_extra_large.tmap");
+	}
+	// Offline level compiler: ./game --compile-level level.tmap [out.tlvl|out.tworld]
+	if (argc > 2 && std::string(argv[1]) == "--compile-level") {
+		return compileLevelFile(argv[2], argc > 3 ? argv[3] : "");
+	}
 
-int main(void) {
 	Window window(1920, 1080, "OpenGL Window");
 
 	Shader shader;
@@ -38,7 +49,7 @@ int main(void) {
 
 	// std::string tilemapFile = "./assets/levels/test2.tmap";
 	std::string tilemapFile = "./assets/levels/open_extra_large.tmap";
-	Tilemap tilemap = loadTilemapFromFile(tilemapFile, TILE_SIZE, &grassTexture, &wallTexture); // Load tilemap with TILE_SIZE
+	Tilemap tilemap = loadLevelFile(tilemapFile, TILE_SIZE, &grassTexture, &wallTexture); // Load tilemap with TILE_SIZE
 
 	LevelManager levelManager("./assets/levels");
 	
@@ -0,0 +1,45 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <iostream>
+#include "mappedfile.hpp"
+
+bool MappedFile::open(const std::string& path) {
+	close();
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false; // Missing is normal for a cache, so no message
+	struct stat info;
+	if (fstat(fd, &info) != 0 || info.st_size == 0) {
+		::close(fd);
+		return false;
+	}
+	// PROT_WRITE on a read-only fd is fine with MAP_PRIVATE: writes never go back to the file
+	void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	::close(fd); // The mapping keeps the file alive
+	if (data == MAP_FAILED) {
+		std::cerr << "[MappedFile] Failed to map " << path << std::endl;
+		return false;
+	}
+	data_ = static_cast<uint8_t*>(data);
+	size_ = static_cast<size_t>(info.st_size);
+	return true;
+}
+
+void MappedFile::discard(size_t offset, size_t bytes) {
+	if (!data_ || offset >= size_ || bytes == 0)
+		return;
+	const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+	size_t begin = offset / page * page;
+	size_t end = std::min(offset + bytes, size_);
+	madvise(data_ + begin, end - begin, MADV_DONTNEED);
+}
+
+void MappedFile::close() {
+	if (data_)
+		munmap(data_, size_);
+	data_ = nullptr;
+	size_ = 0;
+}
@@ -0,0 +1,73 @@
+#include <algorithm>
+#include <iostream>
+#include "objectregistry.hpp"
+
+void ObjectRegistry::sync(const std::vector<GameObject>& objects) {
+	if (objects.size() < handles_.size()) {
+		// Something shrank the vector behind our back; indices no longer line up
+		std::cerr << "ObjectRegistry: object vector shrank outside remove(), re-registering" << std::endl;
+		clear();
+	}
+	for (size_t i = handles_.size(); i < objects.size(); ++i) {
+		uint32_t slot;
+		if (!freeSlots_.empty()) {
+			slot = freeSlots_.back();
+			freeSlots_.pop_back();
+		} else {
+			slot = static_cast<uint32_t>(slots_.size());
+			slots_.emplace_back();
+		}
+		slots_[slot].object = static_cast<int>(i);
+		ObjectHandle handle = {slot, slots_[slot].generation};
+		TagId tag = objects[i].getTag();
+		handles_.push_back(handle);
+		tags_.push_back(tag);
+		tagged_[tag].push_back(handle);
+	}
+}
+
+void ObjectRegistry::clear() {
+	// Bump every generation so handles from before the clear don't resolve to new objects
+	freeSlots_.clear();
+	for (uint32_t slot = static_cast<uint32_t>(slots_.size()); slot-- > 0;) {
+		if (slots_[slot].object >= 0) {
+			slots_[slot].generation++;
+			slots_[slot].object = -1;
+		}
+		freeSlots_.push_back(slot);
+	}
+	handles_.clear();
+	tags_.clear();
+	tagged_.clear();
+}
+
+void ObjectRegistry::remove(std::vector<GameObject>& objects, ObjectHandle handle) {
+	int index = indexOf(handle);
+	if (index < 0)
+		return;
+
+	std::vector<ObjectHandle>& tagged = tagged_[tags_[index]];
+	tagged.erase(std::find(tagged.begin(), tagged.end(), handle));
+
+	Slot& slot = slots_[handle.index];
+	slot.generation++;
+	slot.object = -1;
+	freeSlots_.push_back(handle.index);
+
+	int last = static_cast<int>(objects.size()) - 1;
+	if (index != last) {
+		objects[index] = std::move(objects[last]);
+		handles_[index] = handles_[last];
+		tags_[index] = tags_[last];
+		slots_[handles_[index].index].object = index;
+	}
+	objects.pop_back();
+	handles_.pop_back();
+	tags_.pop_back();
+}
+
+const std::vector<ObjectHandle>& ObjectRegistry::withTag(TagId tag) const {
+	static const std::vector<ObjectHandle> none;
+	auto it = tagged_.find(tag);
+	return it != tagged_.end() ? it->second : none;
+}
@@ -1,229 +1,314 @@
 #include "physics.hpp"
+#include "tileworld.hpp"
+
+namespace {
+
+// Sub-steps needed to keep each one under SUBSTEP_FRACTION of a tile, clamped to MAX_SUBSTEPS
+int substepCount(const glm::vec2& displacement, bool& capped) {
+	float travel = std::max(std::abs(displacement.x), std::abs(displacement.y));
+	int count = static_cast<int>(std::ceil(travel / (SUBSTEP_FRACTION * TILE_SIZE)));
+	capped = count > MAX_SUBSTEPS;
+	return std::min(std::max(count, 1), MAX_SUBSTEPS);
+}
+
+// The player's movement integration, written once for float and fixed point
+template <typename Vec>
+void integrateMovement(Vec& position, Vec& velocity, const Vec& accel, bool grounded, typename Vec::value_type deltaTime) {
+	using S = typename Vec::value_type;
+	const S zero = fromFloat<S>(0.0f);
+	const S maxVelocity = fromFloat<S>(MAX_VELOCITY);
 
-void Physics::playerMovementStep(PlayerObject& player, float deltaTime) {
 	// Horizontal pass
-	glm::vec2 oldVel = player.getVelocity();
-	float velX = player.getAcceleration().x * deltaTime; // Calculate velocity based on acceleration
-	player.addVelocity(glm::vec2(velX, 0.0f));			 // ! *Add* velocity
+	S oldVelX = velocity.x;
+	S velX = accel.x * deltaTime; // Calculate velocity based on acceleration
+	velocity.x += velX;			  // ! *Add* velocity
 
 	// Prevent deceleration from overshooting zero (flipping sign)
 	// Ensures that velocity must hit 0 the frame before the player's direction of 
 	// travel can actually change
-    if ((oldVel.x > 0.0f && player.getVelocity().x < 0.0f) ||
-        (oldVel.x < 0.0f && player.getVelocity().x > 0.0f)) {
-        player.setVelocity(glm::vec2(0.0f, player.getVelocity().y));
-    }
-
-	if (std::abs(player.getVelocity().x) >= MAX_VELOCITY) { // Limit horizontal velocity
-		if (velX > 0.0f) {
-			player.setVelocity(glm::vec2(MAX_VELOCITY, player.getVelocity().y));
-		} else if (velX < 0.0f) {
-			player.setVelocity(glm::vec2(-MAX_VELOCITY, player.getVelocity().y));
-		}
-	}
-	if (std::abs(player.getVelocity().x) < 0.01f) {
-		player.setVelocity(glm::vec2(0.0f, player.getVelocity().y));
+	if ((oldVelX > zero && velocity.x < zero) || (oldVelX < zero && velocity.x > zero)) {
+		velocity.x = zero;
 	}
-	
-	// Update facing direction based on velocity if grounded (midair update tied to input)
-	if(player.isGrounded()){
-		if(player.getVelocity().x < 0.0f) {
-			// Moving left
-			player.setFacingDirection(FacingDirection::LEFT);
-		} else if (player.getVelocity().x > 0.0f) {
-			// Moving right
-			player.setFacingDirection(FacingDirection::RIGHT);
+
+	if (absValue(velocity.x) >= maxVelocity) { // Limit horizontal velocity
+		if (velX > zero) {
+			velocity.x = maxVelocity;
+		} else if (velX < zero) {
+			velocity.x = -maxVelocity;
 		}
 	}
+	if (absValue(velocity.x) < fromFloat<S>(0.01f)) {
+		velocity.x = zero;
+	}
 
 	// Vertical pass + gravity
-	if (player.isGrounded()) {
-		player.setVelocity(glm::vec2(player.getVelocity().x, 0));
-	}
-	float velY = (player.getAcceleration().y + gravity) * deltaTime;
-	
-	player.addVelocity(glm::vec2(0.0f, velY));
-	
-	if (std::abs(player.getVelocity().y) >= MAX_VELOCITY) { // Limit vertical velocity
-		if (velY > 0.0f) {
-			player.setVelocity(glm::vec2(player.getVelocity().x, MAX_VELOCITY));
-		} else if (velY < 0.0f) {
-			player.setVelocity(glm::vec2(player.getVelocity().x, -MAX_VELOCITY));
+	if (grounded) {
+		velocity.y = zero;
+	}
+	S velY = (accel.y + fromFloat<S>(gravity)) * deltaTime;
+	velocity.y += velY;
+
+	if (absValue(velocity.y) >= maxVelocity) { // Limit vertical velocity
+		if (velY > zero) {
+			velocity.y = maxVelocity;
+		} else if (velY < zero) {
+			velocity.y = -maxVelocity;
 		}
 	}
-	player.applyVelocity(deltaTime);
-
-	player.sensorUpdate(); // KEEP THIS UPDATE HERE! ESSENTIAL FOR PREVENTING SENSORS FROM LAGGING BEHIND
+	position += velocity * deltaTime;
+}
 
+// The box spanned by the player's sensors
+AABB sensorBox(const PlayerObject& player) {
+	glm::vec2 extents = player.getSensorExtents();
+	glm::vec2 position = player.getPosition();
+	return {position.x - extents.x, position.x + extents.x, position.y + extents.y, position.y - extents.y};
 }
 
-void Physics::checkPlayerWorldCollisions(PlayerObject& player, Tilemap& tilemap) {
+} // namespace
 
-	// ! NOTE: TILE STRUCT POSITION STARTS AT BOTTOM LEFT CORNER, NOT CENTER
+template <typename Grid>
+void Physics::stepPlayer(PlayerObject& player, const Grid& tilemap, float deltaTime, PlatformSystem* platforms) {
+	// Riders move with their platform first, so tile resolution sees the carried position
+	if (platforms) {
+		glm::vec2 carried = platforms->carry(PlatformSystem::PLAYER_RIDER);
+		if (carried != glm::vec2(0.0f)) {
+			player.offsetPosition(carried);
+			player.sensorUpdate();
+		}
+	}
+	float prevBottom = player.getPosition().y - player.getSensorExtents().y;
+
+	// Project this step's displacement from the current velocity plus this step's acceleration
+	glm::vec2 accel = player.getAcceleration() + glm::vec2(0.0f, gravity);
+	glm::vec2 projected = (player.getVelocity() + accel * deltaTime) * deltaTime;
+
+	bool capped = false;
+	int substeps = substepCount(projected, capped);
+	if (substeps > 1) {
+		// A path that stays in free configuration space can't touch a tile, so no need to split it
+		const CollisionSpace* space = playerSpaceFor(tilemap, player.getSensorLayout());
+		if (space && space->sweep(player.getPosition(), projected) >= 1.0f) {
+			substeps = 1;
+			capped = false;
+		}
+	}
 
-	// Goal-collision optimisation
-	// ---------------------------
-	// We skip expensive “all-sensor” checks until the player is very close to a goal:
-	//   • Proximity filter: Chebyshev distance (tile units) ≤ 5 to *any* goal tile.
-	//   • Precision check: when that filter passes, probe each of the four sensors.
-	//     A probe is just a tile lookup, so the per-frame cost is O(1) (4 lookups).
-	//
+	float subDelta = deltaTime / substeps;
+	for (int i = 0; i < substeps; ++i) {
+		playerMovementStep(player, subDelta);
+		checkPlayerWorldCollisions(player, tilemap);
+	}
+	stats_.playerSubsteps = substeps;
+	if (capped) {
+		stats_.playerCappedSteps++;
+	}
 
-	// ? ^ This is just stupid btw
+	if (platforms) {
+		settlePlayerOnPlatforms(player, *platforms, prevBottom);
+	}
+}
 
-	// Proximity filter: Chebyshev distance (tile units) ≤ 5 to *a* goal tile.
-	glm::ivec2 playerTile = tilemap.worldToTileIndex(player.getPosition());
-	glm::ivec2 goalTile = tilemap.getGoalPos();
-	int goalDistance = std::max(std::abs(playerTile.x - goalTile.x), std::abs(playerTile.y - goalTile.y));
+const CollisionSpace* Physics::playerSpaceFor(const Tilemap& tilemap, const SensorLayout& layout) {
+	playerSpace_.sync(tilemap, layout);
+	return &playerSpace_;
+}
 
+void Physics::settlePlayerOnPlatforms(PlayerObject& player, PlatformSystem& platforms, float prevBottom) {
+	// Platform tops are tested against the sensor box, the same feet the tiles see
+	float lift = 0.0f;
+	if (!platforms.settle(PlatformSystem::PLAYER_RIDER, sensorBox(player), prevBottom, player.getVelocity().y, lift))
+		return;
+
+	// Same as landing on a tile: rest on the top, stop falling, grounded
+	player.offsetPosition(glm::vec2(0.0f, lift));
+	player.setVelocity(glm::vec2(player.getVelocity().x, 0.0f));
+	player.setAcceleration(glm::vec2(player.getAcceleration().x, 0.0f));
+	player.setGrounded(true);
+	player.sensorUpdate();
+}
 
-	if (goalDistance <= 5 && !player.checkIfInGoal()) {
-		player.tileGoalCollision(tilemap, player.getLeftSensor());
-		player.tileGoalCollision(tilemap, player.getRightSensor());
-		player.tileGoalCollision(tilemap, player.getTopSensor());
-		player.tileGoalCollision(tilemap, player.getBottomSensor());
-	}
+void Physics::playerMovementStep(PlayerObject& player, float deltaTime) {
+	PhysVec2 position = playerPosition(player);
+	PhysVec2 velocity = fromFloatVec<PhysVec2>(player.getVelocity());
+	integrateMovement(position, velocity, fromFloatVec<PhysVec2>(player.getAcceleration()), player.isGrounded(),
+					  fromFloat<PhysReal>(deltaTime));
+	player.setVelocity(toFloat(velocity));
+	setPlayerPosition(player, position);
 
-	// Before this block runs at least once, in_goal is still false
-	if (player.getGoalCount() >= 1 && !player.checkIfInGoal()) {
-		player.setInGoal(true);
-		// DEBUG_ONLY(std::cout << "Player has reached the goal!\n";);
+	// Update facing direction based on velocity if grounded (midair update tied to input)
+	if(player.isGrounded()){
+		if(player.getVelocity().x < 0.0f) {
+			// Moving left
+			player.setFacingDirection(FacingDirection::LEFT);
+		} else if (player.getVelocity().x > 0.0f) {
+			// Moving right
+			player.setFacingDirection(FacingDirection::RIGHT);
+		}
 	}
 
-	// Check collisions with the tilemap using sensors
-	if (player.getVelocity().x < 0.0f) {
-		// Negative velocity, don't need to check right sensor
-		if (player.tileCollision(tilemap, player.getLeftSensor())) {
-
-			player.setVelocity(glm::vec2(0.0f, player.getVelocity().y));		 // Stop horizontal movement
-			player.setAcceleration(glm::vec2(0.0f, player.getAcceleration().y)); // Reset horizontal acceleration
-
-			glm::ivec2 tileidx = tilemap.worldToTileIndex(player.getLeftSensor().position);
-			auto tile = tilemap.getTile(tileidx.x, tileidx.y);
-			float tileposx = tile.position.x;
-			float tileright = tileposx + tilemap.getTileSize();
+	player.sensorUpdate(); // KEEP THIS UPDATE HERE! ESSENTIAL FOR PREVENTING SENSORS FROM LAGGING BEHIND
 
-			// DEBUG_ONLY(std::cout << "Left sensor position: " << player.getLeftSensor().position.x << "\n";
-			// 		   std::cout << "Tile right position: " << tileright << "\n";);
+}
 
-			if (player.getLeftSensor().position.x < tileright) {
-				// If left sensor is to left of right tile edge, snap it to the right edge
-				player.offsetPosition(glm::vec2(tileright - player.getLeftSensor().position.x + EPSILON, 0.0f));
-			}
-			player.sensorUpdate(); // Immediate sensor update after any movement
-		}
-	} else if (player.getVelocity().x > 0.0f) {
-		// Positive velocity, don't need to check left sensor
-		if (player.tileCollision(tilemap, player.getRightSensor())) {
-			player.setVelocity(glm::vec2(0.0f, player.getVelocity().y));
-			player.setAcceleration(glm::vec2(0.0f, player.getAcceleration().y));
-
-			glm::ivec2 tileidx = tilemap.worldToTileIndex(player.getRightSensor().position);
-			auto tile = tilemap.getTile(tileidx.x, tileidx.y);
-			float tileleft = tile.position.x; // Tile position is bottom left corner, can just use position.x
-
-			// DEBUG_ONLY(std::cout << "Right sensor position: " << player.getRightSensor().position.x << "\n";
-			// 		   std::cout << "Tile left position: " << tileleft << "\n";);
-
-			if (player.getRightSensor().position.x > tileleft) {
-				// If right sensor is to right of left tile edge, snap it to the left edge
-				player.offsetPosition(glm::vec2(tileleft - player.getRightSensor().position.x - EPSILON, 0.0f));
-			}
-			player.sensorUpdate();
-		}
-	} else {
-		// Otherwise, check both (0 velocity, or edge cases?)
-		if (player.tileCollision(tilemap, player.getLeftSensor())) {
-			player.setVelocity(glm::vec2(0.0f, player.getVelocity().y));		 // Stop horizontal movement
-			player.setAcceleration(glm::vec2(0.0f, player.getAcceleration().y)); // Reset horizontal acceleration
-
-			glm::ivec2 tileidx = tilemap.worldToTileIndex(player.getLeftSensor().position);
-			auto tile = tilemap.getTile(tileidx.x, tileidx.y);
-			float tileposx = tile.position.x;
-			float tileright = tileposx + tilemap.getTileSize();
-
-			// DEBUG_ONLY(std::cout << "Left sensor position: " << player.getLeftSensor().position.x << "\n";
-			// 		   std::cout << "Tile right position: " << tileright << "\n";);
-
-			if (player.getLeftSensor().position.x < tileright) {
-				// If left sensor is to left of right tile edge, snap it to the right edge
-				player.offsetPosition(glm::vec2(tileright - player.getLeftSensor().position.x + EPSILON, 0.0f));
-			}
-			player.sensorUpdate(); // Immediate sensor update after any movement
-		}
+PhysVec2 Physics::playerPosition(const PlayerObject& player) {
+	// The float position is only a copy for rendering; reload from it when something
+	// outside physics moved the player (spawn, reset, level load)
+	if (!playerPosValid_ || player.getPosition() != playerPosShown_) {
+		playerPos_ = fromFloatVec<PhysVec2>(player.getPosition());
+		playerPosShown_ = player.getPosition();
+		playerPosValid_ = true;
+	}
+	return playerPos_;
+}
 
-		if (player.tileCollision(tilemap, player.getRightSensor())) {
-			player.setVelocity(glm::vec2(0.0f, player.getVelocity().y));
-			player.setAcceleration(glm::vec2(0.0f, player.getAcceleration().y));
+void Physics::setPlayerPosition(PlayerObject& player, const PhysVec2& position) {
+	playerPos_ = position;
+	playerPosShown_ = toFloat(position);
+	playerPosValid_ = true;
+	player.setPosition(playerPosShown_);
+}
 
-			glm::ivec2 tileidx = tilemap.worldToTileIndex(player.getRightSensor().position);
-			auto tile = tilemap.getTile(tileidx.x, tileidx.y);
-			float tileleft = tile.position.x; // Tile position is bottom left corner, can just use position.x
+template <typename Grid>
+void Physics::checkPlayerWorldCollisions(PlayerObject& player, const Grid& tilemap) {
 
-			// DEBUG_ONLY(std::cout << "Right sensor position: " << player.getRightSensor().position.x << "\n";
-			// 		   std::cout << "Tile left position: " << tileleft << "\n";);
+	// ! NOTE: TILE STRUCT POSITION STARTS AT BOTTOM LEFT CORNER, NOT CENTER
 
-			if (player.getRightSensor().position.x > tileleft) {
-				// If right sensor is to right of left tile edge, snap it to the left edge
-				player.offsetPosition(glm::vec2(tileleft - player.getRightSensor().position.x - EPSILON, 0.0f));
+	// Hazard tiles: a single masked rect test around the player's AABB rules out
+	// hazards almost every frame, so the sensors are only probed when one is adjacent
+	const AABB& box = player.getAABB();
+	glm::ivec2 minTile = tilemap.worldToTileIndex(glm::vec2(box.left, box.bottom));
+	glm::ivec2 maxTile = tilemap.worldToTileIndex(glm::vec2(box.right, box.top));
+	if (tilemap.anyHazardInRect(minTile.x - 1, minTile.y - 1, maxTile.x + 1, maxTile.y + 1)) {
+		const Sensor* sensors[] = {&player.getLeftSensor(), &player.getRightSensor(), &player.getTopSensor(), &player.getBottomSensor()};
+		for (const Sensor* sensor : sensors) {
+			glm::ivec2 idx = tilemap.worldToTileIndex(sensor->position);
+			if (tilemap.isHazardTile(idx.x, idx.y)) {
+				publish(PlayerDiedEvent{DeathCause::HAZARD_TILE, player.getPosition()});
+				break;
 			}
-			player.sensorUpdate();
 		}
 	}
-	if (player.tileCollision(tilemap, player.getTopSensor())) {
-		player.setVelocity(glm::vec2(player.getVelocity().x, 0.0f));
-		player.setAcceleration(glm::vec2(player.getAcceleration().x, gravity)); // Reset vertical acceleration
 
-		glm::ivec2 tileidx = tilemap.worldToTileIndex(player.getTopSensor().position);
-		auto tile = tilemap.getTile(tileidx.x, tileidx.y);
-		float tilebot = tile.position.y; // Tile position is bottom left corner, can just use position.y
+	// Sensor resolution runs through the shared tile collider path; the player only adds
+	// its acceleration resets on top of the contacts
+	TileCollider body;
+	body.layout = player.getSensorLayout();
+	body.position = playerPosition(player);
+	body.velocity = fromFloatVec<PhysVec2>(player.getVelocity());
+	resolveTileCollider(tilemap, body, playerSpaceFor(tilemap, body.layout));
+
+	setPlayerPosition(player, body.position);
+	player.setVelocity(toFloat(body.velocity));
+	if (body.contacts & (CONTACT_LEFT | CONTACT_RIGHT)) {
+		player.setAcceleration(glm::vec2(0.0f, player.getAcceleration().y)); // Reset horizontal acceleration
+	}
+	if (body.contacts & CONTACT_TOP) {
+		player.setAcceleration(glm::vec2(player.getAcceleration().x, gravity)); // Reset vertical acceleration
+	}
+	player.setGrounded(body.grounded);
+	if (body.grounded) {
+		player.setAcceleration(glm::vec2(player.getAcceleration().x, 0.0f));
+	}
+	player.sensorUpdate();
+}
 
-		// DEBUG_ONLY(std::cout << "Top sensor position: " << player.getTopSensor().position.x << "\n";
-		// 		   std::cout << "Tile bottom position: " << tilebot << "\n";);
-		if (player.getTopSensor().position.y > tilebot) {
-			// If the bottom sensor is above the tile top, snap it to the tile top
-			player.offsetPosition(glm::vec2(0.0f, tilebot - player.getTopSensor().position.y - EPSILON));
+template void Physics::stepPlayer(PlayerObject&, const Tilemap&, float, PlatformSystem*);
+template void Physics::stepPlayer(PlayerObject&, const TileWorld&, float, PlatformSystem*);
+template void Physics::checkPlayerWorldCollisions(PlayerObject&, const Tilemap&);
+template void Physics::checkPlayerWorldCollisions(PlayerObject&, const TileWorld&);
+
+void Physics::checkPlayerTriggers(PlayerObject& player, TriggerSystem& triggers) {
+	triggers.update(sensorBox(player));
+	for (const TriggerEvent& event : triggers.getEvents()) {
+		if (event.phase == TriggerPhase::STAY)
+			continue;
+		publish(TriggerCrossedEvent{event.trigger, event.type, event.phase});
+		if (event.phase != TriggerPhase::ENTER)
+			continue;
+		switch (event.type) {
+		case TriggerType::GOAL:
+			publish(ReachedGoalEvent{event.trigger, player.getPosition()});
+			break;
+		case TriggerType::CHECKPOINT:
+			publish(CheckpointReachedEvent{event.trigger});
+			break;
+		case TriggerType::KILL:
+			publish(PlayerDiedEvent{DeathCause::KILL_ZONE, player.getPosition()});
+			break;
+		case TriggerType::SCRIPTED: // Left in the event list for whoever owns the script
+			break;
 		}
+	}
+}
 
-		player.sensorUpdate();
+template <typename Vec>
+void Physics::stepTileBodies(std::vector<BasicTileCollider<Vec>>& bodies, const Tilemap& tilemap, float deltaTime,
+							 const CollisionSpace* space) {
+	using S = typename Vec::value_type;
+	const S g = fromFloat<S>(gravity);
+	const S maxFall = fromFloat<S>(-MAX_VELOCITY);
+	// One layout check per call rather than per body: an array is one kind of walker
+	if (space && !bodies.empty() && space->getLayout() != bodies.front().layout) {
+		space = nullptr;
 	}
-	const float groundSnapDist = 0.02f;
 
-	bool isOnGround = false;
-	if (player.tileCollision(tilemap, player.getBottomSensor())) {
+	// Bodies only read the tilemap and write themselves, so chunks can run on any worker;
+	// chunk stats are folded in order, which keeps the totals identical on any core count
+	struct StepStats {
+			int substeps = 0, maxSubsteps = 0, capped = 0;
+	};
+	auto step = [&](int begin, int end) {
+		StepStats chunk;
+		for (int b = begin; b < end; ++b) {
+			auto& body = bodies[b];
+			glm::vec2 position = toFloat(body.position);
+			glm::vec2 projected = (toFloat(body.velocity) + glm::vec2(0.0f, gravity * deltaTime)) * deltaTime;
+			bool capped = false;
+			int substeps = substepCount(projected, capped);
+			if (substeps > 1 && space && space->sweep(position, projected) >= 1.0f) {
+				substeps = 1;
+				capped = false;
+			}
 
-		isOnGround = true;
-		glm::ivec2 tileidx = tilemap.worldToTileIndex(player.getBottomSensor().position);
-		auto tile = tilemap.getTile(tileidx.x, tileidx.y);
-		float tileposy = tile.position.y;
-		float tiletop = tileposy + tilemap.getTileSize();
-		// DEBUG_ONLY(std::cout << "Bottom sensor position: " << player.getBottomSensor().position.x << "\n";
-		// 		   std::cout << "Tile top position: " << tiletop << "\n";);
-		if (player.getBottomSensor().position.y < tiletop) {
-			// If the bottom sensor is above the tile top, snap it to the tile top
-			player.offsetPosition(glm::vec2(0.0f, tiletop - player.getBottomSensor().position.y + EPSILON));
-		}
-	} else {
-		// Probe a bit below the player: is there ground just below?
-		glm::vec2 probe = player.getBottomSensor().position + glm::vec2(0, -groundSnapDist);
-		glm::ivec2 idx = tilemap.worldToTileIndex(probe);
-		if (tilemap.isSolidTile(idx.x, idx.y) && player.getVelocity().y <= 0.1f) {
-			isOnGround = true;
+			// Same integration order as the player: gravity always applies and the ground snap
+			// cancels it, so walking off a ledge starts falling on the next step
+			S subDelta = fromFloat<S>(deltaTime / substeps);
+			for (int i = 0; i < substeps; ++i) {
+				S velY = body.velocity.y + g * subDelta;
+				body.velocity.y = velY < maxFall ? maxFall : velY;
+				body.position += body.velocity * subDelta;
+				resolveTileCollider(tilemap, body, space);
+			}
+
+			chunk.substeps += substeps;
+			chunk.maxSubsteps = std::max(chunk.maxSubsteps, substeps);
+			chunk.capped += capped;
 		}
-	}
-	player.setGrounded(isOnGround);
-	if (isOnGround) {
-		player.setVelocity(glm::vec2(player.getVelocity().x, 0.0f));
-		player.setAcceleration(glm::vec2(player.getAcceleration().x, 0.0f)); // Reset vertical acceleration
-		player.sensorUpdate();
-	}
+		return chunk;
+	};
+	auto combine = [](const StepStats& a, const StepStats& b) {
+		return StepStats{a.substeps + b.substeps, std::max(a.maxSubsteps, b.maxSubsteps), a.capped + b.capped};
+	};
+	int count = static_cast<int>(bodies.size());
+	StepStats total = jobs_ ? jobs_->parallelReduce("tile bodies", count, TILE_BODY_GRAIN, StepStats(), step, combine)
+							: step(0, count);
+	stats_.bodySubsteps = total.substeps;
+	stats_.maxBodySubsteps = total.maxSubsteps;
+	stats_.cappedBodies = total.capped;
 }
 
-void Physics::checkPlayerDeathWallCollision(PlayerObject& player, GameObject& deathWall) {
-	// DeathWall is just a GameObject, so collisions can be checked using AABB
-	if (checkCollision(player.getAABB(), deathWall.getAABB())) {
-		// Call behaviour player collision function
-		auto* behavior = deathWall.getBehavior();
-		behavior->onPlayerCollision(deathWall, player);
+template void Physics::stepTileBodies(std::vector<BasicTileCollider<glm::vec2>>&, const Tilemap&, float, const CollisionSpace*);
+template void Physics::stepTileBodies(std::vector<BasicTileCollider<FixedVec2>>&, const Tilemap&, float, const CollisionSpace*);
+
+void Physics::checkPlayerEntityCollisions(PlayerObject& player, std::vector<GameObject>& entities, const ActivitySet& activity,
+										  BehaviorPools& behaviors) {
+	if (!events_)
+		return; // Contacts only matter for what they publish
+	// The active boxes were refreshed by this frame's activity update
+	touched_.clear();
+	overlapIndices(player.getAABB(), activity.getActiveBoxes(), touched_);
+	for (int slot : touched_) {
+		behaviors.onPlayerCollision(entities, activity.getActive()[slot], player, *events_);
 	}
-}
\ No newline at end of file
+}
@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include "platforms.hpp"
+#include "behavior.hpp"
+
+void PlatformSystem::load(const std::vector<PlatformSpawn>& spawns, float tileSize) {
+	clear();
+	const float T = tileSize;
+	for (const auto& spawn : spawns) {
+		glm::vec2 size(spawn.width * T, PLATFORM_THICKNESS * T);
+		// Top flush with the top of the '=' tiles
+		glm::vec2 position(spawn.tile.x * T + size.x / 2.0f, (spawn.tile.y + 1) * T - size.y / 2.0f);
+		add(position, size, glm::vec2(spawn.travel) * T, PLATFORM_SPEED);
+	}
+}
+
+int PlatformSystem::add(const glm::vec2& position, const glm::vec2& size, const glm::vec2& travel, float speed) {
+	GameObject platform(position, size, 0.0f, glm::vec4(0.55f, 0.4f, 0.25f, 1.0f));
+	platform.setName("Platform");
+	platform.setBehavior(std::make_unique<MovingPlatformBehavior>(platform, speed, travel));
+	objects_.push_back(std::move(platform));
+	state_.emplace_back();
+
+	int index = static_cast<int>(objects_.size()) - 1;
+	state_[index].cells = grid_.cellRange(objects_[index].getAABB());
+	list(index);
+	return index;
+}
+
+void PlatformSystem::clear() {
+	objects_.clear();
+	state_.clear();
+	riderPlatform_.clear();
+	grid_.clear();
+	riddenCount_ = 0;
+}
+
+void PlatformSystem::step(float deltaTime) {
+	for (size_t i = 0; i < objects_.size(); ++i) {
+		GameObject& platform = objects_[i];
+		PlatformState& state = state_[i];
+		glm::vec2 before = platform.getPosition();
+		platform.updateBehavior(deltaTime);
+		state.delta = platform.getPosition() - before;
+
+		// Most steps stay inside the same cells, so the grid is left alone
+		glm::ivec4 cells = grid_.cellRange(platform.getAABB());
+		if (cells != state.cells) {
+			unlist(static_cast<int>(i));
+			state.cells = cells;
+			list(static_cast<int>(i));
+		}
+	}
+}
+
+bool PlatformSystem::settle(int rider, const AABB& box, float prevBottom, float velocityY, float& lift) {
+	lift = 0.0f;
+	if (rider >= static_cast<int>(riderPlatform_.size())) {
+		riderPlatform_.resize(rider + 1, -1);
+	}
+	if (velocityY > 0.0f) {
+		// Moving up (jumping) leaves the platform; tops are one-way so there's nothing to hit
+		detach(rider);
+		return false;
+	}
+
+	// Cached contact first: a rider usually stays on the same platform for many frames
+	int current = riderPlatform_[rider];
+	if (current >= 0) {
+		const AABB& top = objects_[current].getAABB();
+		if (box.right > top.left && box.left < top.right && box.bottom <= top.top + PLATFORM_SNAP &&
+			box.bottom >= top.top - PLATFORM_SINK) {
+			lift = top.top - box.bottom;
+			return true;
+		}
+	}
+
+	// Otherwise land on the highest top the feet crossed this step, coming from above
+	AABB feet = {box.left, box.right, std::max(prevBottom, box.bottom) + PLATFORM_SNAP, box.bottom - PLATFORM_SNAP};
+	int best = -1;
+	float bestTop = 0.0f;
+	grid_.forEach(grid_.cellRange(feet), [&](int index) {
+		const AABB& top = objects_[index].getAABB();
+		float prevTop = top.top - state_[index].delta.y;
+		if (box.right > top.left && box.left < top.right && prevBottom >= prevTop - PLATFORM_SNAP &&
+			box.bottom <= top.top + PLATFORM_SNAP && (best < 0 || top.top > bestTop)) {
+			best = index;
+			bestTop = top.top;
+		}
+	});
+	if (best < 0) {
+		detach(rider);
+		return false;
+	}
+	attach(rider, best);
+	lift = bestTop - box.bottom;
+	return true;
+}
+
+void PlatformSystem::attach(int rider, int platform) {
+	int& current = riderPlatform_[rider];
+	if (current == platform)
+		return;
+	detach(rider);
+	current = platform;
+	if (state_[platform].riders++ == 0) {
+		riddenCount_++;
+	}
+}
+
+void PlatformSystem::detach(int rider) {
+	if (rider >= static_cast<int>(riderPlatform_.size()) || riderPlatform_[rider] < 0)
+		return;
+	int& current = riderPlatform_[rider];
+	if (--state_[current].riders == 0) {
+		riddenCount_--;
+	}
+	current = -1;
+}
+
+void PlatformSystem::list(int platform) { grid_.insert(state_[platform].cells, platform); }
+
+void PlatformSystem::unlist(int platform) {
+	grid_.remove(state_[platform].cells, [platform](int index) { return index == platform; });
+}
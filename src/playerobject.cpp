@@ -80,22 +80,6 @@ int PlayerObject::loadSpriteAtlas(const std::string& atlasDataPath){
 	return 0;
 }
 
-bool PlayerObject::tileGoalCollision(Tilemap& tilemap, const Sensor& sensor) {
-	glm::ivec2 tileIndex = tilemap.worldToTileIndex(sensor.position);
-	bool isGoal = tilemap.isGoalTile(tileIndex.x, tileIndex.y);
-	if (isGoal) {
-		if (goalCount_ < 4)
-			goalCount_++;
-	} else if (goalCount_ > 0) {
-		goalCount_--; // Decrease goal count if the player is not on a goal tile
-	} else if (goalCount_ < 0) {
-		goalCount_ = 0; // Ensure goal count does not go negative
-	} else {
-		goalCount_ = 0; // Reset goal count if the player is not on a goal tile
-	}
-	return isGoal; // Check if the tile at the sensor's position is a goal tile
-}
-
 void PlayerObject::updateMoveState(){
 	auto speedX = abs(getVelocity().x);
 	if(speedX > 0.1f){
@@ -1,6 +1,7 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <cstddef>
 #include "renderer2d.hpp"
 #include "shader.hpp"
 #include "texture.hpp"
@@ -90,6 +91,10 @@ bool Renderer2D::init(Shader& shader) {
 
 	glBindVertexArray(0);
 
+	if (!initBatch()) {
+		return false;
+	}
+
 	// Set up glClearColor
 	glClearColor(0.1f, 0.1f, 0.1f, 1.0f); // Dark grey
 	glEnable(GL_BLEND);
@@ -100,6 +105,44 @@ bool Renderer2D::init(Shader& shader) {
 	return true;
 }
 
+bool Renderer2D::initBatch() {
+	batchVertices_.resize(MAX_VERTICES);
+	// Every quad uses the same two triangles, so the index buffer is filled once
+	batchIndices_.resize(MAX_INDICES);
+	for (uint32_t quad = 0; quad < MAX_QUADS; ++quad) {
+		uint32_t v = quad * 4;
+		uint32_t* idx = &batchIndices_[quad * 6];
+		idx[0] = v + 0;
+		idx[1] = v + 1;
+		idx[2] = v + 2;
+		idx[3] = v + 2;
+		idx[4] = v + 3;
+		idx[5] = v + 0;
+	}
+
+	glGenVertexArrays(1, &batchVAO_);
+	glBindVertexArray(batchVAO_);
+
+	glGenBuffers(1, &batchVBO_);
+	glBindBuffer(GL_ARRAY_BUFFER, batchVBO_);
+	glBufferData(GL_ARRAY_BUFFER, MAX_VERTICES * sizeof(BatchVertex), nullptr, GL_DYNAMIC_DRAW);
+
+	glGenBuffers(1, &batchEBO_);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, batchEBO_);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, MAX_INDICES * sizeof(uint32_t), batchIndices_.data(), GL_STATIC_DRAW);
+
+	// Position at 0 like the other quads; no UVs; per-vertex color at 2
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(BatchVertex), (void*)offsetof(BatchVertex, position));
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(BatchVertex), (void*)offsetof(BatchVertex, color));
+	glEnableVertexAttribArray(2);
+
+	glBindVertexArray(0);
+	vertexCount_ = 0;
+	indexCount_ = 0;
+	return true;
+}
+
 bool Renderer2D::initLine(Shader& shader) {
 	// Shader object is passed in, use directly
 	if (!shader.getID()) {
@@ -149,6 +192,12 @@ void Renderer2D::shutdown() {
 		glDeleteBuffers(1, &ebo_);
 		ebo_ = 0;
 	}
+	if (batchVAO_) {
+		glDeleteVertexArrays(1, &batchVAO_);
+		glDeleteBuffers(1, &batchVBO_);
+		glDeleteBuffers(1, &batchEBO_);
+		batchVAO_ = batchVBO_ = batchEBO_ = 0;
+	}
 	shaderLoaded_ = false;
 	shader_ = 0;
 
@@ -164,6 +213,7 @@ void Renderer2D::beginScene(Shader& shader, const glm::mat4& view, const glm::ma
 	// Save view and proj matrices
 	view_ = view;
 	proj_ = proj;
+	viewProj_ = proj * view;
 	// Set the model matrix to identity for now
 	model_ = IDENTITY_MATRIX;
 
@@ -171,40 +221,132 @@ void Renderer2D::beginScene(Shader& shader, const glm::mat4& view, const glm::ma
 	glBindVertexArray(vao_);
 }
 
-void Renderer2D::drawQuad(Shader& shader, const glm::mat4& transform, const glm::vec4& color) {
+void Renderer2D::drawWithMVP(Shader& shader, const glm::mat4& mvp, const glm::vec4& color, Texture* texture) {
 	// Ensure quad VAO is bound (other renderers may have changed it)
 	glBindVertexArray(vao_);
-	model_ = transform;
-
-	glm::mat4 mvp = proj_ * view_ * model_;
 
 	shader.setMat4("MVP", mvp);
 	shader.setVec4("color", color); // Set the color uniform
 
-	shader.setInt("useTexture", 0);
-	shader.setInt("slot", 0);
+	if (texture) {
+		texture->bind(texture->getSlot());
+		shader.setInt("useTexture", 1);
+		shader.setInt("slot", texture->getSlot());
+	} else {
+		shader.setInt("useTexture", 0);
+		shader.setInt("slot", 0);
+	}
 
-	// Draw the quad using the EBO, VAO already bound in beginScene
+	// Draw the quad using the EBO
 	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
 }
 
-void Renderer2D::drawTexturedQuad(Shader& shader, const glm::mat4& transform, const glm::vec4& color, Texture *texture) {
-	// Ensure quad VAO is bound
-	glBindVertexArray(vao_);
+void Renderer2D::drawQuad(Shader& shader, const glm::mat4& transform, const glm::vec4& color) {
+	model_ = transform;
+	drawWithMVP(shader, viewProj_ * model_, color, nullptr);
+}
 
+void Renderer2D::drawQuad(Shader& shader, const Transform2D& transform, const glm::vec4& color) {
+	drawWithMVP(shader, mulAffine(viewProj_, transform), color, nullptr);
+}
+
+void Renderer2D::drawTexturedQuad(Shader& shader, const glm::mat4& transform, const glm::vec4& color, Texture *texture) {
 	model_ = transform;
+	drawWithMVP(shader, viewProj_ * model_, color, texture);
+}
 
-	glm::mat4 mvp = proj_ * view_ * model_;
+void Renderer2D::drawTexturedQuad(Shader& shader, const Transform2D& transform, const glm::vec4& color, Texture* texture) {
+	drawWithMVP(shader, mulAffine(viewProj_, transform), color, texture);
+}
 
-	// Bind and configure texture
-	texture->bind(texture->getSlot()); // Bind to texture unit 0
+void Renderer2D::addQuadtoBatch(Shader& shader, const Transform2D& transform, const glm::vec4& color) {
+	if (vertexCount_ + 4 > MAX_VERTICES) {
+		flushBatch(shader);
+	}
+	// Corners straight from the affine; the GPU only sees view-projection
+	glm::vec2 corners[4];
+	transform.quadCorners(corners);
+	BatchVertex* v = &batchVertices_[vertexCount_];
+	for (int i = 0; i < 4; ++i) {
+		v[i].position = corners[i];
+		v[i].color = color;
+	}
+	vertexCount_ += 4;
+	indexCount_ += 6;
+}
 
-	shader.setMat4("MVP", mvp);
-	shader.setVec4("color", color);
-	shader.setInt("useTexture", 1);
-	shader.setInt("slot", texture->getSlot());
+void Renderer2D::flushBatch(Shader& shader) {
+	if (vertexCount_ == 0)
+		return;
+	glBindVertexArray(batchVAO_);
+	glBindBuffer(GL_ARRAY_BUFFER, batchVBO_);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, vertexCount_ * sizeof(BatchVertex), batchVertices_.data());
 
-	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+	shader.setMat4("MVP", viewProj_);
+	shader.setInt("useTexture", 0);
+	shader.setInt("useVertexColor", 1);
+	glDrawElements(GL_TRIANGLES, indexCount_, GL_UNSIGNED_INT, 0);
+	shader.setInt("useVertexColor", 0);
+
+	vertexCount_ = 0;
+	indexCount_ = 0;
+	glBindVertexArray(vao_);
+}
+
+static_assert(Renderer2D::MAX_STATIC_QUADS <= 10000, "Static quads index the batch index buffer");
+
+bool Renderer2D::uploadStaticQuads(StaticQuads& quads, const StaticVertex* vertices, uint32_t quadCount) {
+	if (quadCount > MAX_STATIC_QUADS || batchEBO_ == 0) {
+		std::cerr << "[Renderer2D] Can't upload " << quadCount << " static quads." << std::endl;
+		return false;
+	}
+	if (quads.vao == 0) {
+		glGenVertexArrays(1, &quads.vao);
+		glGenBuffers(1, &quads.vbo);
+		glBindVertexArray(quads.vao);
+		glBindBuffer(GL_ARRAY_BUFFER, quads.vbo);
+		// The batch index buffer already holds the two triangles of every quad slot
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, batchEBO_);
+		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(StaticVertex), (void*)offsetof(StaticVertex, position));
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(StaticVertex), (void*)offsetof(StaticVertex, uv));
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(StaticVertex), (void*)offsetof(StaticVertex, color));
+		glEnableVertexAttribArray(2);
+	} else {
+		glBindVertexArray(quads.vao);
+		glBindBuffer(GL_ARRAY_BUFFER, quads.vbo);
+	}
+	glBufferData(GL_ARRAY_BUFFER, quadCount * 4 * sizeof(StaticVertex), vertices, GL_STATIC_DRAW);
+	quads.quads = quadCount;
+	glBindVertexArray(vao_);
+	return true;
+}
+
+void Renderer2D::drawStaticQuads(Shader& shader, const StaticQuads& quads, uint32_t first, uint32_t count, Texture* texture) {
+	if (quads.vao == 0 || count == 0)
+		return;
+	glBindVertexArray(quads.vao);
+	shader.setMat4("MVP", viewProj_);
+	if (texture) {
+		texture->bind(texture->getSlot());
+		shader.setInt("useTexture", 1);
+		shader.setInt("slot", texture->getSlot());
+	} else {
+		shader.setInt("useTexture", 0);
+		shader.setInt("useVertexColor", 1);
+	}
+	glDrawElements(GL_TRIANGLES, count * 6, GL_UNSIGNED_INT, (void*)(static_cast<size_t>(first) * 6 * sizeof(uint32_t)));
+	shader.setInt("useVertexColor", 0);
+	glBindVertexArray(vao_);
+}
+
+void Renderer2D::releaseStaticQuads(StaticQuads& quads) {
+	if (quads.vao) {
+		glDeleteVertexArrays(1, &quads.vao);
+		glDeleteBuffers(1, &quads.vbo);
+	}
+	quads = StaticQuads();
 }
 
 void Renderer2D::setPlayerUVRect(const glm::vec2& uvMin, const glm::vec2& uvMax, float yOffset) {
@@ -227,12 +369,11 @@ void Renderer2D::setPlayerUVRect(const glm::vec2& uvMin, const glm::vec2& uvMax,
 	glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(playerVertices), playerVertices);
 }
 
-void Renderer2D::drawPlayer(Shader& shader, const glm::mat4& transform, const glm::vec4& color, Texture* texture) {
+void Renderer2D::drawPlayer(Shader& shader, const Transform2D& transform, const glm::vec4& color, Texture* texture) {
 	// Bind player VAO to use dynamic VBO UVs
 	glBindVertexArray(playerVAO_);
 
-	model_ = transform;
-	glm::mat4 mvp = proj_ * view_ * model_;
+	glm::mat4 mvp = mulAffine(viewProj_, transform);
 
 	texture->bind(texture->getSlot());
 	shader.setMat4("MVP", mvp);
@@ -254,8 +395,7 @@ void Renderer2D::drawLine(Shader& shader, const glm::vec2& start, const glm::vec
 
 	shader.use();
 
-	glm::mat4 mvp = proj_ * view_ * glm::mat4(1.0f);
-	shader.setMat4("MVP", mvp);
+	shader.setMat4("MVP", viewProj_);
 
 	// Set the color uniform
 	shader.setVec4("color", color);
@@ -0,0 +1,254 @@
+#include <algorithm>
+#include <iostream>
+#include "scenegraph.hpp"
+
+SceneNode SceneGraph::create(const Transform2D& local, SceneNode parent) {
+	int parentIndex = -1;
+	if (parent != NO_NODE) {
+		if (!contains(parent)) {
+			std::cerr << "SceneGraph: parent " << parent << " doesn't exist, creating a root instead" << std::endl;
+		} else {
+			parentIndex = indexOf_[parent];
+		}
+	}
+
+	SceneNode id;
+	if (!freeIds_.empty()) {
+		id = freeIds_.back();
+		freeIds_.pop_back();
+	} else {
+		id = static_cast<SceneNode>(indexOf_.size());
+		indexOf_.push_back(-1);
+	}
+	Block block;
+	block.ids = {id};
+	block.parent = {-1};
+	block.subtree = {1};
+	block.local = {local};
+	block.world = {local};
+	block.dirty = {0};
+	insertBlock(block, parentIndex);
+	markDirty(indexOf_[id]);
+	return id;
+}
+
+void SceneGraph::destroy(SceneNode node) {
+	if (!contains(node))
+		return;
+	Block block = takeBlock(indexOf_[node]);
+	for (SceneNode id : block.ids) {
+		indexOf_[id] = -1;
+		freeIds_.push_back(id);
+	}
+	auto gone = [this](const Binding& b) { return !contains(b.node); };
+	drivers_.erase(std::remove_if(drivers_.begin(), drivers_.end(), gone), drivers_.end());
+	followers_.erase(std::remove_if(followers_.begin(), followers_.end(), gone), followers_.end());
+}
+
+bool SceneGraph::setParent(SceneNode node, SceneNode parent) {
+	if (!contains(node) || (parent != NO_NODE && !contains(parent)))
+		return false;
+	int index = indexOf_[node];
+	if (parent != NO_NODE) {
+		int parentIndex = indexOf_[parent];
+		if (parentIndex >= index && parentIndex < index + subtree_[index]) {
+			std::cerr << "SceneGraph: can't parent node " << node << " under its own subtree" << std::endl;
+			return false;
+		}
+	}
+	Block block = takeBlock(index);
+	// Positions shifted when the block came out, so look the parent up again
+	insertBlock(block, parent != NO_NODE ? indexOf_[parent] : -1);
+	markDirty(indexOf_[node]);
+	return true;
+}
+
+void SceneGraph::clear() {
+	ids_.clear();
+	parent_.clear();
+	subtree_.clear();
+	local_.clear();
+	world_.clear();
+	dirty_.clear();
+	updatedAt_.clear();
+	indexOf_.clear();
+	freeIds_.clear();
+	dirtyNodes_.clear();
+	changed_.clear();
+	drivers_.clear();
+	followers_.clear();
+	updatedCount_ = 0;
+}
+
+void SceneGraph::setLocal(SceneNode node, const Transform2D& local) {
+	int index = indexOf_[node];
+	local_[index] = local;
+	markDirty(index);
+}
+
+void SceneGraph::markDirty(int index) {
+	if (!dirty_[index]) {
+		dirty_[index] = 1;
+		dirtyNodes_.push_back(ids_[index]);
+	}
+}
+
+SceneGraph::Block SceneGraph::takeBlock(int begin) {
+	int count = subtree_[begin];
+	int end = begin + count;
+	Block block;
+	block.ids.assign(ids_.begin() + begin, ids_.begin() + end);
+	block.parent.assign(parent_.begin() + begin, parent_.begin() + end);
+	block.subtree.assign(subtree_.begin() + begin, subtree_.begin() + end);
+	block.local.assign(local_.begin() + begin, local_.begin() + end);
+	block.world.assign(world_.begin() + begin, world_.begin() + end);
+	block.dirty.assign(dirty_.begin() + begin, dirty_.begin() + end);
+	block.parent[0] = -1;
+	for (int i = 1; i < count; ++i) {
+		block.parent[i] -= begin;
+	}
+
+	for (int a = parent_[begin]; a >= 0; a = parent_[a]) {
+		subtree_[a] -= count;
+	}
+	ids_.erase(ids_.begin() + begin, ids_.begin() + end);
+	parent_.erase(parent_.begin() + begin, parent_.begin() + end);
+	subtree_.erase(subtree_.begin() + begin, subtree_.begin() + end);
+	local_.erase(local_.begin() + begin, local_.begin() + end);
+	world_.erase(world_.begin() + begin, world_.begin() + end);
+	dirty_.erase(dirty_.begin() + begin, dirty_.begin() + end);
+	updatedAt_.erase(updatedAt_.begin() + begin, updatedAt_.begin() + end);
+	for (size_t i = begin; i < parent_.size(); ++i) {
+		if (parent_[i] >= end) {
+			parent_[i] -= count;
+		}
+	}
+	reindex(begin);
+	changed_.clear(); // Positions moved under the last update's ranges
+	return block;
+}
+
+void SceneGraph::insertBlock(Block& block, int parent) {
+	int count = static_cast<int>(block.ids.size());
+	int at = parent >= 0 ? parent + subtree_[parent] : static_cast<int>(ids_.size());
+
+	// Existing nodes after the insertion point shift down; so do links to them
+	for (size_t i = at; i < parent_.size(); ++i) {
+		if (parent_[i] >= at) {
+			parent_[i] += count;
+		}
+	}
+	block.parent[0] = parent - at; // Made absolute below
+	for (int i = 0; i < count; ++i) {
+		block.parent[i] += at;
+	}
+	ids_.insert(ids_.begin() + at, block.ids.begin(), block.ids.end());
+	parent_.insert(parent_.begin() + at, block.parent.begin(), block.parent.end());
+	subtree_.insert(subtree_.begin() + at, block.subtree.begin(), block.subtree.end());
+	local_.insert(local_.begin() + at, block.local.begin(), block.local.end());
+	world_.insert(world_.begin() + at, block.world.begin(), block.world.end());
+	dirty_.insert(dirty_.begin() + at, block.dirty.begin(), block.dirty.end());
+	updatedAt_.insert(updatedAt_.begin() + at, count, 0);
+	for (int a = parent; a >= 0; a = parent_[a]) {
+		subtree_[a] += count;
+	}
+	reindex(at);
+	changed_.clear();
+}
+
+void SceneGraph::reindex(int from) {
+	for (size_t i = from; i < ids_.size(); ++i) {
+		indexOf_[ids_[i]] = static_cast<int>(i);
+	}
+}
+
+void SceneGraph::update() {
+	updates_++;
+	changed_.clear();
+	updatedCount_ = 0;
+	if (dirtyNodes_.empty())
+		return;
+
+	scratch_.clear();
+	for (SceneNode id : dirtyNodes_) {
+		if (contains(id) && dirty_[indexOf_[id]]) {
+			scratch_.push_back(indexOf_[id]);
+		}
+	}
+	dirtyNodes_.clear();
+	std::sort(scratch_.begin(), scratch_.end());
+
+	// A dirty node's whole subtree is the contiguous range after it; dirty nodes inside a
+	// range already being redone are covered by it. Parents come first, so each world
+	// transform only needs its parent's, which is already current.
+	int covered = 0;
+	for (int begin : scratch_) {
+		if (begin < covered)
+			continue;
+		int end = begin + subtree_[begin];
+		changed_.push_back({begin, end});
+		updatedCount_ += end - begin;
+		covered = end;
+	}
+
+	// A range's root has a parent outside every range (or none), so ranges don't read
+	// each other's results and can be recomputed in any order
+	auto recompute = [this](int first, int last) {
+		for (int r = first; r < last; ++r) {
+			for (int i = changed_[r].begin; i < changed_[r].end; ++i) {
+				int parent = parent_[i];
+				world_[i] = parent >= 0 ? world_[parent] * local_[i] : local_[i];
+				dirty_[i] = 0;
+				updatedAt_[i] = updates_;
+			}
+		}
+	};
+	int ranges = static_cast<int>(changed_.size());
+	if (jobs_ && updatedCount_ >= SCENE_PARALLEL_MIN) {
+		jobs_->parallelFor("scene graph", ranges, std::max(1, ranges / (4 * jobs_->getThreadCount())), recompute);
+	} else {
+		recompute(0, ranges);
+	}
+}
+
+void SceneGraph::bindDriver(SceneNode node, ObjectHandle object) {
+	if (contains(node)) {
+		drivers_.push_back({node, object, UINT32_MAX});
+	}
+}
+
+void SceneGraph::bindFollower(SceneNode node, ObjectHandle object) {
+	if (contains(node)) {
+		followers_.push_back({node, object, 0});
+	}
+}
+
+void SceneGraph::pullDrivers(const std::vector<GameObject>& objects, const ObjectRegistry& registry) {
+	for (Binding& driver : drivers_) {
+		int index = registry.indexOf(driver.object);
+		if (index < 0)
+			continue;
+		const GameObject& obj = objects[index];
+		if (obj.getTransformVersion() == driver.version)
+			continue;
+		driver.version = obj.getTransformVersion();
+		setLocal(driver.node, Transform2D::fromTRS(obj.getPosition(), obj.getRotation(), glm::vec2(1.0f)));
+	}
+}
+
+void SceneGraph::pushFollowers(std::vector<GameObject>& objects, const ObjectRegistry& registry) const {
+	for (const Binding& follower : followers_) {
+		int node = indexOf_[follower.node];
+		if (updatedAt_[node] != updates_)
+			continue; // World transform didn't change
+		GameObject* obj = registry.resolve(objects, follower.object);
+		if (!obj)
+			continue;
+		glm::vec2 position, scale;
+		float rotation;
+		world_[node].decompose(position, rotation, scale);
+		obj->setPosition(position);
+		obj->setRotation(rotation);
+		obj->setScale(scale);
+	}
+}
@@ -0,0 +1,38 @@
+#include <chrono>
+#include "simthread.hpp"
+
+// Steps owed after a hitch are dropped beyond this, so a long stall doesn't turn into a
+// burst of catch-up steps
+const int MAX_CATCHUP_STEPS = 4;
+
+void SimulationThread::start(float stepSeconds, std::function<bool(float)> step) {
+	stop();
+	step_ = std::move(step);
+	stepSeconds_ = stepSeconds;
+	running_.store(true, std::memory_order_release);
+	thread_ = std::thread([this] { run(); });
+}
+
+void SimulationThread::stop() {
+	running_.store(false, std::memory_order_release);
+	if (thread_.joinable())
+		thread_.join();
+}
+
+void SimulationThread::run() {
+	using Clock = std::chrono::steady_clock;
+	const auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(stepSeconds_));
+	auto next = Clock::now();
+	while (running_.load(std::memory_order_acquire)) {
+		if (!step_(stepSeconds_)) {
+			running_.store(false, std::memory_order_release);
+			break;
+		}
+		steps_.fetch_add(1, std::memory_order_relaxed);
+		next += period;
+		auto now = Clock::now();
+		if (now - next > period * MAX_CATCHUP_STEPS)
+			next = now;
+		std::this_thread::sleep_until(next);
+	}
+}
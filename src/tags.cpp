@@ -0,0 +1,39 @@
+#include <unordered_map>
+#include <vector>
+#include "tags.hpp"
+
+namespace {
+
+struct TagTable {
+		std::unordered_map<std::string, TagId> ids = {{"", NO_TAG}};
+		std::vector<std::string> names = {""};
+};
+
+TagTable& table() {
+	static TagTable tags;
+	return tags;
+}
+
+} // namespace
+
+TagId internTag(const std::string& name) {
+	TagTable& tags = table();
+	auto it = tags.ids.find(name);
+	if (it != tags.ids.end())
+		return it->second;
+	TagId id = static_cast<TagId>(tags.names.size());
+	tags.ids.emplace(name, id);
+	tags.names.push_back(name);
+	return id;
+}
+
+TagId findTag(const std::string& name) {
+	const TagTable& tags = table();
+	auto it = tags.ids.find(name);
+	return it != tags.ids.end() ? it->second : NO_TAG;
+}
+
+const std::string& tagName(TagId tag) {
+	const TagTable& tags = table();
+	return tag < tags.names.size() ? tags.names[tag] : tags.names[NO_TAG];
+}
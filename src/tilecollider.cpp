@@ -0,0 +1,187 @@
+#include <algorithm>
+#include "tilecollider.hpp"
+#include "collisionspace.hpp"
+#include "globals.hpp"
+#include "tileworld.hpp"
+
+namespace {
+
+// If the tile at idx is solid, moves idx along dir to the exposed face of its solid run
+// and returns true. Snapping to an internal face would leave the sensor inside the
+// neighbouring tile. A streamed TileWorld has no rects, so this walks tile by tile.
+template <typename Grid>
+bool exposedTile(const Grid& tilemap, glm::ivec2& idx, glm::ivec2 dir, uint8_t face) {
+	if (!tilemap.isSolidTile(idx.x, idx.y))
+		return false;
+	while (!(tilemap.getEdgeMask(idx.x, idx.y) & face)) {
+		idx += dir;
+	}
+	return true;
+}
+
+// Tilemap: a tile past the surface jumps straight to the far side of the merged rect under
+// it. No face inside a rect is exposed, so only where it meets another rect does the walk
+// carry on. Sensors are mostly clear or just past the surface and never get this far.
+glm::ivec2 hopRects(const Tilemap& tilemap, glm::ivec2 idx, glm::ivec2 dir, uint8_t face) {
+	const CollisionRect* rect = tilemap.getCollisionRectAt(idx.x, idx.y);
+	while (rect) {
+		if (dir.x != 0)
+			idx.x = dir.x > 0 ? rect->x1 : rect->x0;
+		else
+			idx.y = dir.y > 0 ? rect->y1 : rect->y0;
+		if (tilemap.getEdgeMask(idx.x, idx.y) & face)
+			break;
+		idx += dir; // Into the next rect along
+		rect = tilemap.getCollisionRectAt(idx.x, idx.y);
+	}
+	return idx;
+}
+
+bool exposedTile(const Tilemap& tilemap, glm::ivec2& idx, glm::ivec2 dir, uint8_t face) {
+	if (!tilemap.isSolidTile(idx.x, idx.y))
+		return false;
+	if (!(tilemap.getEdgeMask(idx.x, idx.y) & face))
+		idx = hopRects(tilemap, idx, dir, face);
+	return true;
+}
+
+// Sides are addressed as (Axis, Dir): Axis 0 is x, 1 is y; Dir -1 is left/bottom, +1 is
+// right/top. Everything below is instantiated per side, so the axis and direction
+// selects fold away instead of branching per sensor.
+template <int Axis>
+int sensorCount(const SensorLayout& layout) {
+	return Axis == 0 ? layout.sideCount : layout.footCount;
+}
+
+template <int Axis, int Dir, typename Vec>
+Vec sensorPosition(const BasicTileCollider<Vec>& collider, int i) {
+	using S = typename Vec::value_type;
+	const SensorLayout& layout = collider.layout;
+	if (Axis == 0) {
+		return collider.position + Vec(fromFloat<S>(Dir * layout.extents.x), fromFloat<S>(layout.sideOffsets[i]));
+	}
+	return collider.position + Vec(fromFloat<S>(layout.footOffsets[i]), fromFloat<S>(Dir * layout.extents.y));
+}
+
+// Snaps the collider out along Axis by the deepest sensor on this side
+template <int Axis, int Dir, typename Grid, typename Vec>
+bool resolveSide(const Grid& tilemap, BasicTileCollider<Vec>& collider) {
+	using S = typename Vec::value_type;
+	// Face of the solid run a sensor on this side runs into, and the walk back towards the collider
+	const uint8_t face = Axis == 0 ? (Dir < 0 ? EDGE_RIGHT : EDGE_LEFT) : (Dir < 0 ? EDGE_TOP : EDGE_BOTTOM);
+	glm::ivec2 back(0);
+	back[Axis] = -Dir;
+	const typename TileGrid<S>::Size T(tilemap.getTileSize());
+	const S zero = fromFloat<S>(0.0f);
+
+	bool hit = false;
+	S depth = zero;
+	for (int i = 0; i < sensorCount<Axis>(collider.layout); ++i) {
+		Vec sensor = sensorPosition<Axis, Dir>(collider, i);
+		glm::ivec2 idx(tileCoord(sensor.x, T), tileCoord(sensor.y, T));
+		if (!exposedTile(tilemap, idx, back, face))
+			continue;
+		hit = true;
+		// Tile position is bottom left corner, so the far face is one tile further along
+		S edge = tileStart(idx[Axis] + (Dir < 0 ? 1 : 0), T);
+		S penetration = Dir < 0 ? edge - sensor[Axis] : sensor[Axis] - edge;
+		if (penetration > depth) {
+			depth = penetration;
+		}
+	}
+	if (!hit)
+		return false;
+
+	collider.velocity[Axis] = zero;
+	if (depth > zero) {
+		S push = depth + fromFloat<S>(EPSILON);
+		if (Dir < 0) {
+			collider.position[Axis] += push;
+		} else {
+			collider.position[Axis] -= push;
+		}
+	}
+	return true;
+}
+
+// Is there ground within snapDist below the foot sensor?
+template <typename Grid>
+bool groundBelow(const Grid& tilemap, const glm::vec2& foot, float snapDist) {
+	return tilemap.raycast(foot, glm::vec2(0.0f, -1.0f), snapDist).hit;
+}
+template <typename Grid>
+bool groundBelow(const Grid& tilemap, const FixedVec2& foot, float snapDist) {
+	// The probe is vertical and shorter than a tile, so it can only cross into the tile
+	// below; testing the probe's end point in fixed point keeps the result deterministic
+	const FixedTileSize T(tilemap.getTileSize());
+	int x = tileCoord(foot.x, T);
+	return tilemap.isSolidTile(x, tileCoord(foot.y, T)) || tilemap.isSolidTile(x, tileCoord(foot.y - Fixed::fromFloat(snapDist), T));
+}
+
+} // namespace
+
+bool SensorLayout::operator==(const SensorLayout& other) const {
+	if (extents != other.extents || sideCount != other.sideCount || footCount != other.footCount ||
+		groundSnapDist != other.groundSnapDist)
+		return false;
+	return std::equal(sideOffsets, sideOffsets + sideCount, other.sideOffsets) &&
+		   std::equal(footOffsets, footOffsets + footCount, other.footOffsets);
+}
+
+template <typename Grid, typename Vec>
+void resolveTileCollider(const Grid& tilemap, BasicTileCollider<Vec>& collider, const CollisionSpace* space) {
+	using S = typename Vec::value_type;
+	const S zero = fromFloat<S>(0.0f);
+	collider.contacts = 0;
+
+	// Configuration-space fast path: a free cell means no sensor can be inside a solid tile.
+	// The c-space is padded well beyond fixed-point rounding, so this never changes results.
+	// A body that was grounded last step is resting against a tile and can't be in a free
+	// cell, so walkers skip the lookup altogether.
+	bool nearSolid = collider.grounded || !(space && space->isFree(toFloat(collider.position)));
+	if (nearSolid) {
+		// Moving left doesn't need the right sensors and vice versa; at rest, check both
+		S velX = collider.velocity.x;
+		if (velX <= zero && resolveSide<0, -1>(tilemap, collider))
+			collider.contacts |= CONTACT_LEFT;
+		if (velX >= zero && resolveSide<0, 1>(tilemap, collider))
+			collider.contacts |= CONTACT_RIGHT;
+		if (resolveSide<1, 1>(tilemap, collider))
+			collider.contacts |= CONTACT_TOP;
+		if (resolveSide<1, -1>(tilemap, collider))
+			collider.contacts |= CONTACT_BOTTOM;
+	}
+
+	collider.grounded = (collider.contacts & CONTACT_BOTTOM) != 0;
+	if (!collider.grounded && collider.velocity.y <= fromFloat<S>(0.1f)) {
+		// Probe a bit below the feet: is there ground just below?
+		for (int i = 0; i < collider.layout.footCount; ++i) {
+			if (groundBelow(tilemap, sensorPosition<1, -1>(collider, i), collider.layout.groundSnapDist)) {
+				collider.grounded = true;
+				break;
+			}
+		}
+	}
+	if (collider.grounded) {
+		collider.velocity.y = zero;
+	}
+}
+
+template <typename Vec>
+void resolveTileColliders(const Tilemap& tilemap, std::vector<BasicTileCollider<Vec>>& colliders, const CollisionSpace* space) {
+	// Checked once for the array rather than per collider, like Physics::stepTileBodies
+	if (space && !colliders.empty() && space->getLayout() != colliders.front().layout) {
+		space = nullptr;
+	}
+	for (auto& collider : colliders) {
+		resolveTileCollider(tilemap, collider, space);
+	}
+}
+
+// Both variants are always built so float and fixed-point runs can be compared side by side
+template void resolveTileCollider(const Tilemap&, BasicTileCollider<glm::vec2>&, const CollisionSpace*);
+template void resolveTileCollider(const Tilemap&, BasicTileCollider<FixedVec2>&, const CollisionSpace*);
+// Only the player moves through streamed levels
+template void resolveTileCollider(const TileWorld&, BasicTileCollider<PhysVec2>&, const CollisionSpace*);
+template void resolveTileColliders(const Tilemap&, std::vector<BasicTileCollider<glm::vec2>>&, const CollisionSpace*);
+template void resolveTileColliders(const Tilemap&, std::vector<BasicTileCollider<FixedVec2>>&, const CollisionSpace*);
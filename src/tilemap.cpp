@@ -1,52 +1,361 @@
 #include "tilemap.hpp"
 #include "debug.hpp"
+#include "tiletraversal.hpp"
+#include <algorithm>
+
+static uint32_t nextTilemapId() {
+	// Maps are built on LevelLoader job threads too
+	static std::atomic<uint32_t> nextId{1};
+	return nextId.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Palette index 0, and whatever unused entries hold
+static const TilePaletteEntry EMPTY_ENTRY = {{TileEnum::EMPTY, false, false, glm::vec4(0.0f)}, TileSkin::NONE};
 
 Tilemap::Tilemap(int width, int height, float tileSize) : width_(width), height_(height), tileSize_(tileSize) {
+	id_ = nextTilemapId();
 
-	tiles_.resize(height_, std::vector<Tile>(width_));
-	for (int y = 0; y < height_; ++y) {
-		for (int x = 0; x < width_; ++x) {
-			// Initialize empty
-			tiles_[y][x].position = tileIndexToWorldPos(x, y);
-			tiles_[y][x].tileType = {TileEnum::EMPTY, false, false, glm::vec4(0.0f)};
-		}
-	}
+	// Zeroed, so every tile starts as palette entry 0: empty
+	storage_.assign(storageBytes(width_, height_) / sizeof(uint64_t), 0);
+	bindStorage(reinterpret_cast<uint8_t*>(storage_.data()));
+	palette_.fill(EMPTY_ENTRY);
+	paletteCount_ = 1;
+	rowRects_.resize(height_);
 }
 
-Tile& Tilemap::getTile(int x, int y) { return tiles_[y][x]; }
+Tilemap::Tilemap(int width, int height, float tileSize, std::unique_ptr<MappedFile> file, size_t offset,
+				 const std::vector<TilePaletteEntry>& palette, std::vector<CollisionRect> collisionRects)
+	: file_(std::move(file)), width_(width), height_(height), tileSize_(tileSize) {
+	id_ = nextTilemapId();
 
-bool Tilemap::isSolidTile(int x, int y) {
-	if (x < 0 || x >= width_ || y < 0 || y >= height_)
-		return false;
-	return tiles_[y][x].tileType.type == TileEnum::SOLID ||
-		   tiles_[y][x].tileType.solid == true;
+	// The caller checked the file holds storageBytes() from offset
+	bindStorage(file_->getData() + offset);
+	palette_.fill(EMPTY_ENTRY);
+	paletteCount_ = std::min(static_cast<int>(palette.size()), MAX_PALETTE);
+	std::copy(palette.begin(), palette.begin() + paletteCount_, palette_.begin());
+	collisionRects_ = std::move(collisionRects);
+	indexRects();
+}
+
+size_t Tilemap::storageBytes(int width, int height) {
+	// Each grid rounded up to whole words so the masks after the byte grids stay aligned
+	size_t maskBytes = static_cast<size_t>((width + 63) / 64) * height * sizeof(uint64_t);
+	size_t gridBytes = (static_cast<size_t>(width) * height + 7) & ~size_t(7);
+	return 3 * maskBytes + 2 * gridBytes;
+}
+
+void Tilemap::bindStorage(uint8_t* base) {
+	maskWords_ = (width_ + 63) / 64;
+	size_t maskWordCount = static_cast<size_t>(maskWords_) * height_;
+	solidMask_ = reinterpret_cast<uint64_t*>(base);
+	goalMask_ = solidMask_ + maskWordCount;
+	hazardMask_ = goalMask_ + maskWordCount;
+	edgeMask_ = reinterpret_cast<uint8_t*>(hazardMask_ + maskWordCount);
+	tiles_ = edgeMask_ + ((static_cast<size_t>(width_) * height_ + 7) & ~size_t(7));
+}
+
+Tile Tilemap::getTile(int x, int y) const {
+	const TilePaletteEntry& entry = palette_[tileAt(x, y)];
+	Texture* texture = entry.skin == TileSkin::FLOOR ? floorTex_ : (entry.skin == TileSkin::WALL ? wallTex_ : nullptr);
+	return {tileIndexToWorldPos(x, y), entry.tileType, texture};
+}
+
+int Tilemap::paletteIndex(const TileType& tileType, TileSkin skin) {
+	for (int i = 0; i < paletteCount_; ++i) {
+		const TilePaletteEntry& entry = palette_[i];
+		if (entry.skin == skin && entry.tileType.type == tileType.type && entry.tileType.visible == tileType.visible &&
+			entry.tileType.solid == tileType.solid && entry.tileType.color == tileType.color)
+			return i;
+	}
+	if (paletteCount_ == MAX_PALETTE)
+		return -1;
+	palette_[paletteCount_] = {tileType, skin};
+	return paletteCount_++;
 }
 
-bool Tilemap::isGoalTile(int x, int y) {
+void Tilemap::setTile(int x, int y, const TileType& tileType, TileSkin skin) {
 	if (x < 0 || x >= width_ || y < 0 || y >= height_)
+		return;
+	int index = paletteIndex(tileType, skin);
+	if (index < 0) {
+		std::cerr << "[Tilemap] More than " << MAX_PALETTE << " distinct tile types, tile not set" << std::endl;
+		return;
+	}
+	tiles_[static_cast<size_t>(y) * width_ + x] = static_cast<uint8_t>(index);
+
+	// Keep the collision masks in sync with the tile type
+	size_t word = static_cast<size_t>(y) * maskWords_ + (x >> 6);
+	int bit = x & 63;
+	bool wasSolid = isSolidTile(x, y);
+	bool solid = isSolidType(tileType);
+	writeMask(solidMask_, word, bit, solid);
+	writeMask(goalMask_, word, bit, tileType.type == TileEnum::GOAL);
+	writeMask(hazardMask_, word, bit, tileType.type == TileEnum::HAZARD);
+
+	// This tile's faces and the facing edges of its four neighbours may have changed
+	updateEdgeMask(x, y);
+	updateEdgeMask(x - 1, y);
+	updateEdgeMask(x + 1, y);
+	updateEdgeMask(x, y - 1);
+	updateEdgeMask(x, y + 1);
+
+	// Rects cover exactly the solid tiles: clearing one splits its rect into what's left,
+	// a new one extends the rect just left of it if that's a single row (how rows come
+	// in while loading), or else gets a rect of its own
+	if (wasSolid && !solid) {
+		int rectIndex = rectIndexAt(x, y);
+		if (rectIndex >= 0) {
+			CollisionRect rect = collisionRects_[rectIndex];
+			removeRect(rectIndex);
+			size_t first = collisionRects_.size();
+			mergeSolidTiles(rect.x0, rect.y0, rect.x1, rect.y1);
+			for (size_t i = first; i < collisionRects_.size(); ++i)
+				indexRect(static_cast<int>(i));
+		}
+	} else if (solid && !wasSolid) {
+		int left = rectIndexAt(x - 1, y);
+		if (left >= 0 && collisionRects_[left].y0 == y && collisionRects_[left].y1 == y)
+			extendRect(left, x);
+		else
+			addRect({x, y, x, y});
+	}
+
+	revision_++;
+	if (changeLog_.size() >= MAX_CHANGE_LOG) {
+		changeLog_.clear();
+		changeLogStart_ = revision_ - 1;
+	}
+	changeLog_.push_back(glm::ivec2(x, y));
+}
+
+bool Tilemap::changesSince(uint64_t rev, std::vector<glm::ivec2>& changes) const {
+	changes.clear();
+	if (rev < changeLogStart_ || rev > revision_)
 		return false;
-	return tiles_[y][x].tileType.type == TileEnum::GOAL;
+	changes.assign(changeLog_.begin() + (rev - changeLogStart_), changeLog_.end());
+	return true;
 }
 
-void Tilemap::setTile(int x, int y, const TileType& tileType) {
+void Tilemap::updateEdgeMask(int x, int y) {
 	if (x < 0 || x >= width_ || y < 0 || y >= height_)
 		return;
-	tiles_[y][x].tileType = tileType;
+	uint8_t edges = 0;
+	if (isSolidTile(x, y)) {
+		// Map borders count as exposed, nothing lies beyond them
+		if (!isSolidTile(x - 1, y))
+			edges |= EDGE_LEFT;
+		if (!isSolidTile(x + 1, y))
+			edges |= EDGE_RIGHT;
+		if (!isSolidTile(x, y - 1))
+			edges |= EDGE_BOTTOM;
+		if (!isSolidTile(x, y + 1))
+			edges |= EDGE_TOP;
+	}
+	edgeMask_[static_cast<size_t>(y) * width_ + x] = edges;
+}
+
+int Tilemap::getSolidTileCount() const {
+	int count = 0;
+	const size_t words = static_cast<size_t>(maskWords_) * height_;
+	for (size_t i = 0; i < words; ++i) {
+		count += __builtin_popcountll(solidMask_[i]);
+	}
+	return count;
+}
+
+size_t Tilemap::getMemoryBytes() const {
+	// A mapped level counts in full, though only the pages touched so far are resident
+	size_t bytes = sizeof(Tilemap) + getStorageBytes();
+	bytes += collisionRects_.capacity() * sizeof(CollisionRect) + rowRects_.capacity() * sizeof(std::vector<RowSpan>);
+	for (const auto& row : rowRects_)
+		bytes += row.capacity() * sizeof(RowSpan);
+	return bytes;
+}
+
+int Tilemap::rectIndexAt(int x, int y) const {
+	if (x < 0 || x >= width_ || y < 0 || y >= height_)
+		return -1;
+	// Rects in a row never overlap, so only the last one starting at or before x can cover it
+	const std::vector<RowSpan>& row = rowRects_[y];
+	auto it = std::upper_bound(row.begin(), row.end(), x, [](int tx, const RowSpan& span) { return tx < span.x0; });
+	if (it == row.begin() || (it - 1)->x1 < x)
+		return -1;
+	return (it - 1)->rect;
+}
+
+void Tilemap::addRect(const CollisionRect& rect) {
+	collisionRects_.push_back(rect);
+	indexRect(static_cast<int>(collisionRects_.size()) - 1);
+}
+
+void Tilemap::indexRect(int index) {
+	const CollisionRect& rect = collisionRects_[index];
+	for (int y = rect.y0; y <= rect.y1; ++y) {
+		std::vector<RowSpan>& row = rowRects_[y];
+		row.insert(std::lower_bound(row.begin(), row.end(), rect.x0, spanBefore), {rect.x0, rect.x1, index});
+	}
+}
+
+void Tilemap::removeRect(int index) {
+	// Swaps the last rect into the hole, so its row entries are renumbered rather than moved
+	auto relist = [this](int from, int to) {
+		const CollisionRect& rect = collisionRects_[from];
+		for (int y = rect.y0; y <= rect.y1; ++y) {
+			std::vector<RowSpan>& row = rowRects_[y];
+			auto it = std::lower_bound(row.begin(), row.end(), rect.x0, spanBefore);
+			if (to < 0)
+				row.erase(it);
+			else
+				it->rect = to;
+		}
+	};
+	relist(index, -1);
+	int last = static_cast<int>(collisionRects_.size()) - 1;
+	if (index != last) {
+		relist(last, index);
+		collisionRects_[index] = collisionRects_[last];
+	}
+	collisionRects_.pop_back();
+}
+
+void Tilemap::extendRect(int index, int x1) {
+	// Only single-row rects grow, so there's one span to update
+	CollisionRect& rect = collisionRects_[index];
+	rect.x1 = x1;
+	std::vector<RowSpan>& row = rowRects_[rect.y0];
+	std::lower_bound(row.begin(), row.end(), rect.x0, spanBefore)->x1 = x1;
+}
+
+void Tilemap::indexRects() {
+	rowRects_.assign(height_, std::vector<RowSpan>());
+	for (size_t i = 0; i < collisionRects_.size(); ++i) {
+		const CollisionRect& rect = collisionRects_[i];
+		for (int y = rect.y0; y <= rect.y1; ++y)
+			rowRects_[y].push_back({rect.x0, rect.x1, static_cast<int>(i)});
+	}
+	for (auto& row : rowRects_) {
+		std::sort(row.begin(), row.end(), [](const RowSpan& a, const RowSpan& b) { return a.x0 < b.x0; });
+	}
+}
+
+void Tilemap::mergeCollisionRects() {
+	collisionRects_.clear();
+	mergeSolidTiles(0, 0, width_ - 1, height_ - 1);
+	indexRects();
+}
+
+void Tilemap::mergeSolidTiles(int x0, int y0, int x1, int y1) {
+	// Greedy merge: take the lowest-left unclaimed solid tile, extend it right as far
+	// as the row stays solid, then extend that span upwards while every tile in the
+	// next row is solid. Claimed tiles are cleared from a scratch copy of the box's mask.
+	// New rects are only appended; the caller indexes them.
+	const int w = x1 - x0 + 1, h = y1 - y0 + 1;
+	const int words = (w + 63) / 64;
+	const int shift = x0 & 63;
+	std::vector<uint64_t> remaining(static_cast<size_t>(words) * h);
+	for (int y = 0; y < h; ++y) {
+		const uint64_t* row = getSolidRow(y0 + y) + (x0 >> 6);
+		uint64_t* out = &remaining[static_cast<size_t>(y) * words];
+		for (int k = 0; k < words; ++k) {
+			uint64_t bits = row[k] >> shift;
+			if (shift && (x0 >> 6) + k + 1 < maskWords_)
+				bits |= row[k + 1] << (64 - shift);
+			out[k] = bits;
+		}
+		if (w & 63)
+			out[words - 1] &= ~uint64_t(0) >> (64 - (w & 63));
+	}
+	auto bitAt = [&](int x, int y) { return (remaining[static_cast<size_t>(y) * words + (x >> 6)] >> (x & 63)) & 1u; };
+
+	for (int y = 0; y < h; ++y) {
+		for (int k = 0; k < words; ++k) {
+			uint64_t& word = remaining[static_cast<size_t>(y) * words + k];
+			while (word) {
+				int rx0 = k * 64 + __builtin_ctzll(word);
+				int rx1 = rx0;
+				while (rx1 + 1 < w && bitAt(rx1 + 1, y))
+					++rx1;
+
+				int ry1 = y;
+				while (ry1 + 1 < h) {
+					bool fullRow = true;
+					for (int x = rx0; x <= rx1 && fullRow; ++x)
+						fullRow = bitAt(x, ry1 + 1);
+					if (!fullRow)
+						break;
+					++ry1;
+				}
+
+				for (int ry = y; ry <= ry1; ++ry) {
+					for (int x = rx0; x <= rx1; ++x) {
+						remaining[static_cast<size_t>(ry) * words + (x >> 6)] &= ~(uint64_t(1) << (x & 63));
+					}
+				}
+				collisionRects_.push_back({x0 + rx0, y0 + y, x0 + rx1, y0 + ry1});
+			}
+		}
+	}
+}
+
+void Tilemap::writeMask(uint64_t* mask, size_t word, int bit, bool value) {
+	uint64_t m = uint64_t(1) << bit;
+	mask[word] = value ? (mask[word] | m) : (mask[word] & ~m);
+}
+
+bool Tilemap::anyInRect(const uint64_t* mask, int x0, int y0, int x1, int y1) const {
+	x0 = std::max(x0, 0);
+	y0 = std::max(y0, 0);
+	x1 = std::min(x1, width_ - 1);
+	y1 = std::min(y1, height_ - 1);
+	if (x0 > x1 || y0 > y1)
+		return false;
+
+	int w0 = x0 >> 6, w1 = x1 >> 6;
+	// Partial masks for the first and last word of each row span
+	uint64_t firstMask = ~uint64_t(0) << (x0 & 63);
+	uint64_t lastMask = ~uint64_t(0) >> (63 - (x1 & 63));
+
+	for (int y = y0; y <= y1; ++y) {
+		const uint64_t* row = &mask[static_cast<size_t>(y) * maskWords_];
+		if (w0 == w1) {
+			if (row[w0] & firstMask & lastMask)
+				return true;
+			continue;
+		}
+		if (row[w0] & firstMask)
+			return true;
+		for (int w = w0 + 1; w < w1; ++w) {
+			if (row[w])
+				return true;
+		}
+		if (row[w1] & lastMask)
+			return true;
+	}
+	return false;
 }
 
 void Tilemap::renderTileMap(Shader& shader, Renderer2D& renderer) const {
-	for (int y = 0; y < height_; ++y) {
-		for (int x = 0; x < width_; ++x) {
-			const Tile& tile = tiles_[y][x];
+	renderTileMap(shader, renderer, 0, 0, width_ - 1, height_ - 1);
+}
+
+void Tilemap::renderTileMap(Shader& shader, Renderer2D& renderer, int x0, int y0, int x1, int y1) const {
+	x0 = std::max(x0, 0);
+	y0 = std::max(y0, 0);
+	x1 = std::min(x1, width_ - 1);
+	y1 = std::min(y1, height_ - 1);
+	// Plain colored tiles all go into one batched draw; textured ones are still drawn one by one
+	const glm::vec2 size(tileSize_);
+	for (int y = y0; y <= y1; ++y) {
+		for (int x = x0; x <= x1; ++x) {
+			const Tile tile = getTile(x, y);
 			if (tile.tileType.visible) {
-				glm::vec2 tileCenter = tile.position + glm::vec2(tileSize_ / 2.0f, tileSize_ / 2.0f);
-				glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(tileCenter, 0.0f));
-				model = glm::scale(model, glm::vec3(tileSize_, tileSize_, 1.0f));
-				if(tile.texture == nullptr) renderer.drawQuad(shader, model, tile.tileType.color);
+				Transform2D model = Transform2D::fromTS(tile.position + size / 2.0f, size);
+				if(tile.texture == nullptr) renderer.addQuadtoBatch(shader, model, tile.tileType.color);
 				else renderer.drawTexturedQuad(shader, model, tile.tileType.color, tile.texture);
 			}
 		}
 	}
+	renderer.flushBatch(shader);
 }
 
 glm::ivec2 Tilemap::worldToTileIndex(const glm::vec2& pos) const {
@@ -57,7 +366,21 @@ glm::ivec2 Tilemap::worldToTileIndex(const glm::vec2& pos) const {
 
 glm::vec2 Tilemap::tileIndexToWorldPos(int x, int y) const { return glm::vec2(x * tileSize_, y * tileSize_); }
 
-Tilemap loadTilemapFromFile(const std::string& filename, float tileSize, Texture* floorTex, Texture* wallTex) {
+TileHit Tilemap::raycast(const glm::vec2& origin, const glm::vec2& dir, float maxDist) const {
+	return raycastTiles(*this, origin, dir, maxDist);
+}
+
+TileHit Tilemap::boxcast(const AABB& box, const glm::vec2& delta) const { return boxcastTiles(*this, box, delta); }
+
+void Tilemap::raycastBatch(const std::vector<TileRay>& rays, std::vector<TileHit>& hits) const {
+	hits.resize(rays.size());
+	for (size_t i = 0; i < rays.size(); ++i) {
+		hits[i] = raycast(rays[i].origin, rays[i].dir, rays[i].maxDist);
+	}
+}
+
+Tilemap loadTilemapFromFile(const std::string& filename, float tileSize, Texture* floorTex, Texture* wallTex,
+							LoadProgress* progress) {
 	std::ifstream file(filename);
 	if (!file.is_open()) {
 		std::cerr << "Failed to open tilemap file: " << filename << std::endl;
@@ -71,12 +394,20 @@ Tilemap loadTilemapFromFile(const std::string& filename, float tileSize, Texture
 	std::getline(file, line); // Consume the newline after height
 
 	Tilemap tilemap(width, height, tileSize);
+	tilemap.setTextures(floorTex, wallTex);
 	bool startSet = false, dwallStartSet = false, dwallEndSet = false;
+	std::vector<char> platformMarks(static_cast<size_t>(width) * height, '.'); // '=' and '~' tiles, read after the loop
 	for (int y = height - 1; y >= 0; --y) {
+		if (progress) {
+			if (progress->cancelled.load(std::memory_order_relaxed))
+				throw std::runtime_error("Tilemap load cancelled");
+			progress->fraction.store(static_cast<float>(height - 1 - y) / height, std::memory_order_relaxed);
+		}
 		std::getline(file, line);
 		for (int x = 0; x < width && x < static_cast<int>(line.size()); ++x) {
 			char c = line[x];
 			TileType type;
+			TileSkin skin = TileSkin::NONE;
 
 			switch (c) {
 			case '#': // Solid tile
@@ -84,10 +415,10 @@ Tilemap loadTilemapFromFile(const std::string& filename, float tileSize, Texture
 				// If there is a solid tile above, use wall texture
 				if(y < height - 1 && tilemap.isSolidTile(x, y + 1)) {
 					// Wall texture
-					tilemap.getTile(x, y).texture = wallTex;
+					skin = TileSkin::WALL;
 				} else {
 					// Grass texture
-					tilemap.getTile(x, y).texture = floorTex;
+					skin = TileSkin::FLOOR;
 				}
 
 				break;
@@ -125,19 +456,62 @@ Tilemap loadTilemapFromFile(const std::string& filename, float tileSize, Texture
 					std::cerr << "Multiple death wall end positions found in tilemap file." << std::endl;
 				}
 				break;
+			case '^': // Hazard tile - kills the player on contact
+				type = {TileEnum::HAZARD, true, false, glm::vec4(0.8f, 0.1f, 0.1f, 1.0f)};
+				break;
 			case 'G': // Goal tile
 				type = {TileEnum::GOAL, true, false, rgbaToVec4("0, 74, 20, 255")};
 				tilemap.setGoalPos(x, y); // Set goal position
 				break;
+			case 'C': // Checkpoint - respawn here after dying
+				type = {TileEnum::CHECKPOINT, true, false, glm::vec4(0.2f, 0.45f, 0.8f, 1.0f)};
+				break;
+			case 'X': // Kill zone - invisible, kills the player on entry (bottomless pits etc.)
+				type = {TileEnum::KILLZONE, false, false, glm::vec4(0.4f, 0.4f, 0.4f, 1.0f)};
+				break;
+			case '=': // Moving platform
+			case '~': // Moving platform path
+				type = {TileEnum::EMPTY, false, false, glm::vec4(0.4f, 0.4f, 0.4f, 1.0f)};
+				platformMarks[static_cast<size_t>(y) * width + x] = c;
+				break;
 			}
 
-			tilemap.setTile(x, y, type);
+			tilemap.setTile(x, y, type, skin);
 		}
 	}
+
+	// Each horizontal run of '=' is one platform. It travels right over the '~' tiles
+	// that follow the run, or failing that up over the '~' tiles above its first tile.
+	auto mark = [&](int x, int y) {
+		return (x < width && y < height) ? platformMarks[static_cast<size_t>(y) * width + x] : '.';
+	};
+	for (int y = 0; y < height; ++y) {
+		for (int x = 0; x < width; ++x) {
+			if (mark(x, y) != '=' || (x > 0 && mark(x - 1, y) == '='))
+				continue;
+			PlatformSpawn spawn = {glm::ivec2(x, y), 0, glm::ivec2(0)};
+			while (mark(x + spawn.width, y) == '=')
+				spawn.width++;
+			while (mark(x + spawn.width + spawn.travel.x, y) == '~')
+				spawn.travel.x++;
+			if (spawn.travel.x == 0) {
+				while (mark(x, y + 1 + spawn.travel.y) == '~')
+					spawn.travel.y++;
+			}
+			tilemap.addPlatformSpawn(spawn);
+		}
+	}
+
 	if (!startSet || !dwallStartSet || !dwallEndSet) {
 		std::cerr << "Tilemap is missing required positions." << std::endl;
 		throw std::runtime_error("Tilemap is missing required positions.");
 	}
 
+	tilemap.mergeCollisionRects();
+	DEBUG_ONLY(std::cout << "[Tilemap] Collision: " << tilemap.getSolidTileCount() << " solid tiles -> "
+					  << tilemap.getCollisionRects().size() << " rects" << std::endl;);
+	if (progress)
+		progress->fraction.store(1.0f, std::memory_order_relaxed);
+
 	return tilemap;
 }
@@ -0,0 +1,123 @@
+#include <algorithm>
+#include "tilemesh.hpp"
+
+static_assert(TileMesh::CHUNK_TILES * TileMesh::CHUNK_TILES <= static_cast<int>(Renderer2D::MAX_STATIC_QUADS),
+			  "A full chunk has to fit one static buffer");
+
+void TileMesh::build(const Tilemap& tilemap, const std::vector<LevelChunkInfo>* chunkTable, const std::atomic<bool>* cancel) {
+	// GPU buffers of a previous build belong to the GL thread, which releases them first
+	chunksX_ = (tilemap.getWidth() + CHUNK_TILES - 1) / CHUNK_TILES;
+	chunksY_ = (tilemap.getHeight() + CHUNK_TILES - 1) / CHUNK_TILES;
+	chunks_.clear();
+	chunks_.resize(static_cast<size_t>(chunksX_) * chunksY_);
+	if (chunkTable && chunkTable->size() != chunks_.size())
+		chunkTable = nullptr; // From some other map
+	uploaded_ = 0;
+	tilemapId_ = 0; // Until the last chunk is built
+	for (int cy = 0; cy < chunksY_; ++cy) {
+		for (int cx = 0; cx < chunksX_; ++cx) {
+			if (cancel && cancel->load(std::memory_order_relaxed))
+				return;
+			const size_t index = static_cast<size_t>(cy) * chunksX_ + cx;
+			Chunk& chunk = chunks_[index];
+			chunk.x0 = cx * CHUNK_TILES;
+			chunk.y0 = cy * CHUNK_TILES;
+			if (chunkTable && (*chunkTable)[index].visibleTiles == 0)
+				continue;
+			buildChunk(tilemap, chunk);
+		}
+	}
+	tilemapId_ = tilemap.getId();
+	revision_ = tilemap.getRevision();
+}
+
+void TileMesh::buildChunk(const Tilemap& tilemap, Chunk& chunk) const {
+	const int x1 = std::min(chunk.x0 + CHUNK_TILES, tilemap.getWidth());
+	const int y1 = std::min(chunk.y0 + CHUNK_TILES, tilemap.getHeight());
+	const glm::vec2 size(tilemap.getTileSize());
+	static const glm::vec2 uvs[4] = {{0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 1.0f}};
+
+	// Group visible tiles by texture so each run is one draw call. A chunk only ever
+	// sees a handful of textures, so a linear search beats a map here.
+	std::vector<Texture*> textures;
+	std::vector<std::vector<StaticVertex>> groups;
+	for (int y = chunk.y0; y < y1; ++y) {
+		for (int x = chunk.x0; x < x1; ++x) {
+			const Tile& tile = tilemap.getTile(x, y);
+			if (!tile.tileType.visible)
+				continue;
+			size_t group = std::find(textures.begin(), textures.end(), tile.texture) - textures.begin();
+			if (group == textures.size()) {
+				textures.push_back(tile.texture);
+				groups.emplace_back();
+			}
+			glm::vec2 corners[4];
+			Transform2D::fromTS(tile.position + size / 2.0f, size).quadCorners(corners);
+			for (int i = 0; i < 4; ++i)
+				groups[group].push_back({corners[i], uvs[i], tile.tileType.color});
+		}
+	}
+
+	chunk.vertices.clear();
+	chunk.runs.clear();
+	for (size_t i = 0; i < groups.size(); ++i) {
+		uint32_t first = static_cast<uint32_t>(chunk.vertices.size() / 4);
+		chunk.runs.push_back({textures[i], first, static_cast<uint32_t>(groups[i].size() / 4)});
+		chunk.vertices.insert(chunk.vertices.end(), groups[i].begin(), groups[i].end());
+	}
+}
+
+int TileMesh::upload(Renderer2D& renderer, int maxChunks) {
+	const int total = static_cast<int>(chunks_.size());
+	for (int done = 0; uploaded_ < total && done < maxChunks; ++uploaded_) {
+		Chunk& chunk = chunks_[uploaded_];
+		if (chunk.vertices.empty())
+			continue; // Nothing to draw; doesn't count against the budget
+		renderer.uploadStaticQuads(chunk.gpu, chunk.vertices.data(), static_cast<uint32_t>(chunk.vertices.size() / 4));
+		++done;
+	}
+	return total - uploaded_;
+}
+
+void TileMesh::release(Renderer2D& renderer) {
+	for (Chunk& chunk : chunks_)
+		renderer.releaseStaticQuads(chunk.gpu);
+	uploaded_ = 0;
+}
+
+size_t TileMesh::getQuadCount() const {
+	size_t quads = 0;
+	for (const Chunk& chunk : chunks_)
+		quads += chunk.vertices.size() / 4;
+	return quads;
+}
+
+size_t TileMesh::getMemoryBytes() const {
+	size_t bytes = chunks_.size() * sizeof(Chunk);
+	for (const Chunk& chunk : chunks_)
+		bytes += chunk.vertices.capacity() * sizeof(StaticVertex) + chunk.runs.capacity() * sizeof(Run);
+	return bytes;
+}
+
+void TileMesh::draw(Shader& shader, Renderer2D& renderer, const Tilemap& tilemap, int x0, int y0, int x1, int y1) const {
+	if (chunksX_ == 0 || x1 < std::max(x0, 0) || y1 < std::max(y0, 0))
+		return;
+	const int cx0 = std::max(x0, 0) / CHUNK_TILES;
+	const int cy0 = std::max(y0, 0) / CHUNK_TILES;
+	const int cx1 = std::min(x1 / CHUNK_TILES, chunksX_ - 1);
+	const int cy1 = std::min(y1 / CHUNK_TILES, chunksY_ - 1);
+	for (int cy = cy0; cy <= cy1; ++cy) {
+		for (int cx = cx0; cx <= cx1; ++cx) {
+			const int index = cy * chunksX_ + cx;
+			const Chunk& chunk = chunks_[index];
+			if (index >= uploaded_) {
+				// Still waiting for its buffer
+				tilemap.renderTileMap(shader, renderer, std::max(x0, chunk.x0), std::max(y0, chunk.y0),
+									  std::min(x1, chunk.x0 + CHUNK_TILES - 1), std::min(y1, chunk.y0 + CHUNK_TILES - 1));
+				continue;
+			}
+			for (const Run& run : chunk.runs)
+				renderer.drawStaticQuads(shader, chunk.gpu, run.first, run.count, run.texture);
+		}
+	}
+}
@@ -0,0 +1,393 @@
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include "tileworld.hpp"
+#include "framesnapshot.hpp"
+#include "tiletraversal.hpp"
+
+namespace fs = std::filesystem;
+
+static const char TILE_WORLD_MAGIC[4] = {'T', 'W', 'L', 'D'};
+
+bool readTileWorldHeader(std::istream& in, TileWorldHeader& header) {
+	in.read(reinterpret_cast<char*>(&header), sizeof(header));
+	return in && std::memcmp(header.magic, TILE_WORLD_MAGIC, sizeof(header.magic)) == 0 && header.version == TILE_WORLD_VERSION &&
+		   header.width > 0 && header.height > 0 && header.chunksX > 0 && header.chunksY > 0;
+}
+
+bool writeTileWorld(const std::string& path, int width, int height, const std::vector<TilePaletteEntry>& palette,
+					const std::vector<LevelMarker>& markers, const ChunkFiller& fill) {
+	const int N = WORLD_CHUNK_TILES;
+	if (width <= 0 || height <= 0 || palette.empty() || palette.size() > static_cast<size_t>(Tilemap::MAX_PALETTE)) {
+		std::cerr << "[TileWorld] Nothing sensible to write to " << path << std::endl;
+		return false;
+	}
+
+	TileWorldHeader header = {};
+	std::memcpy(header.magic, TILE_WORLD_MAGIC, sizeof(header.magic));
+	header.version = TILE_WORLD_VERSION;
+	header.width = width;
+	header.height = height;
+	header.chunksX = (width + N - 1) / N;
+	header.chunksY = (height + N - 1) / N;
+	header.chunkTiles = N;
+	header.paletteCount = static_cast<uint32_t>(palette.size());
+	header.markerCount = static_cast<uint32_t>(markers.size());
+	header.paletteOffset = sizeof(header);
+	header.markerOffset = header.paletteOffset + palette.size() * sizeof(CompiledPaletteEntry);
+	header.indexOffset = header.markerOffset + markers.size() * sizeof(LevelMarker);
+	std::vector<TileWorldChunkEntry> index(static_cast<size_t>(header.chunksX) * header.chunksY, TileWorldChunkEntry{});
+
+	fs::path target(path);
+	std::error_code ec;
+	if (target.has_parent_path())
+		fs::create_directories(target.parent_path(), ec);
+	fs::path temp = target;
+	temp += ".tmp";
+	std::ofstream file(temp.string(), std::ios::binary | std::ios::trunc);
+	if (!file.is_open()) {
+		std::cerr << "[TileWorld] Failed to write " << temp << std::endl;
+		return false;
+	}
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	for (const TilePaletteEntry& entry : palette) {
+		CompiledPaletteEntry compiled = compilePaletteEntry(entry);
+		file.write(reinterpret_cast<const char*>(&compiled), sizeof(compiled));
+	}
+	file.write(reinterpret_cast<const char*>(markers.data()), markers.size() * sizeof(LevelMarker));
+	// The index is only known once every chunk is written; reserve its space for now
+	file.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(TileWorldChunkEntry));
+
+	uint64_t offset = header.indexOffset + index.size() * sizeof(TileWorldChunkEntry);
+	std::vector<uint8_t> tiles(N * N);
+	std::vector<uint8_t> runs;
+	for (int cy = 0; cy < header.chunksY; ++cy) {
+		for (int cx = 0; cx < header.chunksX; ++cx) {
+			std::fill(tiles.begin(), tiles.end(), 0);
+			fill(cx * N, cy * N, tiles.data());
+			const int w = std::min(N, width - cx * N), h = std::min(N, height - cy * N);
+
+			// Uniform over the part inside the map: the index entry says it all
+			bool uniform = true;
+			for (int y = 0; y < h && uniform; ++y)
+				for (int x = 0; x < w && uniform; ++x)
+					uniform = tiles[y * N + x] == tiles[0];
+			TileWorldChunkEntry& entry = index[static_cast<size_t>(cy) * header.chunksX + cx];
+			entry.fill = tiles[0];
+			if (uniform)
+				continue;
+
+			// (length - 1, palette index) pairs over the whole chunk, rows bottom to top
+			runs.clear();
+			for (int i = 0; i < N * N;) {
+				int length = 1;
+				while (i + length < N * N && length < 256 && tiles[i + length] == tiles[i])
+					++length;
+				runs.push_back(static_cast<uint8_t>(length - 1));
+				runs.push_back(tiles[i]);
+				i += length;
+			}
+			entry.offset = offset;
+			entry.bytes = static_cast<uint32_t>(runs.size());
+			file.write(reinterpret_cast<const char*>(runs.data()), runs.size());
+			offset += runs.size();
+		}
+	}
+	file.seekp(static_cast<std::streamoff>(header.indexOffset));
+	file.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(TileWorldChunkEntry));
+	file.close();
+	if (!file) {
+		std::cerr << "[TileWorld] Failed to write " << temp << std::endl;
+		return false;
+	}
+	fs::rename(temp, target, ec);
+	if (ec) {
+		std::cerr << "[TileWorld] Failed to replace " << target << ": " << ec.message() << std::endl;
+		return false;
+	}
+	return true;
+}
+
+bool writeTileWorld(const Tilemap& tilemap, const std::string& path) {
+	const int width = tilemap.getWidth(), height = tilemap.getHeight();
+	return writeTileWorld(path, width, height, tilemap.getPalette(), collectLevelMarkers(tilemap),
+						  [&](int x0, int y0, uint8_t* tiles) {
+							  for (int y = y0; y < std::min(y0 + WORLD_CHUNK_TILES, height); ++y) {
+								  const uint8_t* row = tilemap.getTileRow(y) + x0;
+								  std::copy(row, row + std::min(WORLD_CHUNK_TILES, width - x0),
+											tiles + (y - y0) * WORLD_CHUNK_TILES);
+							  }
+						  });
+}
+
+bool TileWorld::open(const std::string& path, float tileSize) {
+	close();
+	if (!file_.open(path)) {
+		std::cerr << "[TileWorld] Failed to open " << path << std::endl;
+		return false;
+	}
+	const uint8_t* data = file_.getData();
+	const uint64_t size = file_.getSize();
+	auto fits = [size](uint64_t offset, uint64_t count, uint64_t elementSize) {
+		return offset <= size && count <= (size - offset) / elementSize;
+	};
+	if (size < sizeof(header_)) {
+		close();
+		return false;
+	}
+	std::memcpy(&header_, data, sizeof(header_));
+	const int64_t chunksX = (static_cast<int64_t>(header_.width) + N - 1) / N;
+	const int64_t chunksY = (static_cast<int64_t>(header_.height) + N - 1) / N;
+	if (std::memcmp(header_.magic, TILE_WORLD_MAGIC, sizeof(header_.magic)) != 0 || header_.version != TILE_WORLD_VERSION ||
+		header_.width <= 0 || header_.height <= 0 || header_.chunkTiles != static_cast<uint32_t>(N) ||
+		header_.chunksX != chunksX || header_.chunksY != chunksY || header_.paletteCount == 0 ||
+		header_.paletteCount > static_cast<uint32_t>(Tilemap::MAX_PALETTE) ||
+		!fits(header_.paletteOffset, header_.paletteCount, sizeof(CompiledPaletteEntry)) ||
+		!fits(header_.markerOffset, header_.markerCount, sizeof(LevelMarker)) ||
+		!fits(header_.indexOffset, static_cast<uint64_t>(chunksX * chunksY), sizeof(TileWorldChunkEntry))) {
+		std::cerr << "[TileWorld] Not a tile world this build can read: " << path << std::endl;
+		close();
+		return false;
+	}
+
+	width_ = header_.width;
+	height_ = header_.height;
+	tileSize_ = tileSize;
+	palette_.fill({{TileEnum::EMPTY, false, false, glm::vec4(0.0f)}, TileSkin::NONE});
+	for (uint32_t i = 0; i < header_.paletteCount; ++i) {
+		CompiledPaletteEntry entry;
+		std::memcpy(&entry, data + header_.paletteOffset + i * sizeof(entry), sizeof(entry));
+		palette_[i] = readPaletteEntry(entry);
+	}
+	markers_.resize(header_.markerCount);
+	std::memcpy(markers_.data(), data + header_.markerOffset, markers_.size() * sizeof(LevelMarker));
+	for (const LevelMarker& marker : markers_) {
+		if (marker.kind == LevelMarkerKind::PLATFORM)
+			platformSpawns_.push_back({glm::ivec2(marker.x, marker.y), marker.width, glm::ivec2(marker.travelX, marker.travelY)});
+	}
+	return true;
+}
+
+void TileWorld::close() {
+	resident_.clear();
+	for (auto& chunk : uniform_)
+		chunk.reset();
+	lastKey_ = UINT64_MAX;
+	lastChunk_ = nullptr;
+	markers_.clear();
+	platformSpawns_.clear();
+	file_.close();
+	width_ = height_ = 0;
+}
+
+void TileWorld::update(int x0, int y0, int x1, int y1) {
+	++useClock_;
+	lastKey_ = UINT64_MAX; // So chunks used this frame get stamped with the new clock
+	const int cx0 = std::max(x0 / N - STREAM_MARGIN_CHUNKS, 0);
+	const int cy0 = std::max(y0 / N - STREAM_MARGIN_CHUNKS, 0);
+	const int cx1 = std::min(x1 / N + STREAM_MARGIN_CHUNKS, header_.chunksX - 1);
+	const int cy1 = std::min(y1 / N + STREAM_MARGIN_CHUNKS, header_.chunksY - 1);
+	for (int cy = cy0; cy <= cy1; ++cy)
+		for (int cx = cx0; cx <= cx1; ++cx)
+			chunkAt(cx, cy);
+	if (getResidentBytes() > budget_)
+		evict();
+}
+
+void TileWorld::evict() {
+	// Oldest first, never anything used this frame. Down to 7/8 of the budget, so walking
+	// in one direction evicts a batch every few chunks rather than one every frame.
+	std::vector<std::pair<unsigned long, uint64_t>> candidates;
+	for (const auto& [key, slot] : resident_) {
+		if (slot.lastUse != useClock_)
+			candidates.emplace_back(slot.lastUse, key);
+	}
+	std::sort(candidates.begin(), candidates.end());
+	const size_t target = budget_ / 8 * 7;
+	for (const auto& candidate : candidates) {
+		if (getResidentBytes() <= target)
+			break;
+		resident_.erase(candidate.second);
+		++evictions_;
+	}
+	lastKey_ = UINT64_MAX;
+	lastChunk_ = nullptr;
+}
+
+const TileWorld::Chunk& TileWorld::chunkAt(int cx, int cy) const {
+	const uint64_t key = static_cast<uint64_t>(cy) * header_.chunksX + cx;
+	if (key == lastKey_)
+		return *lastChunk_;
+
+	const Chunk* chunk;
+	auto it = resident_.find(key);
+	if (it != resident_.end()) {
+		it->second.lastUse = useClock_;
+		chunk = it->second.chunk.get();
+	} else {
+		TileWorldChunkEntry entry;
+		std::memcpy(&entry, file_.getData() + header_.indexOffset + key * sizeof(entry), sizeof(entry));
+		if (entry.bytes == 0) {
+			chunk = &uniformChunk(entry.fill);
+		} else {
+			auto loaded = std::make_unique<Chunk>();
+			if (!decodeChunk(entry, *loaded)) {
+				std::cerr << "[TileWorld] Chunk " << cx << "," << cy << " is corrupt, reading it as empty" << std::endl;
+				std::memset(loaded->tiles, 0, sizeof(loaded->tiles));
+			}
+			fillMasks(*loaded);
+			// The encoded bytes won't be needed until this chunk is loaded again
+			file_.discard(entry.offset, entry.bytes);
+			chunk = loaded.get();
+			resident_.emplace(key, Slot{std::move(loaded), useClock_});
+			++loads_;
+		}
+	}
+	lastKey_ = key;
+	lastChunk_ = chunk;
+	return *chunk;
+}
+
+const TileWorld::Chunk& TileWorld::uniformChunk(uint8_t fill) const {
+	std::unique_ptr<Chunk>& chunk = uniform_[fill];
+	if (!chunk) {
+		chunk = std::make_unique<Chunk>();
+		std::memset(chunk->tiles, fill, sizeof(chunk->tiles));
+		fillMasks(*chunk);
+	}
+	return *chunk;
+}
+
+bool TileWorld::decodeChunk(const TileWorldChunkEntry& entry, Chunk& chunk) const {
+	if (entry.offset > file_.getSize() || entry.bytes > file_.getSize() - entry.offset || entry.bytes % 2 != 0)
+		return false;
+	const uint8_t* runs = file_.getData() + entry.offset;
+	int filled = 0;
+	for (uint32_t i = 0; i < entry.bytes; i += 2) {
+		int length = runs[i] + 1;
+		if (filled + length > N * N)
+			return false;
+		std::memset(chunk.tiles + filled, runs[i + 1], length);
+		filled += length;
+	}
+	return filled == N * N;
+}
+
+void TileWorld::fillMasks(Chunk& chunk) const {
+	for (int y = 0; y < N; ++y) {
+		uint64_t solid = 0, goal = 0, hazard = 0;
+		for (int x = 0; x < N; ++x) {
+			const TileType& type = palette_[chunk.tiles[y * N + x]].tileType;
+			solid |= uint64_t(isSolidType(type)) << x;
+			goal |= uint64_t(type.type == TileEnum::GOAL) << x;
+			hazard |= uint64_t(type.type == TileEnum::HAZARD) << x;
+		}
+		chunk.solid[y] = solid;
+		chunk.goal[y] = goal;
+		chunk.hazard[y] = hazard;
+	}
+}
+
+TileEnum TileWorld::getTileType(int x, int y) const {
+	return palette_[chunkAt(x / N, y / N).tiles[(y % N) * N + x % N]].tileType.type;
+}
+
+Tile TileWorld::getTile(int x, int y) const {
+	const TilePaletteEntry& entry = palette_[chunkAt(x / N, y / N).tiles[(y % N) * N + x % N]];
+	Texture* texture = entry.skin == TileSkin::FLOOR ? floorTex_ : (entry.skin == TileSkin::WALL ? wallTex_ : nullptr);
+	return {tileIndexToWorldPos(x, y), entry.tileType, texture};
+}
+
+uint8_t TileWorld::getEdgeMask(int x, int y) const {
+	// Same rule as Tilemap::updateEdgeMask, map borders count as exposed
+	if (!isSolidTile(x, y))
+		return 0;
+	uint8_t edges = 0;
+	if (!isSolidTile(x - 1, y))
+		edges |= EDGE_LEFT;
+	if (!isSolidTile(x + 1, y))
+		edges |= EDGE_RIGHT;
+	if (!isSolidTile(x, y - 1))
+		edges |= EDGE_BOTTOM;
+	if (!isSolidTile(x, y + 1))
+		edges |= EDGE_TOP;
+	return edges;
+}
+
+bool TileWorld::anyInRect(Mask mask, int x0, int y0, int x1, int y1) const {
+	x0 = std::max(x0, 0);
+	y0 = std::max(y0, 0);
+	x1 = std::min(x1, width_ - 1);
+	y1 = std::min(y1, height_ - 1);
+	if (x0 > x1 || y0 > y1)
+		return false;
+	// Chunk by chunk; within one, each row of the rect is a single masked word
+	for (int cy = y0 / N; cy <= y1 / N; ++cy) {
+		const int ry0 = std::max(y0 - cy * N, 0), ry1 = std::min(y1 - cy * N, N - 1);
+		for (int cx = x0 / N; cx <= x1 / N; ++cx) {
+			const int rx0 = std::max(x0 - cx * N, 0), rx1 = std::min(x1 - cx * N, N - 1);
+			const uint64_t span = (~uint64_t(0) << rx0) & (~uint64_t(0) >> (N - 1 - rx1));
+			const uint64_t* rows = chunkAt(cx, cy).*mask;
+			for (int y = ry0; y <= ry1; ++y) {
+				if (rows[y] & span)
+					return true;
+			}
+		}
+	}
+	return false;
+}
+
+TileHit TileWorld::raycast(const glm::vec2& origin, const glm::vec2& dir, float maxDist) const {
+	return raycastTiles(*this, origin, dir, maxDist);
+}
+
+TileHit TileWorld::boxcast(const AABB& box, const glm::vec2& delta) const { return boxcastTiles(*this, box, delta); }
+
+void TileWorld::collectTiles(int x0, int y0, int x1, int y1, std::vector<SpriteInstance>& out) const {
+	x0 = std::max(x0, 0);
+	y0 = std::max(y0, 0);
+	x1 = std::min(x1, width_ - 1);
+	y1 = std::min(y1, height_ - 1);
+	const glm::vec2 size(tileSize_);
+	for (int y = y0; y <= y1; ++y) {
+		for (int x = x0; x <= x1; ++x) {
+			const Tile tile = getTile(x, y);
+			if (tile.tileType.visible)
+				out.push_back({Transform2D::fromTS(tile.position + size / 2.0f, size), tile.tileType.color, tile.texture});
+		}
+	}
+}
+
+void TileWorld::scanChunks(const ChunkVisitor& visit, const std::function<bool(uint8_t fill)>& skipFill) const {
+	auto scratch = std::make_unique<Chunk>();
+	for (int cy = 0; cy < header_.chunksY; ++cy) {
+		for (int cx = 0; cx < header_.chunksX; ++cx) {
+			const uint64_t key = static_cast<uint64_t>(cy) * header_.chunksX + cx;
+			TileWorldChunkEntry entry;
+			std::memcpy(&entry, file_.getData() + header_.indexOffset + key * sizeof(entry), sizeof(entry));
+			if (entry.bytes == 0) {
+				if (!skipFill || !skipFill(entry.fill))
+					visit(cx * N, cy * N, uniformChunk(entry.fill).tiles);
+				continue;
+			}
+			if (!decodeChunk(entry, *scratch)) {
+				std::cerr << "[TileWorld] Chunk " << cx << "," << cy << " is corrupt, reading it as empty" << std::endl;
+				std::memset(scratch->tiles, 0, sizeof(scratch->tiles));
+			}
+			file_.discard(entry.offset, entry.bytes);
+			visit(cx * N, cy * N, scratch->tiles);
+		}
+	}
+}
+
+glm::ivec2 TileWorld::worldToTileIndex(const glm::vec2& pos) const {
+	return glm::ivec2(static_cast<int>(std::floor(pos.x / tileSize_)), static_cast<int>(std::floor(pos.y / tileSize_)));
+}
+
+glm::ivec2 TileWorld::markerPos(LevelMarkerKind kind) const {
+	for (const LevelMarker& marker : markers_) {
+		if (marker.kind == kind)
+			return glm::ivec2(marker.x, marker.y);
+	}
+	return glm::ivec2(0);
+}
@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <cmath>
+#include "triggers.hpp"
+#include "tileworld.hpp"
+
+namespace {
+
+const std::pair<TileEnum, TriggerType> TILE_TRIGGERS[] = {
+	{TileEnum::GOAL, TriggerType::GOAL}, {TileEnum::CHECKPOINT, TriggerType::CHECKPOINT}, {TileEnum::KILLZONE, TriggerType::KILL}};
+
+bool isTriggerTile(TileEnum type) {
+	return type == TileEnum::GOAL || type == TileEnum::CHECKPOINT || type == TileEnum::KILLZONE;
+}
+
+} // namespace
+
+void TriggerSystem::load(const Tilemap& tilemap) {
+	clear();
+	addTileTriggers(0, 0, tilemap.getWidth(), tilemap.getHeight(), tilemap.getTileSize(),
+					[&](int x, int y) { return tilemap.getTileType(x, y); });
+}
+
+void TriggerSystem::load(const TileWorld& world) {
+	clear();
+	const int N = WORLD_CHUNK_TILES;
+	auto typeOf = [&](uint8_t index) { return world.getPaletteEntry(index).tileType.type; };
+	world.scanChunks(
+		[&](int x0, int y0, const uint8_t* tiles) {
+			if (std::none_of(tiles, tiles + N * N, [&](uint8_t index) { return isTriggerTile(typeOf(index)); }))
+				return;
+			addTileTriggers(x0, y0, std::min(N, world.getWidth() - x0), std::min(N, world.getHeight() - y0), world.getTileSize(),
+							[&](int x, int y) { return typeOf(tiles[y * N + x]); });
+		},
+		[&](uint8_t fill) { return !isTriggerTile(typeOf(fill)); });
+}
+
+template <typename TypeAt>
+void TriggerSystem::addTileTriggers(int x0, int y0, int width, int height, float tileSize, TypeAt typeAt) {
+	const float T = tileSize;
+
+	// Greedy rects: extend each unclaimed run of same-type tiles upwards while the row
+	// above has the same run, the way the level files draw goals as solid blocks
+	std::vector<char> claimed(static_cast<size_t>(width) * height, 0);
+	auto triggerTile = [&](int x, int y, TileEnum type) {
+		return typeAt(x, y) == type && !claimed[static_cast<size_t>(y) * width + x];
+	};
+	for (const auto& kind : TILE_TRIGGERS) {
+		for (int y = 0; y < height; ++y) {
+			for (int x = 0; x < width; ++x) {
+				if (!triggerTile(x, y, kind.first))
+					continue;
+				int x1 = x;
+				while (x1 + 1 < width && triggerTile(x1 + 1, y, kind.first))
+					x1++;
+				int y1 = y;
+				while (y1 + 1 < height) {
+					bool fullRow = true;
+					for (int i = x; i <= x1 && fullRow; ++i)
+						fullRow = triggerTile(i, y1 + 1, kind.first);
+					if (!fullRow)
+						break;
+					y1++;
+				}
+				for (int j = y; j <= y1; ++j)
+					std::fill(claimed.begin() + static_cast<size_t>(j) * width + x, claimed.begin() + static_cast<size_t>(j) * width + x1 + 1, 1);
+
+				const float left = (x0 + x) * T, right = (x0 + x1 + 1) * T, bottom = (y0 + y) * T;
+				int index = add(kind.second, {left, right, (y0 + y1 + 1) * T, bottom});
+				// Checkpoints respawn the player standing in the middle of their bottom row
+				triggers_[index].spawn = glm::vec2((2 * x0 + x + x1 + 1) * T / 2.0f, bottom + T / 2.0f);
+			}
+		}
+	}
+}
+
+int TriggerSystem::add(TriggerType type, const AABB& box, const std::string& tag) {
+	int index = static_cast<int>(triggers_.size());
+	triggers_.push_back({type, box, glm::vec2((box.left + box.right) / 2.0f, box.bottom), tag});
+	stamp_.push_back(0);
+	glm::ivec4 cells = grid_.cellRange(box);
+	grid_.insert(cells, index);
+	grid_.forEachBucket(cells, [&](size_t bucket, const std::vector<int>&) { bucketBoxes_[bucket].push(box); });
+	return index;
+}
+
+void TriggerSystem::clear() {
+	triggers_.clear();
+	grid_.clear();
+	for (auto& boxes : bucketBoxes_)
+		boxes.clear();
+	stamp_.clear();
+	query_ = 0;
+	checkpoint_ = -1;
+	clearContacts();
+}
+
+void TriggerSystem::clearContacts() {
+	inside_.clear();
+	events_.clear();
+}
+
+void TriggerSystem::update(const AABB& box) {
+	wasInside_.swap(inside_);
+	inside_.clear();
+	events_.clear();
+	tested_ = 0;
+
+	if (++query_ == 0) {
+		// Stamp wrapped around: old stamps could now match, so start them over
+		std::fill(stamp_.begin(), stamp_.end(), 0);
+		query_ = 1;
+	}
+	grid_.forEachBucket(grid_.cellRange(box), [&](size_t bucket, const std::vector<int>& entries) {
+		hits_.clear();
+		overlapIndices(box, bucketBoxes_[bucket], hits_);
+		tested_ += static_cast<int>(entries.size());
+		for (int hit : hits_) {
+			int index = entries[hit];
+			if (stamp_[index] != query_) {
+				stamp_[index] = query_;
+				inside_.push_back(index);
+			}
+		}
+	});
+	std::sort(inside_.begin(), inside_.end());
+
+	// Walk both sorted sets together: only in the new one is an enter, only in the old
+	// one an exit, in both a stay
+	size_t i = 0, j = 0;
+	while (i < inside_.size() || j < wasInside_.size()) {
+		if (j == wasInside_.size() || (i < inside_.size() && inside_[i] < wasInside_[j])) {
+			events_.push_back({inside_[i], triggers_[inside_[i]].type, TriggerPhase::ENTER});
+			i++;
+		} else if (i == inside_.size() || wasInside_[j] < inside_[i]) {
+			events_.push_back({wasInside_[j], triggers_[wasInside_[j]].type, TriggerPhase::EXIT});
+			j++;
+		} else {
+			events_.push_back({inside_[i], triggers_[inside_[i]].type, TriggerPhase::STAY});
+			i++;
+			j++;
+		}
+	}
+}
+
+bool TriggerSystem::getCheckpointSpawn(glm::vec2& spawn) const {
+	if (checkpoint_ < 0)
+		return false;
+	spawn = triggers_[checkpoint_].spawn;
+	return true;
+}